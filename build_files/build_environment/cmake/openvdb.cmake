@@ -36,7 +36,8 @@ set(OPENVDB_EXTRA_ARGS
   -Dnanobind_DIR=${LIBDIR}/nanobind/nanobind/cmake/
   # Needed to still build with VS2019
   -DDISABLE_DEPENDENCY_VERSION_CHECKS=ON
-  # Not used by Blender (see e4f9c50), and removes the Boost dependency.
+  # Removes the Boost dependency. Without it the "Delay Load Volume Files" preference is
+  # hidden, it is only available when building against a system OpenVDB with delayed loading.
   -DOPENVDB_USE_DELAYED_LOADING=OFF
 
   # OPENVDB_AX Disabled for now as it adds ~25MB distribution wise
@@ -2,22 +2,33 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <algorithm>
 #include <cstdio>
+#include <sstream>
+
+#include <OpenImageIO/filesystem.h>
 
 #include "device/device.h"
+#include "scene/background.h"
 #include "scene/camera.h"
+#include "scene/film.h"
+#include "scene/image.h"
 #include "scene/integrator.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
 #include "session/buffers.h"
 #include "session/session.h"
 
 #include "util/args.h"
 #include "util/log.h"
+#include "util/map.h"
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/string.h"
+#include "util/time.h"
 #ifdef WITH_CYCLES_STANDALONE_GUI
-#  include "util/time.h"
 #  include "util/transform.h"
 #endif
 #include "util/unique_ptr.h"
@@ -48,6 +59,8 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string server_directory;
+  string update_trace_filepath;
 } options;
 
 static void session_print(const string &str)
@@ -101,6 +114,10 @@ static void scene_init()
 {
   options.scene = options.session->scene.get();
 
+  if (!options.update_trace_filepath.empty()) {
+    options.scene->enable_update_stats(options.update_trace_filepath);
+  }
+
   /* Read XML or USD */
 #ifdef WITH_USD
   if (!string_endswith(string_to_lower(options.filepath), ".xml")) {
@@ -176,6 +193,245 @@ static void session_exit()
   }
 }
 
+/* Server Mode
+ *
+ * Watches a directory for job files, and renders them one after another with the same session.
+ * The device, compiled kernels and images shared between jobs stay loaded.
+ *
+ * A job is a text file with the ".job" extension and one setting per line:
+ *
+ *   scene shot_010.xml
+ *   output /renders/shot_010/0001.exr
+ *   samples 256
+ *   width 1920
+ *   height 1080
+ *
+ * Relative paths are relative to the job file. When done, the job is renamed to ".done" or
+ * ".failed". A job containing a line with just "quit" stops the server.
+ *
+ * Submitters should write a job under another name and then rename it to ".job", so that it
+ * appears complete at once. As a safeguard for jobs written in place, a job file is only read
+ * once its size and modification time are unchanged since the previous look at the directory. */
+
+struct ServerJob {
+  string scene_filepath;
+  string output_filepath;
+  int samples = 0;
+  int width = 0;
+  int height = 0;
+  bool quit = false;
+};
+
+static bool server_job_read(const string &job_filepath, ServerJob &job)
+{
+  string text;
+  if (!path_read_text(job_filepath, text)) {
+    fprintf(stderr, "Failed to read job %s\n", job_filepath.c_str());
+    return false;
+  }
+
+  const string job_directory = path_dirname(job_filepath);
+  auto job_path = [&](const string &path) {
+    return path_is_relative(path) ? path_join(job_directory, path) : path;
+  };
+
+  std::istringstream stream(text);
+  string line;
+  while (std::getline(stream, line)) {
+    line = string_strip(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    const size_t split = line.find_first_of(" \t");
+    const string key = line.substr(0, split);
+    const string value = (split == string::npos) ? "" : string_strip(line.substr(split + 1));
+
+    if (key == "quit") {
+      job.quit = true;
+    }
+    else if (key == "scene") {
+      job.scene_filepath = job_path(value);
+    }
+    else if (key == "output") {
+      job.output_filepath = job_path(value);
+    }
+    else if (key == "samples") {
+      job.samples = atoi(value.c_str());
+    }
+    else if (key == "width") {
+      job.width = atoi(value.c_str());
+    }
+    else if (key == "height") {
+      job.height = atoi(value.c_str());
+    }
+    else {
+      fprintf(stderr, "Unknown setting \"%s\" in job %s\n", key.c_str(), job_filepath.c_str());
+      return false;
+    }
+  }
+
+  if (!job.quit && job.scene_filepath.empty()) {
+    fprintf(stderr, "No scene specified in job %s\n", job_filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+/* Remove all nodes of the previous job from the scene, while keeping the device data of the
+ * managers. Returns handles to the images the previous job used, so that the ones the next job
+ * uses as well are not freed and loaded again. */
+static vector<ImageHandle> server_scene_clear()
+{
+  Scene *scene = options.scene;
+  const thread_scoped_lock scene_lock(scene->mutex);
+
+  vector<ImageHandle> images;
+  for (Shader *shader : scene->shaders) {
+    for (ShaderNode *node : shader->graph->nodes) {
+      if (node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT) {
+        const ImageHandle &handle = static_cast<ImageSlotTextureNode *>(node)->handle;
+        if (!handle.empty()) {
+          images.push_back(handle);
+        }
+      }
+    }
+  }
+
+  scene->device_free();
+
+  /* Settings which are not in the next scene file should not leak over from the previous one. */
+  Node *scene_nodes[] = {scene->camera, scene->film, scene->integrator, scene->background};
+  for (Node *node : scene_nodes) {
+    const unique_ptr<Node> defaults = node->type->create(node->type);
+    for (const SocketType &socket : node->type->inputs) {
+      if (socket.type == SocketType::NODE) {
+        node->set(socket, (Node *)nullptr);
+      }
+      else if (socket.type != SocketType::NODE_ARRAY && !node->equals_value(*defaults, socket)) {
+        node->set_value(socket, *defaults, socket);
+      }
+    }
+  }
+
+  scene->reset();
+
+  return images;
+}
+
+static bool server_job_render(const ServerJob &job)
+{
+  Session *session = options.session.get();
+
+  const vector<ImageHandle> previous_images = server_scene_clear();
+
+  options.filepath = job.scene_filepath;
+  options.width = job.width;
+  options.height = job.height;
+
+  SessionParams session_params = options.session_params;
+  if (job.samples > 0) {
+    session_params.samples = job.samples;
+  }
+
+  if (!job.output_filepath.empty()) {
+    session->set_output_driver(make_unique<OIIOOutputDriver>(
+        job.output_filepath, options.output_pass, session_print));
+  }
+
+  /* The session thread is idle between jobs, so the scene can be loaded without locking. */
+  scene_init();
+
+  Pass *pass = options.scene->create_node<Pass>();
+  pass->set_name(ustring(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  session->progress.reset();
+  session->reset(session_params, session_buffer_params());
+  session->start();
+  session->wait();
+
+  /* Write the output before the next job starts. */
+  session->set_output_driver(nullptr);
+
+  if (!options.quiet) {
+    printf("\n");
+  }
+
+  return !session->progress.get_cancel() && !session->progress.get_error();
+}
+
+static void server_main()
+{
+  options.output_pass = "combined";
+  options.session = make_unique<Session>(options.session_params, options.scene_params);
+  options.scene = options.session->scene.get();
+
+  if (!options.quiet) {
+    options.session->progress.set_update_callback([] { session_print_status(); });
+    printf("Waiting for jobs in %s\n", options.server_directory.c_str());
+  }
+
+  /* Size and modification time of the job files seen in the previous iteration. */
+  map<string, pair<size_t, uint64_t>> job_file_states;
+
+  while (true) {
+    vector<string> entries;
+    OIIO::Filesystem::get_directory_entries(options.server_directory, entries);
+
+    vector<string> job_filepaths;
+    map<string, pair<size_t, uint64_t>> new_job_file_states;
+    for (const string &entry : entries) {
+      if (!string_endswith(entry, ".job")) {
+        continue;
+      }
+      /* Skip jobs that may still be written. */
+      const pair<size_t, uint64_t> state(path_file_size(entry), path_modified_time(entry));
+      const auto it = job_file_states.find(entry);
+      if (it != job_file_states.end() && it->second == state) {
+        job_filepaths.push_back(entry);
+      }
+      new_job_file_states[entry] = state;
+    }
+    job_file_states = std::move(new_job_file_states);
+
+    if (job_filepaths.empty()) {
+      time_sleep(1.0);
+      continue;
+    }
+
+    /* Render jobs in the order of their names. */
+    const string job_filepath = *std::min_element(job_filepaths.begin(), job_filepaths.end());
+
+    ServerJob job;
+    bool success = server_job_read(job_filepath, job);
+
+    if (success && job.quit) {
+      path_remove(job_filepath);
+      break;
+    }
+
+    if (success) {
+      if (!options.quiet) {
+        printf("Rendering %s\n", job_filepath.c_str());
+      }
+      success = server_job_render(job);
+    }
+
+    /* Rename the job so that it is not picked up again, and the submitter can see the result. */
+    const string result_filepath = job_filepath.substr(0, job_filepath.size() - 4) +
+                                   (success ? ".done" : ".failed");
+    path_remove(result_filepath);
+    if (rename(job_filepath.c_str(), result_filepath.c_str()) != 0) {
+      fprintf(stderr, "Failed to rename job %s\n", job_filepath.c_str());
+      path_remove(job_filepath);
+    }
+  }
+
+  session_exit();
+}
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
 static void display_info(Progress &progress)
 {
@@ -440,6 +696,14 @@ static void options_parse(const int argc, const char **argv)
   ap.arg("--tile-size %d:TILE_SIZE").help("Tile size in pixels").action([&](auto argv) {
     parse_int(argv, &options.session_params.tile_size);
   });
+  ap.arg("--server %s:DIRECTORY")
+      .help(
+          "Render job files appearing in the directory, keeping the device and data loaded. "
+          "Write jobs under another name and rename them to .job when complete")
+      .action([&](auto argv) { parse_string(argv, &options.server_directory); });
+  ap.arg("--update-trace %s:FILEPATH")
+      .help("Write timings of the scene update stages to this file as Chrome trace JSON")
+      .action([&](auto argv) { parse_string(argv, &options.update_trace_filepath); });
   ap.arg("--list-devices", &list).help("List information about all available devices");
   ap.arg("--profile", &profile).help("Enable profile logging");
 #ifdef WITH_CYCLES_LOGGING
@@ -479,7 +743,7 @@ static void options_parse(const int argc, const char **argv)
     printf("%s\n", CYCLES_VERSION_STRING);
     exit(EXIT_SUCCESS);
   }
-  else if (help || options.filepath.empty()) {
+  else if (help || (options.filepath.empty() && options.server_directory.empty())) {
     ap.print_help();
     exit(EXIT_SUCCESS);
   }
@@ -495,6 +759,10 @@ static void options_parse(const int argc, const char **argv)
 
 #ifndef WITH_CYCLES_STANDALONE_GUI
   options.session_params.background = true;
+#else
+  if (!options.server_directory.empty()) {
+    options.session_params.background = true;
+  }
 #endif
 
   if (options.session_params.tile_size > 0) {
@@ -532,7 +800,7 @@ static void options_parse(const int argc, const char **argv)
     fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
     exit(EXIT_FAILURE);
   }
-  else if (options.filepath.empty()) {
+  else if (options.filepath.empty() && options.server_directory.empty()) {
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
@@ -548,6 +816,11 @@ int main(const int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (!options.server_directory.empty()) {
+    server_main();
+    return 0;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
@@ -926,12 +926,34 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Use compact BVH structure (uses less ram but renders slower)",
         default=False,
     )
+    use_bvh_cache: BoolProperty(
+        name="Cache BVH",
+        description="Store built BVHs on disk and load them when rendering the same geometry again, "
+        "in later frames or renders. Only used for large instanced geometry, on devices which use the "
+        "Cycles BVH rather than Embree, OptiX, Metal or HIP RT",
+        default=False,
+    )
+    bvh_cache_size: IntProperty(
+        name="BVH Cache Size",
+        description="Maximum size of the BVH cache on disk in megabytes, the least recently used BVHs "
+        "are removed when it is exceeded",
+        default=4096,
+        min=1,
+        soft_max=65536,
+    )
     debug_bvh_time_steps: IntProperty(
         name="BVH Time Steps",
         description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
         default=0,
         min=0, max=16,
     )
+    debug_update_trace_filepath: StringProperty(
+        name="Update Trace",
+        description="Write the timings of the scene update stages of final renders to this file, as Chrome trace "
+        "JSON. Use # characters for the frame number",
+        subtype='FILE_PATH',
+        default="",
+    )
 
     bake_type: EnumProperty(
         name="Bake Type",
@@ -1014,6 +1036,44 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    texture_cache_size: IntProperty(
+        name="Texture Cache",
+        description="Look up image textures through a cache of this many megabytes, which loads tiles of the "
+                    "needed mipmap levels on demand instead of loading full images. Only used for CPU rendering, "
+                    "works best with tiled and mipmapped files like .tx. Zero to load images fully",
+        default=0,
+        min=0,
+        soft_max=65536,
+    )
+    use_compact_geometry: BoolProperty(
+        name="Compact Geometry",
+        description="Store vertex normals and UV maps within the 0 to 1 range at reduced precision, to use less "
+                    "memory for heavy scenes. May cause small differences in shading",
+        default=False,
+    )
+    volume_cache_size: IntProperty(
+        name="Volume Cache",
+        description="Keep volume grids converted for GPU rendering in a cache of this many megabytes, so that "
+                    "re-rendering the same grids skips the conversion. Zero to disable",
+        default=0,
+        min=0,
+        soft_max=65536,
+    )
+    use_volume_cache: BoolProperty(
+        name="Cache Volumes on Disk",
+        description="Store volume grids converted for GPU rendering on disk and load them when rendering the same "
+                    "grids again, in later sessions. Only used for volumes read unmodified from files",
+        default=False,
+    )
+    volume_disk_cache_size: IntProperty(
+        name="Volume Disk Cache Size",
+        description="Maximum size of the volume cache on disk in megabytes, the least recently used grids are "
+                    "removed when it is exceeded",
+        default=4096,
+        min=1,
+        soft_max=65536,
+    )
+
     use_fast_gi: BoolProperty(
         name="Fast GI Approximation",
         description="Approximate diffuse indirect light with background tinted ambient occlusion. "
@@ -1068,6 +1128,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render batches of paths per thread, grouped by the kernel they execute next",
+        default=False,
+    )
 
     adaptive_compile_description = "Compile the Cycles GPU kernel with only the feature set required for the current scene"
 
@@ -864,6 +864,20 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
 
+        col = layout.column()
+        col.active = use_cpu(context)
+        col.prop(cscene, "texture_cache_size")
+
+        col = layout.column()
+        col.prop(cscene, "use_compact_geometry")
+
+        col = layout.column()
+        col.prop(cscene, "volume_cache_size")
+        col.prop(cscene, "use_volume_cache")
+        sub = col.column()
+        sub.active = cscene.use_volume_cache
+        sub.prop(cscene, "volume_disk_cache_size")
+
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
     bl_label = "Acceleration Structure"
@@ -897,6 +911,10 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
                 sub.prop(cscene, "debug_bvh_time_steps")
 
                 col.prop(cscene, "debug_use_hair_bvh")
+                col.prop(cscene, "use_bvh_cache")
+                sub = col.column()
+                sub.active = cscene.use_bvh_cache
+                sub.prop(cscene, "bvh_cache_size")
 
                 sub = col.column(align=True)
                 sub.label(text="Cycles built without Embree support")
@@ -908,6 +926,10 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
             sub.prop(cscene, "debug_bvh_time_steps")
 
             col.prop(cscene, "debug_use_hair_bvh")
+            col.prop(cscene, "use_bvh_cache")
+            sub = col.column()
+            sub.active = cscene.use_bvh_cache
+            sub.prop(cscene, "bvh_cache_size")
 
             # CPU is used in addition to a GPU
             if use_multi_device(context) and use_embree:
@@ -2184,6 +2206,7 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
         row.prop(cscene, "debug_use_cpu_sse42", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
         col.prop(cscene, "debug_bvh_layout", text="BVH")
+        col.prop(cscene, "debug_use_cpu_wavefront")
 
         import platform
         is_macos = platform.system() == 'Darwin'
@@ -2209,6 +2232,10 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
 
         col.separator()
 
+        col.prop(cscene, "debug_update_trace_filepath")
+
+        col.separator()
+
         import _cycles
         if _cycles.with_debug:
             col.prop(cscene, "direct_light_sampling_type")
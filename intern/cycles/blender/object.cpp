@@ -487,6 +487,7 @@ void BlenderSync::sync_procedural(BL::Object &b_ob,
 
   procedural->set_use_prefetch(cache_file.use_prefetch());
   procedural->set_prefetch_cache_size(cache_file.prefetch_cache_size());
+  procedural->set_prefetch_window(cache_file.prefetch_window());
 
   /* create or update existing AlembicObjects */
   const ustring object_path = ustring(b_mesh_cache.object_path());
@@ -265,6 +265,29 @@ void BlenderSession::full_buffer_written(string_view filename)
   full_buffer_files_.emplace_back(filename);
 }
 
+/* File path to write the scene update trace of a render to, with the frame number substituted
+ * for # characters. */
+static string update_trace_filepath(BL::BlendData &b_data, BL::Scene &b_scene)
+{
+  PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+  string filepath = get_string(cscene, "debug_update_trace_filepath");
+  if (filepath.empty()) {
+    return filepath;
+  }
+
+  filepath = blender_absolute_path(b_data, b_scene, filepath);
+
+  const size_t begin = filepath.find('#');
+  if (begin != string::npos) {
+    const size_t end = min(filepath.find_first_not_of('#', begin), filepath.size());
+    const int num_digits = end - begin;
+    filepath.replace(
+        begin, num_digits, string_printf("%0*d", num_digits, b_scene.frame_current()));
+  }
+
+  return filepath;
+}
+
 static void add_cryptomatte_layer(BL::RenderResult &b_rr, string name, string manifest)
 {
   const string identifier = string_printf("%08x",
@@ -441,8 +464,11 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     session->reset(effective_session_params, buffer_params);
 
     /* render */
-    if (!b_engine.is_preview() && background && print_render_stats) {
-      scene->enable_update_stats();
+    if (!b_engine.is_preview() && background) {
+      const string trace_filepath = update_trace_filepath(b_data, b_scene);
+      if (print_render_stats || !trace_filepath.empty()) {
+        scene->enable_update_stats(trace_filepath);
+      }
     }
 
     session->start();
@@ -862,6 +862,10 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
   params.use_bvh_compact_structure = RNA_boolean_get(&cscene, "debug_use_compact_bvh");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
+  if (RNA_boolean_get(&cscene, "use_bvh_cache")) {
+    params.bvh_cache_directory = path_cache_get("bvh");
+    params.bvh_cache_size = RNA_int_get(&cscene, "bvh_cache_size");
+  }
 
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
   params.hair_subdivisions = get_int(csscene, "subdivisions");
@@ -882,6 +886,14 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
     params.texture_limit = 0;
   }
 
+  params.texture_cache_size = get_int(cscene, "texture_cache_size");
+  params.use_compact_geometry = get_boolean(cscene, "use_compact_geometry");
+  params.volume_cache_size = get_int(cscene, "volume_cache_size");
+  if (get_boolean(cscene, "use_volume_cache")) {
+    params.volume_cache_directory = path_cache_get("volume");
+    params.volume_disk_cache_size = get_int(cscene, "volume_disk_cache_size");
+  }
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -295,6 +295,12 @@ static void sync_volume_object(BL::BlendData &b_data,
 
   volume->set_velocity_scale(velocity_scale);
 
+  /* Converted grids can only be cached by file when they are used as loaded from the file, not
+   * when modifiers or Python changed them in memory. */
+  const bool use_nanovdb_cache = b_ob_info.is_real_object_data() &&
+                                 b_ob_info.real_object.modifiers.length() == 0 &&
+                                 !b_volume.packed_file();
+
   /* Find grid with matching name. */
   for (BL::VolumeGrid &b_grid : b_volume.grids) {
     const ustring name = ustring(b_grid.name());
@@ -343,8 +349,14 @@ static void sync_volume_object(BL::BlendData &b_data,
                             volume->attributes.add(std) :
                             volume->attributes.add(name, TypeFloat, ATTR_ELEMENT_VOXEL);
 
-      unique_ptr<ImageLoader> loader = make_unique<BlenderVolumeLoader>(
+      unique_ptr<BlenderVolumeLoader> loader = make_unique<BlenderVolumeLoader>(
           b_data, b_volume, name.string(), b_render.precision());
+      if (use_nanovdb_cache) {
+        loader->set_nanovdb_cache(b_volume.grids.frame_filepath(),
+                                  size_t(scene->params.volume_cache_size) * 1024 * 1024,
+                                  scene->params.volume_cache_directory,
+                                  size_t(scene->params.volume_disk_cache_size) * 1024 * 1024);
+      }
       ImageParams params;
       params.frame = b_volume.grids.frame();
 
@@ -13,7 +13,9 @@
 
 #include "util/algorithm.h"
 #include "util/boundbox.h"
+#include "util/tbb.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -52,14 +54,101 @@ __forceinline int get_best_dimension(const float4 &bestSAH)
 
 /* BVH Object Binning */
 
+void BVHObjectBinning::Bins::reset(const size_t num_bins)
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    count[i] = make_int4(0);
+    bounds[i][0] = bounds[i][1] = bounds[i][2] = BoundBox::empty;
+  }
+}
+
+void BVHObjectBinning::Bins::merge(const Bins &other, const size_t num_bins)
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    count[i] = count[i] + other.count[i];
+    bounds[i][0].grow(other.bounds[i][0]);
+    bounds[i][1].grow(other.bounds[i][1]);
+    bounds[i][2].grow(other.bounds[i][2]);
+  }
+}
+
+void BVHObjectBinning::bin_prims(const BVHReference *prims,
+                                 const size_t begin,
+                                 const size_t end,
+                                 Bins &bins) const
+{
+  int4 *bin_count = bins.count;
+  BoundBox(*bin_bounds)[3] = bins.bounds;
+
+  /* map geometry to bins, unrolled once */
+  size_t i;
+
+  for (i = begin; i + 1 < end; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    const BoundBox bounds0 = get_prim_bounds(prim0);
+    const BoundBox bounds1 = get_prim_bounds(prim1);
+
+    const int4 bin0 = get_bin(bounds0);
+    const int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    const int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    const int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    const int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    const int b10 = (int)extract<0>(bin1);
+    bin_count[b10][0]++;
+    bin_bounds[b10][0].grow(bounds1);
+    const int b11 = (int)extract<1>(bin1);
+    bin_count[b11][1]++;
+    bin_bounds[b11][1].grow(bounds1);
+    const int b12 = (int)extract<2>(bin1);
+    bin_count[b12][2]++;
+    bin_bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < end) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    const BoundBox bounds0 = get_prim_bounds(prim0);
+    const int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    const int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    const int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    const int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+  }
+}
+
 BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
                                    BVHReference *prims,
                                    const BVHUnaligned *unaligned_heuristic,
-                                   const Transform *aligned_space)
+                                   const Transform *aligned_space,
+                                   const size_t parallel_min_size)
     : BVHRange(job),
       splitSAH(FLT_MAX),
       dim(0),
       pos(0),
+      parallel_min_size_(parallel_min_size),
       unaligned_heuristic_(unaligned_heuristic),
       aligned_space_(aligned_space)
 {
@@ -79,75 +168,32 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   num_bins = min(size_t(MAX_BINS), size_t(4.0f + 0.05f * size()));
   scale = safe_divide(cent_bounds_.size(), make_float3((float)num_bins));
 
-  /* initialize binning counter and bounds */
-  BoundBox bin_bounds[MAX_BINS][4]; /* bounds for every bin in every dimension */
-  int4 bin_count[MAX_BINS];         /* number of primitives mapped to bin */
-
-  for (size_t i = 0; i < num_bins; i++) {
-    bin_count[i] = make_int4(0);
-    bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
+  /* map geometry to bins */
+  Bins bins;
+  if (size() >= parallel_min_size_) {
+    Bins empty_bins;
+    empty_bins.reset(num_bins);
+
+    bins = parallel_reduce(
+        blocked_range<size_t>(size_t(start()), size_t(end()), PARALLEL_GRAIN_SIZE),
+        empty_bins,
+        [&](const blocked_range<size_t> &r, Bins local_bins) {
+          bin_prims(prims, r.begin(), r.end(), local_bins);
+          return local_bins;
+        },
+        [&](Bins a, const Bins &b) {
+          a.merge(b, num_bins);
+          return a;
+        });
   }
-
-  /* map geometry to bins, unrolled once */
-  {
-    int64_t i;
-
-    for (i = 0; i < int64_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      const BoundBox bounds0 = get_prim_bounds(prim0);
-      const BoundBox bounds1 = get_prim_bounds(prim1);
-
-      const int4 bin0 = get_bin(bounds0);
-      const int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      const int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      const int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      const int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      const int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      const int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      const int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < int64_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      const BoundBox bounds0 = get_prim_bounds(prim0);
-      const int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      const int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      const int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      const int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-    }
+  else {
+    bins.reset(num_bins);
+    bin_prims(prims, start(), end(), bins);
   }
 
+  const int4 *bin_count = bins.count;
+  const BoundBox(*bin_bounds)[3] = bins.bounds;
+
   /* sweep from right to left and compute parallel prefix of merged bounds */
   float4 r_area[MAX_BINS];  /* area of bounds of primitives on the right */
   float4 r_count[MAX_BINS]; /* number of primitives on the right */
@@ -220,35 +266,51 @@ void BVHObjectBinning::split(BVHReference *prims,
   BoundBox lcent_bounds = BoundBox::empty;
   BoundBox rcent_bounds = BoundBox::empty;
 
-  int64_t l = 0;
-  int64_t r = N - 1;
-
-  while (l <= r) {
-    prefetch_L2(&prims[start() + l + 8]);
-    prefetch_L2(&prims[start() + r - 8]);
+  size_t num_left;
 
-    const BVHReference prim = prims[start() + l];
-    const BoundBox unaligned_bounds = get_prim_bounds(prim);
-    const float3 unaligned_center = unaligned_bounds.center2();
-    const float3 center = prim.bounds().center2();
-
-    if (get_bin(unaligned_center)[dim] < pos) {
-      lgeom_bounds.grow(prim.bounds());
-      lcent_bounds.grow(center);
-      l++;
-    }
-    else {
-      rgeom_bounds.grow(prim.bounds());
-      rcent_bounds.grow(center);
-      swap(prims[start() + l], prims[start() + r]);
-      r--;
+  if (N >= parallel_min_size_) {
+    num_left = partition_parallel(prims, lgeom_bounds, lcent_bounds, rgeom_bounds, rcent_bounds);
+  }
+  else {
+    int64_t l = 0;
+    int64_t r = N - 1;
+
+    while (l <= r) {
+      prefetch_L2(&prims[start() + l + 8]);
+      prefetch_L2(&prims[start() + r - 8]);
+
+      const BVHReference prim = prims[start() + l];
+      const float3 center = prim.bounds().center2();
+
+      if (goes_left(prim)) {
+        lgeom_bounds.grow(prim.bounds());
+        lcent_bounds.grow(center);
+        l++;
+      }
+      else {
+        rgeom_bounds.grow(prim.bounds());
+        rcent_bounds.grow(center);
+        swap(prims[start() + l], prims[start() + r]);
+        r--;
+      }
     }
+
+    num_left = l;
   }
+
   /* finish */
-  if (l != 0 && N - 1 - r != 0) {
-    right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + l, N - 1 - r),
-                               prims);
-    left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims);
+  if (num_left != 0 && num_left != N) {
+    right_o = BVHObjectBinning(
+        BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left),
+        prims,
+        nullptr,
+        nullptr,
+        parallel_min_size_);
+    left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left),
+                              prims,
+                              nullptr,
+                              nullptr,
+                              parallel_min_size_);
     return;
   }
 
@@ -270,8 +332,113 @@ void BVHObjectBinning::split(BVHReference *prims,
   }
 
   right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + N / 2, N / 2 + N % 2),
-                             prims);
-  left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), N / 2), prims);
+                             prims,
+                             nullptr,
+                             nullptr,
+                             parallel_min_size_);
+  left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), N / 2),
+                            prims,
+                            nullptr,
+                            nullptr,
+                            parallel_min_size_);
+}
+
+/* Stable partition of the primitives in blocks: every block counts its primitives on each
+ * side, and a prefix sum over the blocks gives where to scatter them. The result does not
+ * depend on the number of threads. */
+size_t BVHObjectBinning::partition_parallel(BVHReference *prims,
+                                            BoundBox &lgeom_bounds,
+                                            BoundBox &lcent_bounds,
+                                            BoundBox &rgeom_bounds,
+                                            BoundBox &rcent_bounds) const
+{
+  struct Block {
+    size_t num_left;
+    BoundBox lgeom_bounds, lcent_bounds;
+    BoundBox rgeom_bounds, rcent_bounds;
+  };
+
+  const size_t N = size();
+  const size_t num_blocks = divide_up(N, size_t(PARALLEL_GRAIN_SIZE));
+
+  vector<Block> blocks(num_blocks);
+  vector<uint8_t> left(N);
+
+  /* classify primitives */
+  parallel_for(size_t(0), num_blocks, [&](const size_t block_index) {
+    const size_t begin = block_index * PARALLEL_GRAIN_SIZE;
+    const size_t end = min(begin + PARALLEL_GRAIN_SIZE, N);
+
+    Block &block = blocks[block_index];
+    block.num_left = 0;
+    block.lgeom_bounds = block.lcent_bounds = BoundBox::empty;
+    block.rgeom_bounds = block.rcent_bounds = BoundBox::empty;
+
+    for (size_t i = begin; i < end; i++) {
+      const BVHReference &prim = prims[start() + i];
+      const float3 center = prim.bounds().center2();
+
+      left[i] = goes_left(prim);
+      if (left[i]) {
+        block.lgeom_bounds.grow(prim.bounds());
+        block.lcent_bounds.grow(center);
+        block.num_left++;
+      }
+      else {
+        block.rgeom_bounds.grow(prim.bounds());
+        block.rcent_bounds.grow(center);
+      }
+    }
+  });
+
+  /* compute where every block writes its primitives */
+  vector<size_t> left_offset(num_blocks);
+  vector<size_t> right_offset(num_blocks);
+  size_t num_left = 0;
+
+  for (size_t block_index = 0; block_index < num_blocks; block_index++) {
+    const Block &block = blocks[block_index];
+    left_offset[block_index] = num_left;
+    num_left += block.num_left;
+
+    lgeom_bounds.grow(block.lgeom_bounds);
+    lcent_bounds.grow(block.lcent_bounds);
+    rgeom_bounds.grow(block.rgeom_bounds);
+    rcent_bounds.grow(block.rcent_bounds);
+  }
+
+  for (size_t block_index = 0, num_right = 0; block_index < num_blocks; block_index++) {
+    const size_t begin = block_index * PARALLEL_GRAIN_SIZE;
+    const size_t end = min(begin + PARALLEL_GRAIN_SIZE, N);
+    right_offset[block_index] = num_left + num_right;
+    num_right += (end - begin) - blocks[block_index].num_left;
+  }
+
+  if (num_left == 0 || num_left == N) {
+    return num_left;
+  }
+
+  /* scatter into temporary storage and copy back */
+  vector<BVHReference> sorted(N);
+
+  parallel_for(size_t(0), num_blocks, [&](const size_t block_index) {
+    const size_t begin = block_index * PARALLEL_GRAIN_SIZE;
+    const size_t end = min(begin + PARALLEL_GRAIN_SIZE, N);
+    size_t l = left_offset[block_index];
+    size_t r = right_offset[block_index];
+
+    for (size_t i = begin; i < end; i++) {
+      sorted[(left[i]) ? l++ : r++] = prims[start() + i];
+    }
+  });
+
+  parallel_for(size_t(0), num_blocks, [&](const size_t block_index) {
+    const size_t begin = block_index * PARALLEL_GRAIN_SIZE;
+    const size_t end = min(begin + PARALLEL_GRAIN_SIZE, N);
+    std::copy(sorted.begin() + begin, sorted.begin() + end, prims + start() + begin);
+  });
+
+  return num_left;
 }
 
 CCL_NAMESPACE_END
@@ -16,21 +16,28 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
- * by testing for each dimension multiple partitionings for regular spaced
- * partition locations. A partitioning for a partition location is computed,
- * by putting primitives whose centroid is on the left and right of the split
- * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+/* Object binner. Finds the split with the best SAH heuristic by testing for
+ * each dimension multiple partitionings for regular spaced partition
+ * locations. A partitioning for a partition location is computed, by putting
+ * primitives whose centroid is on the left and right of the split location to
+ * different sets. The SAH is evaluated by computing the number of blocks
+ * occupied by the primitives in the partitions.
+ *
+ * Large ranges, as found in the upper levels of the tree, are binned and
+ * partitioned in parallel, since there are too few subtrees yet to keep all
+ * threads busy. */
 
 class BVHObjectBinning : public BVHRange {
  public:
   __forceinline BVHObjectBinning() : leafSAH(FLT_MAX) {}
 
+  /* Ranges of at least parallel_min_size primitives are binned and partitioned in parallel,
+   * which can be changed to compare both in tests. */
   BVHObjectBinning(const BVHRange &job,
                    BVHReference *prims,
                    const BVHUnaligned *unaligned_heuristic = nullptr,
-                   const Transform *aligned_space = nullptr);
+                   const Transform *aligned_space = nullptr,
+                   size_t parallel_min_size = PARALLEL_MIN_SIZE);
 
   void split(BVHReference *prims, BVHObjectBinning &left_o, BVHObjectBinning &right_o) const;
 
@@ -48,6 +55,8 @@ class BVHObjectBinning : public BVHRange {
   size_t num_bins; /* actual number of bins to use */
   float3 scale;    /* scaling factor to compute bin */
 
+  size_t parallel_min_size_; /* minimum number of primitives to handle in parallel */
+
   /* Effective bounds and centroid bounds. */
   BoundBox bounds_;
   BoundBox cent_bounds_;
@@ -58,6 +67,31 @@ class BVHObjectBinning : public BVHRange {
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Default minimum number of primitives to bin and partition in parallel, and
+   * the number of primitives handled by each task. */
+  enum { PARALLEL_MIN_SIZE = 32768 };
+  enum { PARALLEL_GRAIN_SIZE = 8192 };
+
+  /* Number of primitives and bounds for every bin in every dimension. */
+  struct Bins {
+    BoundBox bounds[MAX_BINS][3];
+    int4 count[MAX_BINS];
+
+    void reset(const size_t num_bins);
+    void merge(const Bins &other, const size_t num_bins);
+  };
+
+  void bin_prims(const BVHReference *prims,
+                 const size_t begin,
+                 const size_t end,
+                 Bins &bins) const;
+
+  size_t partition_parallel(BVHReference *prims,
+                            BoundBox &lgeom_bounds,
+                            BoundBox &lcent_bounds,
+                            BoundBox &rgeom_bounds,
+                            BoundBox &rcent_bounds) const;
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
@@ -93,6 +127,12 @@ class BVHObjectBinning : public BVHRange {
     }
     return unaligned_heuristic_->compute_aligned_prim_boundbox(prim, *aligned_space_);
   }
+
+  /* test if the primitive goes to the left side of the best split. */
+  __forceinline bool goes_left(const BVHReference &prim) const
+  {
+    return get_bin(get_prim_bounds(prim).center2())[dim] < pos;
+  }
 };
 
 CCL_NAMESPACE_END
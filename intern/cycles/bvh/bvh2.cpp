@@ -15,9 +15,11 @@
 #include "scene/pointcloud.h"
 
 #include "bvh/build.h"
+#include "bvh/cache.h"
 #include "bvh/node.h"
 #include "bvh/unaligned.h"
 
+#include "util/log.h"
 #include "util/progress.h"
 
 CCL_NAMESPACE_BEGIN
@@ -38,6 +40,19 @@ BVH2::BVH2(const BVHParams &params_,
 
 void BVH2::build(Progress &progress, Stats * /*unused*/)
 {
+  /* Geometry level BVHs are not affected by objects and can be reused from the cache. */
+  string cache_filepath;
+  if (!params.top_level && !params.cache_directory.empty() && geometry.size() == 1 &&
+      bvh_cache_use(geometry[0]))
+  {
+    progress.set_substatus("Loading cached BVH");
+    cache_filepath = bvh_cache_filepath(params.cache_directory, params, geometry[0]);
+    if (bvh_cache_read(cache_filepath, pack)) {
+      VLOG_WORK << "Loaded BVH from cache " << cache_filepath;
+      return;
+    }
+  }
+
   progress.set_substatus("Building BVH");
 
   /* build nodes */
@@ -73,6 +88,12 @@ void BVH2::build(Progress &progress, Stats * /*unused*/)
   /* pack nodes */
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root.get());
+
+  if (!cache_filepath.empty() && !progress.get_cancel()) {
+    if (!bvh_cache_write(cache_filepath, pack, params.cache_size)) {
+      VLOG_WORK << "Failed to write BVH to cache " << cache_filepath;
+    }
+  }
 }
 
 void BVH2::refit(Progress &progress)
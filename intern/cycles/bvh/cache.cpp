@@ -0,0 +1,314 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <cstdio>
+#include <cstring>
+
+#include "bvh/bvh.h"
+#include "bvh/cache.h"
+#include "bvh/params.h"
+
+#include "scene/hair.h"
+#include "scene/mesh.h"
+#include "scene/pointcloud.h"
+
+#include "util/md5.h"
+#include "util/path.h"
+#include "util/tbb.h"
+#include "util/time.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bump when the layout of packed nodes or of the file changes. */
+static const uint32_t BVH_CACHE_VERSION = 1;
+static const size_t BVH_CACHE_MIN_PRIMITIVES = 65536;
+static const char BVH_CACHE_MAGIC[8] = {'C', 'Y', 'B', 'V', 'H', '2', '\0', '\0'};
+
+struct BVHCacheHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t root_index;
+  uint64_t nodes_size;
+  uint64_t leaf_nodes_size;
+  uint64_t prim_type_size;
+  uint64_t prim_visibility_size;
+  uint64_t prim_index_size;
+  uint64_t prim_object_size;
+  uint64_t prim_time_size;
+};
+
+/* Hashing
+ *
+ * Large arrays are hashed as independent blocks in parallel, and the digests of the blocks are
+ * combined, so that hashing takes a small fraction of the time needed to build the BVH. */
+
+static const size_t HASH_BLOCK_SIZE = size_t(1) << 20;
+
+/* Hash the bytes produced by `get_block(begin, size, block)`, for blocks of `size` elements of
+ * `element_size` bytes starting at element `begin`. */
+template<typename GetBlockFunc>
+static void hash_blocks(MD5Hash &md5,
+                        const size_t num_elements,
+                        const size_t element_size,
+                        const GetBlockFunc &get_block)
+{
+  const size_t block_elements = max(HASH_BLOCK_SIZE / element_size, size_t(1));
+  const size_t num_blocks = divide_up(num_elements, block_elements);
+
+  vector<string> digests(num_blocks);
+  parallel_for(size_t(0), num_blocks, [&](const size_t i) {
+    const size_t begin = i * block_elements;
+    const size_t size = min(block_elements, num_elements - begin);
+    vector<uint8_t> block;
+    const uint8_t *bytes = get_block(begin, size, block);
+
+    MD5Hash block_md5;
+    block_md5.append(bytes, int(size * element_size));
+    digests[i] = block_md5.get_hex();
+  });
+
+  for (const string &digest : digests) {
+    md5.append(digest);
+  }
+}
+
+static void hash_bytes(MD5Hash &md5, const void *data, const size_t nbytes)
+{
+  hash_blocks(md5,
+              nbytes,
+              1,
+              [&](const size_t begin, const size_t /*size*/, vector<uint8_t> & /*block*/) {
+                return (const uint8_t *)data + begin;
+              });
+}
+
+template<typename T> static void hash_value(MD5Hash &md5, const T value)
+{
+  md5.append((const uint8_t *)&value, sizeof(T));
+}
+
+template<typename T> static void hash_array(MD5Hash &md5, const array<T> &a)
+{
+  hash_value(md5, uint64_t(a.size()));
+  hash_bytes(md5, a.data(), a.size() * sizeof(T));
+}
+
+/* Only hash the XYZ components, the 4th is padding and may hold anything. */
+static void hash_float3_data(MD5Hash &md5, const float3 *data, const size_t size)
+{
+  hash_value(md5, uint64_t(size));
+
+  hash_blocks(md5,
+              size,
+              sizeof(packed_float3),
+              [&](const size_t begin, const size_t block_size, vector<uint8_t> &block) {
+                block.resize(block_size * sizeof(packed_float3));
+                packed_float3 *packed = (packed_float3 *)block.data();
+                for (size_t i = 0; i < block_size; i++) {
+                  packed[i] = data[begin + i];
+                }
+                return block.data();
+              });
+}
+
+static void hash_params(MD5Hash &md5, const BVHParams &params)
+{
+  hash_value(md5, params.use_spatial_split);
+  hash_value(md5, params.spatial_split_alpha);
+  hash_value(md5, params.unaligned_split_threshold);
+  hash_value(md5, params.sah_node_cost);
+  hash_value(md5, params.sah_primitive_cost);
+  hash_value(md5, params.min_leaf_size);
+  hash_value(md5, params.max_triangle_leaf_size);
+  hash_value(md5, params.max_motion_triangle_leaf_size);
+  hash_value(md5, params.max_curve_leaf_size);
+  hash_value(md5, params.max_motion_curve_leaf_size);
+  hash_value(md5, params.max_point_leaf_size);
+  hash_value(md5, params.max_motion_point_leaf_size);
+  hash_value(md5, params.top_level);
+  hash_value(md5, int(params.bvh_layout));
+  hash_value(md5, params.use_unaligned_nodes);
+  hash_value(md5, params.num_motion_triangle_steps);
+  hash_value(md5, params.num_motion_curve_steps);
+  hash_value(md5, params.num_motion_point_steps);
+  hash_value(md5, params.curve_subdivisions);
+}
+
+static void hash_geometry(MD5Hash &md5, const Geometry *geom)
+{
+  hash_value(md5, int(geom->geometry_type));
+  hash_value(md5, int(geom->primitive_type()));
+
+  const bool has_motion_blur = geom->has_motion_blur();
+  hash_value(md5, has_motion_blur);
+  hash_value(md5, geom->get_motion_steps());
+
+  if (geom->is_mesh() || geom->is_volume()) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    hash_float3_data(md5, mesh->get_verts().data(), mesh->get_verts().size());
+    hash_array(md5, mesh->get_triangles());
+  }
+  else if (geom->is_hair()) {
+    const Hair *hair = static_cast<const Hair *>(geom);
+    hash_float3_data(md5, hair->get_curve_keys().data(), hair->get_curve_keys().size());
+    hash_array(md5, hair->get_curve_radius());
+    hash_array(md5, hair->get_curve_first_key());
+  }
+  else if (geom->is_pointcloud()) {
+    const PointCloud *pointcloud = static_cast<const PointCloud *>(geom);
+    hash_float3_data(md5, pointcloud->get_points().data(), pointcloud->get_points().size());
+    hash_array(md5, pointcloud->get_radius());
+  }
+
+  if (has_motion_blur) {
+    const Attribute *attr_mP = geom->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+    if (attr_mP) {
+      if (geom->is_mesh() || geom->is_volume()) {
+        hash_float3_data(md5,
+                         attr_mP->data_float3(),
+                         attr_mP->buffer.size() / sizeof(float3));
+      }
+      else {
+        /* Curve keys and points store the radius in the 4th component. */
+        hash_bytes(md5, attr_mP->data(), attr_mP->buffer.size());
+      }
+    }
+  }
+}
+
+bool bvh_cache_use(const Geometry *geom)
+{
+  /* Small geometry builds faster than it is hashed and read from disk. */
+  size_t num_primitives = 0;
+  if (geom->is_mesh() || geom->is_volume()) {
+    num_primitives = static_cast<const Mesh *>(geom)->num_triangles();
+  }
+  else if (geom->is_hair()) {
+    num_primitives = static_cast<const Hair *>(geom)->num_segments();
+  }
+  else if (geom->is_pointcloud()) {
+    num_primitives = static_cast<const PointCloud *>(geom)->num_points();
+  }
+  return num_primitives >= BVH_CACHE_MIN_PRIMITIVES;
+}
+
+string bvh_cache_filepath(const string &directory, const BVHParams &params, const Geometry *geom)
+{
+  MD5Hash md5;
+  hash_value(md5, BVH_CACHE_VERSION);
+  hash_params(md5, params);
+  hash_geometry(md5, geom);
+
+  return path_join(directory, md5.get_hex() + ".bvh");
+}
+
+/* Reading and Writing */
+
+template<typename T> static bool read_array(FILE *f, array<T> &a, const uint64_t size)
+{
+  a.resize(size);
+  return size == 0 || fread(a.data(), sizeof(T), size, f) == size;
+}
+
+template<typename T> static bool write_array(FILE *f, const array<T> &a)
+{
+  return a.size() == 0 || fwrite(a.data(), sizeof(T), a.size(), f) == a.size();
+}
+
+bool bvh_cache_read(const string &filepath, PackedBVH &pack)
+{
+  FILE *f = path_fopen(filepath, "rb");
+  if (!f) {
+    return false;
+  }
+
+  BVHCacheHeader header;
+  bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+            memcmp(header.magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC)) == 0 &&
+            header.version == BVH_CACHE_VERSION;
+
+  if (ok) {
+    /* Guard against truncated files, before allocating anything. */
+    const uint64_t expected_size = sizeof(header) + header.nodes_size * sizeof(int4) +
+                                   header.leaf_nodes_size * sizeof(int4) +
+                                   header.prim_type_size * sizeof(int) +
+                                   header.prim_visibility_size * sizeof(uint) +
+                                   header.prim_index_size * sizeof(int) +
+                                   header.prim_object_size * sizeof(int) +
+                                   header.prim_time_size * sizeof(float2);
+    ok = path_file_size(filepath) == expected_size;
+  }
+
+  ok = ok && read_array(f, pack.nodes, header.nodes_size) &&
+       read_array(f, pack.leaf_nodes, header.leaf_nodes_size) &&
+       read_array(f, pack.prim_type, header.prim_type_size) &&
+       read_array(f, pack.prim_visibility, header.prim_visibility_size) &&
+       read_array(f, pack.prim_index, header.prim_index_size) &&
+       read_array(f, pack.prim_object, header.prim_object_size) &&
+       read_array(f, pack.prim_time, header.prim_time_size);
+
+  fclose(f);
+
+  if (!ok) {
+    pack = PackedBVH();
+    return false;
+  }
+
+  pack.object_node.clear();
+  pack.root_index = header.root_index;
+
+  path_cache_mark_used(filepath);
+  return true;
+}
+
+bool bvh_cache_write(const string &filepath, const PackedBVH &pack, const size_t max_size)
+{
+  path_create_directories(filepath);
+
+  /* Write to a file with a unique name first, so that renders running at the same time never see
+   * a partially written file. */
+  const string tmp_filepath = string_printf(
+      "%s.%llx.tmp",
+      filepath.c_str(),
+      (unsigned long long)((uintptr_t)&pack ^ (uintptr_t)(time_dt() * 1e6)));
+
+  FILE *f = path_fopen(tmp_filepath, "wb");
+  if (!f) {
+    return false;
+  }
+
+  BVHCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC));
+  header.version = BVH_CACHE_VERSION;
+  header.root_index = pack.root_index;
+  header.nodes_size = pack.nodes.size();
+  header.leaf_nodes_size = pack.leaf_nodes.size();
+  header.prim_type_size = pack.prim_type.size();
+  header.prim_visibility_size = pack.prim_visibility.size();
+  header.prim_index_size = pack.prim_index.size();
+  header.prim_object_size = pack.prim_object.size();
+  header.prim_time_size = pack.prim_time.size();
+
+  const bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && write_array(f, pack.nodes) &&
+                  write_array(f, pack.leaf_nodes) && write_array(f, pack.prim_type) &&
+                  write_array(f, pack.prim_visibility) && write_array(f, pack.prim_index) &&
+                  write_array(f, pack.prim_object) && write_array(f, pack.prim_time);
+
+  if (fclose(f) != 0 || !ok) {
+    path_remove(tmp_filepath);
+    return false;
+  }
+
+  if (rename(tmp_filepath.c_str(), filepath.c_str()) != 0) {
+    /* Another render may have added the same file in the meantime. */
+    path_remove(tmp_filepath);
+    return false;
+  }
+
+  path_cache_mark_added_and_clear_to_size(filepath, max_size);
+  return true;
+}
+
+CCL_NAMESPACE_END
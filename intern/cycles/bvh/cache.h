@@ -0,0 +1,39 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/string.h"
+
+CCL_NAMESPACE_BEGIN
+
+class BVHParams;
+class Geometry;
+struct PackedBVH;
+
+/* BVH Cache
+ *
+ * Stores packed geometry level BVH2 on disk, so that rendering the same geometry again in a later
+ * frame or render loads the BVH instead of building it. Files are named after a hash of the
+ * geometry data used for building and the build parameters. */
+
+/* Only geometry level BVHs are cached, that is BVH2 of instanced geometry. Geometry that is not
+ * instanced is part of the scene level BVH, which changes with every object and is never cached.
+ * Embree, OptiX, Metal and HIP-RT build their own structures that can not be serialized, so the
+ * cache is unused with them, including for CPU rendering with Embree. */
+
+/* Whether it is worth caching the BVH of the geometry, instead of building it every time. */
+bool bvh_cache_use(const Geometry *geom);
+
+/* File path of the cached BVH for the geometry in the given directory. */
+string bvh_cache_filepath(const string &directory, const BVHParams &params, const Geometry *geom);
+
+/* Read a cached BVH, returns false when there is none or it is invalid. */
+bool bvh_cache_read(const string &filepath, PackedBVH &pack);
+
+/* Write the BVH to the cache, replacing the file atomically. The least recently used files are
+ * then removed until the cache directory is within the maximum size in bytes. */
+bool bvh_cache_write(const string &filepath, const PackedBVH &pack, const size_t max_size);
+
+CCL_NAMESPACE_END
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "util/boundbox.h"
+#include "util/string.h"
 #include "util/vector.h"
 
 #include "kernel/types.h"
@@ -107,6 +108,11 @@ class BVHParams {
   /* These are needed for Embree. */
   int curve_subdivisions;
 
+  /* Directory to cache geometry level BVH2 in, disabled when empty, and its maximum size in
+   * bytes. */
+  string cache_directory;
+  size_t cache_size;
+
   /* fixed parameters */
   enum { MAX_DEPTH = 64, MAX_SPATIAL_DEPTH = 48, NUM_SPATIAL_BINS = 32 };
 
@@ -142,6 +148,8 @@ class BVHParams {
     bvh_type = 0;
 
     curve_subdivisions = 4;
+
+    cache_size = 0;
   }
 
   /* SAH costs */
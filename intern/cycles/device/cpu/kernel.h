@@ -31,6 +31,7 @@ class CPUKernels {
   IntegratorInitFunction integrator_init_from_camera;
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_megakernel;
+  IntegratorShadeFunction integrator_megakernel_step;
 
   /* Shader evaluation. */
 
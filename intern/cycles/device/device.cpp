@@ -506,6 +506,13 @@ void Device::host_free(const MemoryType /*type*/, void *host_pointer, const size
   util_aligned_free(host_pointer, size);
 }
 
+void Device::mem_copy_to_partial(device_memory &mem,
+                                 const size_t /*offset*/,
+                                 const size_t /*size*/)
+{
+  mem_copy_to(mem);
+}
+
 GPUDevice::~GPUDevice() noexcept(false) = default;
 
 bool GPUDevice::load_texture_info()
@@ -806,6 +813,24 @@ void GPUDevice::generic_copy_to(device_memory &mem)
   }
 }
 
+void GPUDevice::mem_copy_to_partial(device_memory &mem, const size_t offset, const size_t size)
+{
+  if (!mem.device_pointer || mem.type == MEM_TEXTURE) {
+    mem_copy_to(mem);
+    return;
+  }
+
+  if (!mem.host_pointer || !mem.is_resident(this)) {
+    return;
+  }
+
+  /* Host mapped memory is used by the device directly, nothing to copy. */
+  if (!(mem.is_shared(this) && mem.host_pointer == mem.shared_pointer)) {
+    copy_host_to_device(
+        (char *)mem.device_pointer + offset, (char *)mem.host_pointer + offset, size);
+  }
+}
+
 bool GPUDevice::is_shared(const void *shared_pointer,
                           const device_ptr device_pointer,
                           Device * /*sub_device*/)
@@ -312,6 +312,9 @@ class Device {
 
   virtual void mem_alloc(device_memory &mem) = 0;
   virtual void mem_copy_to(device_memory &mem) = 0;
+  /* Copy a range of bytes of memory that was copied to the device before with the same size.
+   * Devices without support for this copy all memory. */
+  virtual void mem_copy_to_partial(device_memory &mem, const size_t offset, const size_t size);
   virtual void mem_move_to_host(device_memory &mem) = 0;
   virtual void mem_copy_from(
       device_memory &mem, const size_t y, size_t w, const size_t h, size_t elem) = 0;
@@ -384,6 +387,7 @@ class GPUDevice : public Device {
   virtual GPUDevice::Mem *generic_alloc(device_memory &mem, const size_t pitch_padding = 0);
   virtual void generic_free(device_memory &mem);
   virtual void generic_copy_to(device_memory &mem);
+  void mem_copy_to_partial(device_memory &mem, const size_t offset, const size_t size) override;
 
   /* total - amount of device memory, free - amount of available device memory */
   virtual void get_device_memory_info(size_t &total, size_t &free) = 0;
@@ -83,6 +83,15 @@ void device_memory::device_copy_to()
 {
   if (host_pointer) {
     device->mem_copy_to(*this);
+    device->stats.mem_copy(memory_size());
+  }
+}
+
+void device_memory::device_copy_to_partial(const size_t offset, const size_t size)
+{
+  if (host_pointer) {
+    device->mem_copy_to_partial(*this, offset, size);
+    device->stats.mem_copy(size);
   }
 }
 
@@ -182,6 +191,7 @@ device_texture::device_texture(Device *device,
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
     case IMAGE_DATA_TYPE_NANOVDB_FPN:
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
       data_type = TYPE_UCHAR;
       data_elements = 1;
       break;
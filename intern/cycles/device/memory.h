@@ -288,6 +288,7 @@ class device_memory {
   /* Device memory allocation and copying. */
   void device_alloc();
   void device_copy_to();
+  void device_copy_to_partial(const size_t offset, const size_t size);
   void device_move_to_host();
   void device_copy_from(const size_t y, const size_t w, size_t h, const size_t elem);
   void device_zero();
@@ -394,6 +395,7 @@ template<typename T> class device_vector : public device_memory {
       host_and_device_free();
       host_pointer = host_alloc(sizeof(T) * new_size);
       modified = true;
+      modified_partial_ = false;
       assert(device_pointer == 0);
     }
 
@@ -462,6 +464,7 @@ template<typename T> class device_vector : public device_memory {
     data_depth = 0;
     host_pointer = 0;
     modified = true;
+    modified_partial_ = false;
     need_realloc_ = true;
     assert(device_pointer == 0);
   }
@@ -486,6 +489,28 @@ template<typename T> class device_vector : public device_memory {
   void tag_modified()
   {
     modified = true;
+    modified_partial_ = false;
+  }
+
+  /* Tag a range of elements as modified. Unless the whole memory is tagged as modified as well,
+   * copy_to_device_if_modified() only copies the modified ranges. */
+  void tag_modified(const size_t offset, const size_t size)
+  {
+    if (size == 0 || (modified && !modified_partial_)) {
+      return;
+    }
+
+    if (modified_partial_) {
+      modified_begin_ = min(modified_begin_, offset);
+      modified_end_ = max(modified_end_, offset + size);
+    }
+    else {
+      modified_begin_ = offset;
+      modified_end_ = offset + size;
+    }
+
+    modified = true;
+    modified_partial_ = true;
   }
 
   void tag_realloc()
@@ -528,12 +553,20 @@ template<typename T> class device_vector : public device_memory {
       return;
     }
 
+    if (modified_partial_ && device_pointer) {
+      assert(modified_end_ <= data_size);
+      device_copy_to_partial(modified_begin_ * sizeof(T),
+                             (modified_end_ - modified_begin_) * sizeof(T));
+      return;
+    }
+
     copy_to_device();
   }
 
   void clear_modified()
   {
     modified = false;
+    modified_partial_ = false;
     need_realloc_ = false;
   }
 
@@ -557,6 +590,11 @@ template<typename T> class device_vector : public device_memory {
   {
     return width * ((height == 0) ? 1 : height) * ((depth == 0) ? 1 : depth);
   }
+
+  /* Range of elements modified since the last clear_modified(), if not all of them. */
+  bool modified_partial_ = false;
+  size_t modified_begin_ = 0;
+  size_t modified_end_ = 0;
 };
 
 /* Device Sub Memory
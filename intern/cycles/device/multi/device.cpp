@@ -417,6 +417,27 @@ class MultiDevice : public Device {
     stats.mem_alloc(mem.device_size - existing_size);
   }
 
+  void mem_copy_to_partial(device_memory &mem, const size_t offset, const size_t size) override
+  {
+    device_ptr key = mem.device_pointer;
+    if (!key) {
+      mem_copy_to(mem);
+      return;
+    }
+
+    /* Memory was allocated before, so only the owning devices need to copy. */
+    for (const vector<SubDevice *> &island : peer_islands) {
+      SubDevice *owner_sub = find_suitable_mem_device(key, island);
+      mem.device = owner_sub->device.get();
+      mem.device_pointer = owner_sub->ptr_map[key];
+
+      owner_sub->device->mem_copy_to_partial(mem, offset, size);
+    }
+
+    mem.device = this;
+    mem.device_pointer = key;
+  }
+
   void mem_move_to_host(device_memory &mem) override
   {
     assert(mem.type == MEM_GLOBAL || mem.type == MEM_TEXTURE);
@@ -19,10 +19,20 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/debug.h"
 #include "util/tbb.h"
 
+#include <algorithm>
+
 CCL_NAMESPACE_BEGIN
 
+/* Number of paths each thread keeps in flight when using the wavefront scheduler, and the number
+ * of pixels handed to a thread at once. Every path state holds the shadow intersections of its
+ * shadow and AO paths, about 50 KB, so this is kept small enough for the states of each thread to
+ * stay within a few megabytes. */
+static constexpr int WAVEFRONT_PATHS_NUM = 64;
+static constexpr int64_t WAVEFRONT_PIXELS_NUM = 1024;
+
 /* Create TBB arena for execution of path tracing and rendering tasks. */
 static inline tbb::task_arena local_tbb_arena_create(const Device *device)
 {
@@ -57,6 +67,10 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  /* Path states of the wavefront scheduler are allocated on first use. */
+  wavefront_states_.clear();
+  wavefront_states_.resize(kernel_thread_globals_.size());
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -74,8 +88,56 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     }
   }
 
+  /* Path guiding collects the segments of one path at a time per thread, so can't interleave
+   * paths. */
+  const bool use_wavefront = DebugFlags().cpu.wavefront &&
+                             !device_scene_->data.integrator.use_guiding;
+  /* A shadow catcher split writes the new path into the state following the current one. */
+  const int wavefront_states_num = WAVEFRONT_PATHS_NUM *
+                                   (device_scene_->data.integrator.has_shadow_catcher ? 2 : 1);
+
+  KernelWorkTile work_tile_template;
+  work_tile_template.x = 0;
+  work_tile_template.y = 0;
+  work_tile_template.w = 1;
+  work_tile_template.h = 1;
+  work_tile_template.start_sample = start_sample;
+  work_tile_template.sample_offset = sample_offset;
+  work_tile_template.num_samples = 1;
+  work_tile_template.offset = effective_buffer_params_.offset;
+  work_tile_template.stride = effective_buffer_params_.stride;
+
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
   local_arena.execute([&]() {
+    if (use_wavefront) {
+      const int64_t batches_num = divide_up(total_pixels_num, WAVEFRONT_PIXELS_NUM);
+      parallel_for(int64_t(0), batches_num, [&](int64_t batch_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int thread_index = tbb::this_task_arena::current_thread_index();
+        ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(
+            kernel_thread_globals_);
+
+        WavefrontStates &states = wavefront_states_[thread_index];
+        if (states.states_num < wavefront_states_num) {
+          /* Left uninitialized, most of the shadow intersection storage is never touched. */
+          states.states.reset(new IntegratorStateCPU[wavefront_states_num]);
+          states.states_num = wavefront_states_num;
+        }
+
+        const int64_t first_pixel = batch_index * WAVEFRONT_PIXELS_NUM;
+        render_samples_wavefront(kernel_globals,
+                                 states.states.get(),
+                                 work_tile_template,
+                                 first_pixel,
+                                 std::min(WAVEFRONT_PIXELS_NUM, total_pixels_num - first_pixel),
+                                 samples_num);
+      });
+      return;
+    }
+
     parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
       if (is_cancel_requested()) {
         return;
@@ -84,16 +146,9 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
       const int y = work_index / image_width;
       const int x = work_index - y * image_width;
 
-      KernelWorkTile work_tile;
+      KernelWorkTile work_tile = work_tile_template;
       work_tile.x = effective_buffer_params_.full_x + x;
       work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
 
       ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
 
@@ -165,6 +220,152 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
   }
 }
 
+/* Kernel which the next megakernel step executes for the path, following the same order of
+ * queues as integrator_megakernel_step(). */
+static DeviceKernel wavefront_next_kernel(const IntegratorStateCPU *state)
+{
+  if (state->shadow.shadow_path.queued_kernel) {
+    return DeviceKernel(state->shadow.shadow_path.queued_kernel);
+  }
+  if (state->ao.shadow_path.queued_kernel) {
+    return DeviceKernel(state->ao.shadow_path.queued_kernel);
+  }
+  if (state->path.queued_kernel) {
+    return DeviceKernel(state->path.queued_kernel);
+  }
+  return DEVICE_KERNEL_NUM;
+}
+
+void PathTraceWorkCPU::render_samples_wavefront(ThreadKernelGlobalsCPU *kernel_globals,
+                                                IntegratorStateCPU *states,
+                                                const KernelWorkTile &work_tile_template,
+                                                const int64_t first_pixel,
+                                                const int64_t pixels_num,
+                                                const int samples_num)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const int64_t image_width = effective_buffer_params_.width;
+  float *render_buffer = buffers_->buffer.data();
+
+  /* A shadow catcher split writes the new path into the state following the current one. */
+  const int states_stride = device_scene_->data.integrator.has_shadow_catcher ? 2 : 1;
+  const int paths_num = int(std::min(int64_t(WAVEFRONT_PATHS_NUM), pixels_num));
+  const int states_num = paths_num * states_stride;
+
+  /* Pixel and remaining samples of every path. */
+  KernelWorkTile path_tiles[WAVEFRONT_PATHS_NUM];
+  int path_samples_left[WAVEFRONT_PATHS_NUM];
+
+  for (int i = 0; i < states_num; i++) {
+    path_state_init_queues(&states[i]);
+  }
+  for (int i = 0; i < paths_num; i++) {
+    path_samples_left[i] = 0;
+  }
+
+  int64_t next_pixel = first_pixel;
+  const int64_t end_pixel = first_pixel + pixels_num;
+
+  DeviceKernel next_kernels[WAVEFRONT_PATHS_NUM * 2];
+  int kernel_paths_num[DEVICE_KERNEL_NUM];
+  vector<int> queue;
+  queue.reserve(states_num);
+
+  while (true) {
+    /* Start the next sample of paths which are done, unless rendering is canceled. */
+    bool has_pending_samples = false;
+    if (!is_cancel_requested()) {
+      for (int i = 0; i < paths_num; i++) {
+        IntegratorStateCPU *state = &states[i * states_stride];
+        if (wavefront_next_kernel(state) != DEVICE_KERNEL_NUM ||
+            (states_stride == 2 && wavefront_next_kernel(state + 1) != DEVICE_KERNEL_NUM))
+        {
+          continue;
+        }
+
+        KernelWorkTile &tile = path_tiles[i];
+        while (true) {
+          if (path_samples_left[i] == 0) {
+            if (next_pixel == end_pixel) {
+              break;
+            }
+            const int64_t work_index = next_pixel++;
+            const int y = work_index / image_width;
+            const int x = work_index - y * image_width;
+            tile = work_tile_template;
+            tile.x = effective_buffer_params_.full_x + x;
+            tile.y = effective_buffer_params_.full_y + y;
+            path_samples_left[i] = samples_num;
+          }
+
+          const bool started = has_bake ? kernels_.integrator_init_from_bake(
+                                              kernel_globals, state, &tile, render_buffer) :
+                                          kernels_.integrator_init_from_camera(
+                                              kernel_globals, state, &tile, render_buffer);
+          if (started) {
+            --path_samples_left[i];
+            ++tile.start_sample;
+            break;
+          }
+
+          /* Pixel converged or has nothing to bake, skip its remaining samples. */
+          path_samples_left[i] = 0;
+        }
+
+        has_pending_samples |= path_samples_left[i] > 0;
+      }
+    }
+
+    /* Execute the kernel with the most paths queued for it, so that the same code and data is
+     * used for many paths in a row. */
+    std::fill_n(kernel_paths_num, int(DEVICE_KERNEL_NUM), 0);
+    for (int i = 0; i < states_num; i++) {
+      next_kernels[i] = wavefront_next_kernel(&states[i]);
+      if (next_kernels[i] != DEVICE_KERNEL_NUM) {
+        kernel_paths_num[next_kernels[i]]++;
+      }
+    }
+
+    const int *max_paths_num = std::max_element(kernel_paths_num,
+                                                kernel_paths_num + DEVICE_KERNEL_NUM);
+    if (*max_paths_num == 0) {
+      if (has_pending_samples || (next_pixel != end_pixel && !is_cancel_requested())) {
+        continue;
+      }
+      break;
+    }
+
+    const DeviceKernel kernel = DeviceKernel(max_paths_num - kernel_paths_num);
+
+    queue.clear();
+    for (int i = 0; i < states_num; i++) {
+      if (next_kernels[i] == kernel) {
+        queue.push_back(i);
+      }
+    }
+
+    /* Shade hits on the same object and primitive one after another, as a cheap substitute for
+     * sorting by shader. */
+    if (kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+        kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE ||
+        kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE)
+    {
+      std::sort(queue.begin(), queue.end(), [&](const int a, const int b) {
+        const IntegratorStateCPU &state_a = states[a];
+        const IntegratorStateCPU &state_b = states[b];
+        if (state_a.isect.object != state_b.isect.object) {
+          return state_a.isect.object < state_b.isect.object;
+        }
+        return state_a.isect.prim < state_b.isect.prim;
+      });
+    }
+
+    for (const int i : queue) {
+      kernels_.integrator_megakernel_step(kernel_globals, &states[i], render_buffer);
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        const int num_samples)
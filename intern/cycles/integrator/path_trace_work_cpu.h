@@ -11,6 +11,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -74,6 +75,15 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Render all samples of a range of pixels, keeping a batch of paths in flight and executing
+   * the same kernel for all paths which need it before moving on to the next kernel. */
+  void render_samples_wavefront(ThreadKernelGlobalsCPU *kernel_globals,
+                                IntegratorStateCPU *states,
+                                const KernelWorkTile &work_tile_template,
+                                const int64_t first_pixel,
+                                const int64_t pixels_num,
+                                const int samples_num);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -83,6 +93,13 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<ThreadKernelGlobalsCPU> kernel_thread_globals_;
+
+  /* Per-thread path states used by the wavefront scheduler, allocated on first use. */
+  struct WavefrontStates {
+    unique_ptr<IntegratorStateCPU[]> states;
+    int states_num = 0;
+  };
+  vector<WavefrontStates> wavefront_states_;
 };
 
 CCL_NAMESPACE_END
@@ -32,6 +32,7 @@ KERNEL_DATA_ARRAY(DecomposedTransform, camera_motion)
 /* triangles */
 KERNEL_DATA_ARRAY(uint, tri_shader)
 KERNEL_DATA_ARRAY(packed_float3, tri_vnormal)
+KERNEL_DATA_ARRAY(uint, tri_vnormal_packed)
 KERNEL_DATA_ARRAY(packed_uint3, tri_vindex)
 KERNEL_DATA_ARRAY(uint, tri_patch)
 KERNEL_DATA_ARRAY(float2, tri_patch_uv)
@@ -53,6 +54,7 @@ KERNEL_DATA_ARRAY(uint, points_shader)
 KERNEL_DATA_ARRAY(AttributeMap, attributes_map)
 KERNEL_DATA_ARRAY(float, attributes_float)
 KERNEL_DATA_ARRAY(float2, attributes_float2)
+KERNEL_DATA_ARRAY(uint, attributes_half2)
 KERNEL_DATA_ARRAY(packed_float3, attributes_float3)
 KERNEL_DATA_ARRAY(float4, attributes_float4)
 KERNEL_DATA_ARRAY(uchar4, attributes_uchar4)
@@ -864,6 +864,10 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, const int id, const
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE: {
+      const TextureCacheHandle &handle = *(const TextureCacheHandle *)info.data;
+      return handle.lookup(handle, info, x, y, zero_float2(), zero_float2());
+    }
     default:
       assert(0);
       return make_float4(
@@ -871,6 +875,21 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, const int id, const
   }
 }
 
+/* Lookup with derivatives of the texture coordinates, which are used to pick a mip level for
+ * images in the texture cache. Other images are not mip-mapped. */
+ccl_device float4 kernel_tex_image_interp_filtered(
+    KernelGlobals kg, const int id, const float x, float y, const float2 dx, const float2 dy)
+{
+  const TextureInfo &info = kernel_data_fetch(texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE && info.data) {
+    const TextureCacheHandle &handle = *(const TextureCacheHandle *)info.data;
+    return handle.lookup(handle, info, x, y, dx, dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              const int id,
                                              float3 P,
@@ -293,6 +293,17 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, const int id, const
   }
 }
 
+/* Images are never looked up through a texture cache on the GPU, so derivatives are unused. */
+ccl_device float4 kernel_tex_image_interp_filtered(KernelGlobals kg,
+                                                   const int id,
+                                                   const float x,
+                                                   float y,
+                                                   const float2 /*dx*/,
+                                                   const float2 /*dy*/)
+{
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              const int id,
                                              float3 P,
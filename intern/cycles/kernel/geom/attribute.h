@@ -8,6 +8,7 @@
 #include "kernel/types.h"
 
 #include "util/color.h"
+#include "util/half.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -128,6 +129,25 @@ ccl_device_template_spec uchar4 attribute_data_fetch(KernelGlobals kg, int offse
   return kernel_data_fetch(attributes_uchar4, offset);
 }
 
+/* Read attribute data, taking into account how the attribute of the descriptor is stored. */
+template<typename T>
+ccl_device_inline T attribute_data_fetch(KernelGlobals kg,
+                                         const AttributeDescriptor desc,
+                                         const int offset)
+{
+  return attribute_data_fetch<T>(kg, offset);
+}
+
+ccl_device_template_spec float2 attribute_data_fetch(KernelGlobals kg,
+                                                     const AttributeDescriptor desc,
+                                                     const int offset)
+{
+  if (desc.flags & ATTR_HALF_PRECISION) {
+    return half2_packed_to_float2(kernel_data_fetch(attributes_half2, offset));
+  }
+  return kernel_data_fetch(attributes_float2, offset);
+}
+
 /* ATTR_ELEMENT_CORNER_BYTE is stored as uchar4, but has to be converted to float4.
  * We don't support it for float/float2/float3. */
 template<typename T>
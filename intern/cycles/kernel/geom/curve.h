@@ -57,8 +57,8 @@ ccl_device T curve_attribute(KernelGlobals kg,
     const int k0 = curve.first_key + PRIMITIVE_UNPACK_SEGMENT(sd->type);
     const int k1 = k0 + 1;
 
-    const T f0 = attribute_data_fetch<T>(kg, desc.offset + k0);
-    const T f1 = attribute_data_fetch<T>(kg, desc.offset + k1);
+    const T f0 = attribute_data_fetch<T>(kg, desc, desc.offset + k0);
+    const T f1 = attribute_data_fetch<T>(kg, desc, desc.offset + k1);
 
 #  ifdef __RAY_DIFFERENTIALS__
     if (dfdx) {
@@ -86,7 +86,7 @@ ccl_device T curve_attribute(KernelGlobals kg,
 #  endif
 
   if (desc.element == ATTR_ELEMENT_CURVE) {
-    return attribute_data_fetch<T>(kg, desc.offset + sd->prim);
+    return attribute_data_fetch<T>(kg, desc, desc.offset + sd->prim);
   }
   return make_zero<T>();
 }
@@ -271,7 +271,7 @@ ccl_device_inline int patch_eval_control_verts(KernelGlobals kg,
 template<typename T, bool is_uchar>
 ccl_device T patch_eval(KernelGlobals kg,
                         const ccl_private ShaderData *sd,
-                        const int offset,
+                        const AttributeDescriptor desc,
                         const int patch,
                         const float u,
                         const float v,
@@ -298,10 +298,10 @@ ccl_device T patch_eval(KernelGlobals kg,
   for (int i = 0; i < num_control; i++) {
     T v;
     if (is_uchar) {
-      v = attribute_data_fetch_bytecolor<T>(kg, offset + indices[i]);
+      v = attribute_data_fetch_bytecolor<T>(kg, desc.offset + indices[i]);
     }
     else {
-      v = attribute_data_fetch<T>(kg, offset + indices[i]);
+      v = attribute_data_fetch<T>(kg, desc, desc.offset + indices[i]);
     }
 
     val += v * weights[i];
@@ -38,7 +38,7 @@ ccl_device T point_attribute(KernelGlobals kg,
 #  endif
 
   if (desc.element == ATTR_ELEMENT_VERTEX) {
-    return attribute_data_fetch<T>(kg, desc.offset + sd->prim);
+    return attribute_data_fetch<T>(kg, desc, desc.offset + sd->prim);
   }
   return make_zero<T>();
 }
@@ -44,7 +44,7 @@ ccl_device_forceinline T primitive_surface_attribute(KernelGlobals kg,
       *dfdy = make_zero<T>();
     }
 
-    return attribute_data_fetch<T>(kg, desc.offset);
+    return attribute_data_fetch<T>(kg, desc, desc.offset);
   }
 
   if (sd->type & PRIMITIVE_TRIANGLE) {
@@ -154,10 +154,10 @@ ccl_device_noinline T subd_triangle_attribute(KernelGlobals kg,
     T dads;
     T dadt;
     if (desc.type == NODE_ATTR_RGBA) {
-      a = patch_eval<T, true>(kg, sd, desc.offset, patch, p.x, p.y, 0, &dads, &dadt);
+      a = patch_eval<T, true>(kg, sd, desc, patch, p.x, p.y, 0, &dads, &dadt);
     }
     else {
-      a = patch_eval<T, false>(kg, sd, desc.offset, patch, p.x, p.y, 0, &dads, &dadt);
+      a = patch_eval<T, false>(kg, sd, desc, patch, p.x, p.y, 0, &dads, &dadt);
     }
 
 #  ifdef __RAY_DIFFERENTIALS__
@@ -175,7 +175,7 @@ ccl_device_noinline T subd_triangle_attribute(KernelGlobals kg,
       *dfdy = make_zero<T>();
     }
 
-    return attribute_data_fetch<T>(kg, desc.offset + subd_triangle_patch_face(kg, patch));
+    return attribute_data_fetch<T>(kg, desc, desc.offset + subd_triangle_patch_face(kg, patch));
   }
   if (desc.element == ATTR_ELEMENT_VERTEX || desc.element == ATTR_ELEMENT_VERTEX_MOTION) {
     float2 uv[3];
@@ -183,10 +183,10 @@ ccl_device_noinline T subd_triangle_attribute(KernelGlobals kg,
 
     const uint4 v = subd_triangle_patch_indices(kg, patch);
 
-    const T f0 = attribute_data_fetch<T>(kg, desc.offset + v.x);
-    T f1 = attribute_data_fetch<T>(kg, desc.offset + v.y);
-    const T f2 = attribute_data_fetch<T>(kg, desc.offset + v.z);
-    T f3 = attribute_data_fetch<T>(kg, desc.offset + v.w);
+    const T f0 = attribute_data_fetch<T>(kg, desc, desc.offset + v.x);
+    T f1 = attribute_data_fetch<T>(kg, desc, desc.offset + v.y);
+    const T f2 = attribute_data_fetch<T>(kg, desc, desc.offset + v.z);
+    T f3 = attribute_data_fetch<T>(kg, desc, desc.offset + v.w);
 
     if (subd_triangle_patch_num_corners(kg, patch) != 4) {
       f1 = (f1 + f0) * 0.5f;
@@ -227,10 +227,10 @@ ccl_device_noinline T subd_triangle_attribute(KernelGlobals kg,
       f3 = attribute_data_fetch_bytecolor<T>(kg, corners[3] + desc.offset);
     }
     else {
-      f0 = attribute_data_fetch<T>(kg, corners[0] + desc.offset);
-      f1 = attribute_data_fetch<T>(kg, corners[1] + desc.offset);
-      f2 = attribute_data_fetch<T>(kg, corners[2] + desc.offset);
-      f3 = attribute_data_fetch<T>(kg, corners[3] + desc.offset);
+      f0 = attribute_data_fetch<T>(kg, desc, corners[0] + desc.offset);
+      f1 = attribute_data_fetch<T>(kg, desc, corners[1] + desc.offset);
+      f2 = attribute_data_fetch<T>(kg, desc, corners[2] + desc.offset);
+      f3 = attribute_data_fetch<T>(kg, desc, corners[3] + desc.offset);
     }
 
     if (subd_triangle_patch_num_corners(kg, patch) != 4) {
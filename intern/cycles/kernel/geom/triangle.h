@@ -86,6 +86,14 @@ ccl_device_inline void triangle_vertices(KernelGlobals kg, const int prim, float
 
 /* Triangle vertex locations and vertex normals */
 
+ccl_device_inline float3 triangle_vertex_normal(KernelGlobals kg, const int vert)
+{
+  if (kernel_data.bvh.use_compact_geometry) {
+    return octahedral_packed_to_float3(kernel_data_fetch(tri_vnormal_packed, vert));
+  }
+  return kernel_data_fetch(tri_vnormal, vert);
+}
+
 ccl_device_inline void triangle_vertices_and_normals(KernelGlobals kg,
                                                      const int prim,
                                                      float3 P[3],
@@ -96,9 +104,9 @@ ccl_device_inline void triangle_vertices_and_normals(KernelGlobals kg,
   P[1] = kernel_data_fetch(tri_verts, tri_vindex.y);
   P[2] = kernel_data_fetch(tri_verts, tri_vindex.z);
 
-  N[0] = kernel_data_fetch(tri_vnormal, tri_vindex.x);
-  N[1] = kernel_data_fetch(tri_vnormal, tri_vindex.y);
-  N[2] = kernel_data_fetch(tri_vnormal, tri_vindex.z);
+  N[0] = triangle_vertex_normal(kg, tri_vindex.x);
+  N[1] = triangle_vertex_normal(kg, tri_vindex.y);
+  N[2] = triangle_vertex_normal(kg, tri_vindex.z);
 }
 
 /* Interpolate smooth vertex normal from vertices */
@@ -109,9 +117,9 @@ triangle_smooth_normal(KernelGlobals kg, const float3 Ng, const int prim, const
   /* load triangle vertices */
   const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
 
-  const float3 n0 = kernel_data_fetch(tri_vnormal, tri_vindex.x);
-  const float3 n1 = kernel_data_fetch(tri_vnormal, tri_vindex.y);
-  const float3 n2 = kernel_data_fetch(tri_vnormal, tri_vindex.z);
+  const float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  const float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  const float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   const float3 N = safe_normalize((1.0f - u - v) * n0 + u * n1 + v * n2);
 
@@ -133,9 +141,9 @@ ccl_device_inline float3 triangle_smooth_normal(KernelGlobals kg,
   /* Load triangle vertices. */
   const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
 
-  const float3 n0 = kernel_data_fetch(tri_vnormal, tri_vindex.x);
-  const float3 n1 = kernel_data_fetch(tri_vnormal, tri_vindex.y);
-  const float3 n2 = kernel_data_fetch(tri_vnormal, tri_vindex.z);
+  const float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  const float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  const float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   const float3 N = safe_normalize(triangle_interpolate(u, v, n0, n1, n2));
   N_x = safe_normalize(triangle_interpolate(u + du.dx * BUMP_DX, v + dv.dx * BUMP_DX, n0, n1, n2));
@@ -156,9 +164,9 @@ ccl_device_inline float3 triangle_smooth_normal_unnormalized(KernelGlobals kg,
   /* load triangle vertices */
   const uint3 tri_vindex = kernel_data_fetch(tri_vindex, prim);
 
-  float3 n0 = kernel_data_fetch(tri_vnormal, tri_vindex.x);
-  float3 n1 = kernel_data_fetch(tri_vnormal, tri_vindex.y);
-  float3 n2 = kernel_data_fetch(tri_vnormal, tri_vindex.z);
+  float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   /* ensure that the normals are in object space */
   if (sd->object_flag & SD_OBJECT_TRANSFORM_APPLIED) {
@@ -238,9 +246,9 @@ ccl_device T triangle_attribute(KernelGlobals kg,
     if (desc.element & (ATTR_ELEMENT_VERTEX | ATTR_ELEMENT_VERTEX_MOTION)) {
       const uint3 tri_vindex = kernel_data_fetch(tri_vindex, sd->prim);
 
-      f0 = attribute_data_fetch<T>(kg, desc.offset + tri_vindex.x);
-      f1 = attribute_data_fetch<T>(kg, desc.offset + tri_vindex.y);
-      f2 = attribute_data_fetch<T>(kg, desc.offset + tri_vindex.z);
+      f0 = attribute_data_fetch<T>(kg, desc, desc.offset + tri_vindex.x);
+      f1 = attribute_data_fetch<T>(kg, desc, desc.offset + tri_vindex.y);
+      f2 = attribute_data_fetch<T>(kg, desc, desc.offset + tri_vindex.z);
     }
     else if (desc.element == ATTR_ELEMENT_CORNER_BYTE) {
       const int tri = desc.offset + sd->prim * 3;
@@ -250,9 +258,9 @@ ccl_device T triangle_attribute(KernelGlobals kg,
     }
     else {
       const int tri = desc.offset + sd->prim * 3;
-      f0 = attribute_data_fetch<T>(kg, tri + 0);
-      f1 = attribute_data_fetch<T>(kg, tri + 1);
-      f2 = attribute_data_fetch<T>(kg, tri + 2);
+      f0 = attribute_data_fetch<T>(kg, desc, tri + 0);
+      f1 = attribute_data_fetch<T>(kg, desc, tri + 1);
+      f2 = attribute_data_fetch<T>(kg, desc, tri + 2);
     }
 
 #ifdef __RAY_DIFFERENTIALS__
@@ -276,7 +284,7 @@ ccl_device T triangle_attribute(KernelGlobals kg,
 #endif
 
   if (desc.element == ATTR_ELEMENT_FACE) {
-    return attribute_data_fetch<T>(kg, desc.offset + sd->prim);
+    return attribute_data_fetch<T>(kg, desc, desc.offset + sd->prim);
   }
   return make_zero<T>();
 }
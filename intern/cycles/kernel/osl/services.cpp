@@ -1189,7 +1189,12 @@ bool OSLRenderServices::texture(OSLUStringHash filename,
             TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
       }
       else {
-        rgba = kernel_tex_image_interp(kernel_globals, id, s, 1.0f - t);
+        rgba = kernel_tex_image_interp_filtered(kernel_globals,
+                                                id,
+                                                s,
+                                                1.0f - t,
+                                                make_float2(dsdx, -dtdx),
+                                                make_float2(dsdy, -dtdy));
       }
 
       result[0] = rgba[0];
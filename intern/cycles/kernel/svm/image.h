@@ -9,7 +9,9 @@
 
 #include "kernel/camera/projection.h"
 
+#include "kernel/geom/attribute.h"
 #include "kernel/geom/object.h"
+#include "kernel/geom/primitive.h"
 
 #include "kernel/svm/util.h"
 
@@ -17,15 +19,20 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4
-svm_image_texture(KernelGlobals kg, const int id, const float x, float y, const uint flags)
+ccl_device float4 svm_image_texture(KernelGlobals kg,
+                                    const int id,
+                                    const float x,
+                                    float y,
+                                    const float2 dx,
+                                    const float2 dy,
+                                    const uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  float4 r = kernel_tex_image_interp_filtered(kg, id, x, y, dx, dy);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -47,7 +54,7 @@ ccl_device_inline float3 texco_remap_square(const float3 co)
 }
 
 ccl_device_noinline int svm_node_tex_image(KernelGlobals kg,
-                                           ccl_private ShaderData * /*sd*/,
+                                           ccl_private ShaderData *sd,
                                            ccl_private float *stack,
                                            const uint4 node,
                                            int offset)
@@ -73,6 +80,17 @@ ccl_device_noinline int svm_node_tex_image(KernelGlobals kg,
     tex_co = make_float2(co.x, co.y);
   }
 
+  /* Derivatives of the UV map, only known when the coordinates come straight from it. */
+  float2 dx = zero_float2();
+  float2 dy = zero_float2();
+  if (flags & NODE_IMAGE_UV_DERIVATIVES) {
+    const uint4 uv_node = read_node(kg, &offset);
+    const AttributeDescriptor desc = find_attribute(kg, sd, uv_node.x);
+    if (desc.offset != ATTR_STD_NOT_FOUND && desc.type == NODE_ATTR_FLOAT2) {
+      primitive_surface_attribute<float2>(kg, sd, desc, &dx, &dy);
+    }
+  }
+
   /* TODO(lukas): Consider moving tile information out of the SVM node.
    * TextureInfo seems a reasonable candidate. */
   int id = -1;
@@ -116,7 +134,7 @@ ccl_device_noinline int svm_node_tex_image(KernelGlobals kg,
     id = -num_nodes;
   }
 
-  const float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  const float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, dx, dy, flags);
 
   if (stack_valid(out_offset)) {
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -215,15 +233,15 @@ ccl_device_noinline void svm_node_tex_image_box(KernelGlobals kg,
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     const float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.y > 0.0f) {
     const float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.z > 0.0f) {
     const float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
 
   if (stack_valid(out_offset)) {
@@ -260,7 +278,7 @@ ccl_device_noinline void svm_node_tex_environment(KernelGlobals kg,
     uv = direction_to_mirrorball(co);
   }
 
-  const float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  const float4 f = svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
 
   if (stack_valid(out_offset)) {
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -356,6 +356,8 @@ enum NodeImageProjection {
 enum NodeImageFlags {
   NODE_IMAGE_COMPRESS_AS_SRGB = 1,
   NODE_IMAGE_ALPHA_UNASSOCIATE = 2,
+  /* An extra node with the UV attribute follows, used for texture cache mip selection. */
+  NODE_IMAGE_UV_DERIVATIVES = 4,
 };
 
 enum NodeEnvironmentProjection {
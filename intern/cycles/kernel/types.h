@@ -919,6 +919,8 @@ enum AttributeStandard {
 enum AttributeFlag {
   ATTR_FINAL_SIZE = (1 << 0),
   ATTR_SUBDIVIDED = (1 << 1),
+  /* Float2 attribute stored as two packed half floats in the attributes_half2 array. */
+  ATTR_HALF_PRECISION = (1 << 2),
 };
 
 struct AttributeDescriptor {
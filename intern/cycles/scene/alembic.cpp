@@ -17,6 +17,7 @@
 #include "util/log.h"
 #include "util/progress.h"
 #include "util/set.h"
+#include "util/tbb.h"
 #include "util/transform.h"
 #include "util/vector.h"
 
@@ -30,7 +31,7 @@ CCL_NAMESPACE_BEGIN
 
 template<typename SchemaType>
 static vector<FaceSetShaderIndexPair> parse_face_sets_for_shader_assignment(
-    SchemaType &schema, const array<Node *> &used_shaders)
+    SchemaType &schema, const vector<ustring> &shader_names)
 {
   vector<FaceSetShaderIndexPair> result;
 
@@ -44,15 +45,15 @@ static vector<FaceSetShaderIndexPair> parse_face_sets_for_shader_assignment(
   for (const std::string &face_set_name : face_set_names) {
     int shader_index = 0;
 
-    for (Node *node : used_shaders) {
-      if (node->name == face_set_name) {
+    for (const ustring &shader_name : shader_names) {
+      if (shader_name == face_set_name) {
         break;
       }
 
       ++shader_index;
     }
 
-    if (shader_index >= used_shaders.size()) {
+    if (shader_index >= shader_names.size()) {
       /* use the first shader instead if none was found */
       shader_index = 0;
     }
@@ -469,7 +470,7 @@ bool AlembicObject::has_data_loaded() const
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const LoadSettings &settings,
                                        IPolyMeshSchema &schema,
                                        Progress &progress)
 {
@@ -488,9 +489,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.face_indices = schema.getFaceIndicesProperty();
   data.normals = schema.getNormalsParam();
   data.num_samples = schema.getNumSamples();
-  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, settings.shader_names);
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -499,18 +500,17 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), settings.requested_attributes, progress);
 
   if (progress.get_cancel()) {
     return;
   }
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const LoadSettings &settings,
                                        ISubDSchema &schema,
                                        Progress &progress)
 {
@@ -521,7 +521,7 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
 
   cached_data.clear();
 
-  if (this->get_ignore_subdivision()) {
+  if (settings.ignore_subdivision) {
     PolyMeshSchemaData data;
     data.topology_variance = schema.getTopologyVariance();
     data.time_sampling = schema.getTimeSampling();
@@ -530,9 +530,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
     data.face_indices = schema.getFaceIndicesProperty();
     data.num_samples = schema.getNumSamples();
     data.velocities = schema.getVelocitiesProperty();
-    data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+    data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, settings.shader_names);
 
-    read_geometry_data(proc, cached_data, data, progress);
+    read_geometry_data(cached_data, data, progress);
 
     if (progress.get_cancel()) {
       return;
@@ -541,10 +541,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
     /* Use the schema as the base compound property to also be able to look for top level
      * properties. */
     read_attributes(
-        proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+        cached_data, schema, schema.getUVsParam(), settings.requested_attributes, progress);
 
     cached_data.invalidate_last_loaded_time(true);
-    data_loaded = true;
     return;
   }
 
@@ -566,9 +565,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.holes = schema.getHolesProperty();
   data.subdivision_scheme = schema.getSubdivisionSchemeProperty();
   data.velocities = schema.getVelocitiesProperty();
-  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, get_used_shaders());
+  data.shader_face_sets = parse_face_sets_for_shader_assignment(schema, settings.shader_names);
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -577,14 +576,13 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), settings.requested_attributes, progress);
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const LoadSettings &settings,
                                        const ICurvesSchema &schema,
                                        Progress &progress)
 {
@@ -607,10 +605,10 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.topology_variance = schema.getTopologyVariance();
   data.num_samples = schema.getNumSamples();
   data.num_vertices = schema.getNumVerticesProperty();
-  data.default_radius = proc->get_default_radius();
-  data.radius_scale = get_radius_scale();
+  data.default_radius = settings.default_radius;
+  data.radius_scale = settings.radius_scale;
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -619,14 +617,13 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
   read_attributes(
-      proc, cached_data, schema, schema.getUVsParam(), get_requested_attributes(), progress);
+      cached_data, schema, schema.getUVsParam(), settings.requested_attributes, progress);
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::load_data_in_cache(CachedData &cached_data,
-                                       AlembicProcedural *proc,
+                                       const LoadSettings &settings,
                                        const IPointsSchema &schema,
                                        Progress &progress)
 {
@@ -643,10 +640,10 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
   data.velocities = schema.getVelocitiesProperty();
   data.time_sampling = schema.getTimeSampling();
   data.num_samples = schema.getNumSamples();
-  data.default_radius = proc->get_default_radius();
-  data.radius_scale = get_radius_scale();
+  data.default_radius = settings.default_radius;
+  data.radius_scale = settings.radius_scale;
 
-  read_geometry_data(proc, cached_data, data, progress);
+  read_geometry_data(cached_data, data, progress);
 
   if (progress.get_cancel()) {
     return;
@@ -654,10 +651,9 @@ void AlembicObject::load_data_in_cache(CachedData &cached_data,
 
   /* Use the schema as the base compound property to also be able to look for top level properties.
    */
-  read_attributes(proc, cached_data, schema, {}, get_requested_attributes(), progress);
+  read_attributes(cached_data, schema, {}, settings.requested_attributes, progress);
 
   cached_data.invalidate_last_loaded_time(true);
-  data_loaded = true;
 }
 
 void AlembicObject::setup_transform_cache(CachedData &cached_data, float scale)
@@ -723,6 +719,25 @@ AttributeRequestSet AlembicObject::get_requested_attributes()
   return requested_attributes;
 }
 
+AlembicObject::LoadSettings AlembicObject::get_load_settings(const AlembicProcedural *proc)
+{
+  LoadSettings settings;
+
+  if (!instance_of && object && object->get_geometry()) {
+    settings.requested_attributes = get_requested_attributes();
+  }
+
+  for (const Node *node : get_used_shaders()) {
+    settings.shader_names.push_back(node->name);
+  }
+
+  settings.default_radius = proc->get_default_radius();
+  settings.radius_scale = get_radius_scale();
+  settings.ignore_subdivision = get_ignore_subdivision();
+
+  return settings;
+}
+
 /* Update existing attributes and remove any attribute not in the cached_data, those attributes
  * were added by Cycles (e.g. face normals) */
 static void update_attributes(AttributeSet &attributes,
@@ -793,6 +808,7 @@ NODE_DEFINE(AlembicProcedural)
 
   SOCKET_BOOLEAN(use_prefetch, "Use Prefetch", true);
   SOCKET_INT(prefetch_cache_size, "Prefetch Cache Size", 4096);
+  SOCKET_INT(prefetch_window, "Prefetch Window", 0);
 
   return type;
 }
@@ -805,6 +821,8 @@ AlembicProcedural::AlembicProcedural() : Procedural(get_node_type())
 
 AlembicProcedural::~AlembicProcedural()
 {
+  cancel_stream();
+
   ccl::set<Geometry *> geometries_set;
   ccl::set<Object *> objects_set;
   const ccl::set<AlembicObject *> abc_objects_set;
@@ -878,9 +896,18 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     return;
   }
 
+  /* The data read in the background is only valid if nothing but the frame changed. */
+  if (stream_pending && ((socket_modified & ~get_frame_socket()->modified_flag_bit) != 0 ||
+                         objects_modified || need_shader_updates || need_data_updates))
+  {
+    cancel_stream();
+  }
+
   if (!archive.valid() || filepath_is_modified() || layers_is_modified()) {
     Alembic::AbcCoreFactory::IFactory factory;
     factory.setPolicy(Alembic::Abc::ErrorHandler::kQuietNoopPolicy);
+    /* Objects are read from multiple threads. */
+    factory.setOgawaNumStreams(TaskScheduler::max_concurrency());
 
     std::vector<std::string> filenames;
     filenames.emplace_back(filepath.c_str());
@@ -948,6 +975,20 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     }
   }
 
+  if (prefetch_window_is_modified() || use_prefetch_is_modified()) {
+    /* Reload the data for the new frame range. */
+    window_end_frame = window_start_frame - 1.0f;
+
+    for (Node *node : nodes) {
+      AlembicObject *object = static_cast<AlembicObject *>(node);
+      object->data_loaded = false;
+    }
+  }
+
+  if (use_streaming()) {
+    update_stream_window(progress);
+  }
+
   build_caches(progress);
 
   for (Node *node : nodes) {
@@ -959,7 +1000,7 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
 
     /* skip constant objects */
     if (object->is_constant() && !object->is_modified() && !object->need_shader_update &&
-        !scale_is_modified())
+        !object->need_data_update && !scale_is_modified())
     {
       continue;
     }
@@ -978,9 +1019,15 @@ void AlembicProcedural::generate(Scene *scene, Progress &progress)
     }
 
     object->need_shader_update = false;
+    object->need_data_update = false;
     object->clear_modified();
   }
 
+  /* Read the next frames while the current one renders. */
+  if (use_streaming() && !stream_pending && window_end_frame < end_frame) {
+    start_stream();
+  }
+
   clear_modified();
   objects_modified = false;
 }
@@ -1487,66 +1534,113 @@ void AlembicProcedural::walk_hierarchy(
   }
 }
 
+void AlembicProcedural::load_object_data(AlembicObject *object,
+                                         const AlembicObject::LoadSettings &settings,
+                                         CachedData &cached_data,
+                                         const double start_time,
+                                         const double end_time,
+                                         Progress &progress)
+{
+  cached_data.start_time = start_time;
+  cached_data.end_time = end_time;
+
+  if (object->schema_type == AlembicObject::POLY_MESH) {
+    IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
+    IPolyMeshSchema schema = polymesh.getSchema();
+    object->load_data_in_cache(cached_data, settings, schema, progress);
+  }
+  else if (object->schema_type == AlembicObject::CURVES) {
+    ICurves curves(object->iobject, Alembic::Abc::kWrapExisting);
+    const ICurvesSchema schema = curves.getSchema();
+    object->load_data_in_cache(cached_data, settings, schema, progress);
+  }
+  else if (object->schema_type == AlembicObject::POINTS) {
+    IPoints points(object->iobject, Alembic::Abc::kWrapExisting);
+    const IPointsSchema schema = points.getSchema();
+    object->load_data_in_cache(cached_data, settings, schema, progress);
+  }
+  else if (object->schema_type == AlembicObject::SUBD) {
+    ISubD subd_mesh(object->iobject, Alembic::Abc::kWrapExisting);
+    ISubDSchema schema = subd_mesh.getSchema();
+    object->load_data_in_cache(cached_data, settings, schema, progress);
+  }
+}
+
 void AlembicProcedural::build_caches(Progress &progress)
 {
-  size_t memory_used = 0;
+  double first_frame;
+  double last_frame;
 
-  for (Node *node : nodes) {
-    AlembicObject *object = static_cast<AlembicObject *>(node);
+  if (use_streaming()) {
+    first_frame = static_cast<double>(window_start_frame);
+    last_frame = static_cast<double>(window_end_frame);
+  }
+  else if (use_prefetch) {
+    /* Load the data for the entire animation. */
+    first_frame = static_cast<double>(start_frame);
+    last_frame = static_cast<double>(end_frame);
+  }
+  else {
+    /* Load the data for the current frame. */
+    first_frame = static_cast<double>(frame);
+    last_frame = first_frame;
+  }
+
+  const double start_time = (first_frame - frame_offset) / frame_rate;
+  const double end_time = (last_frame - frame_offset + 1) / frame_rate;
+
+  /* Gather the settings here, as the shaders are not safe to access from the threads reading the
+   * data. */
+  vector<AlembicObject::LoadSettings> load_settings(nodes.size());
+  for (size_t i = 0; i < nodes.size(); i++) {
+    AlembicObject *object = static_cast<AlembicObject *>(nodes[i]);
+    load_settings[i] = object->get_load_settings(this);
+  }
+
+  /* Objects are independent from each other, so read them in parallel. */
+  parallel_for(size_t(0), nodes.size(), [&](const size_t i) {
+    AlembicObject *object = static_cast<AlembicObject *>(nodes[i]);
+    const AlembicObject::LoadSettings &settings = load_settings[i];
 
     if (progress.get_cancel()) {
       return;
     }
 
-    if (object->schema_type == AlembicObject::POLY_MESH) {
-      if (!object->has_data_loaded()) {
-        IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
-        IPolyMeshSchema schema = polymesh.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
+    bool need_load = !object->has_data_loaded();
+
+    if (object->schema_type == AlembicObject::CURVES ||
+        object->schema_type == AlembicObject::POINTS)
+    {
+      need_load |= default_radius_is_modified() || object->radius_scale_is_modified();
+    }
+
+    if (need_load) {
+      load_object_data(
+          object, settings, object->get_cached_data(), start_time, end_time, progress);
+
+      /* Only the original Geometry has data. */
+      if (!object->instance_of && !progress.get_cancel()) {
+        object->data_loaded = true;
+        object->need_data_update = true;
       }
-      else if (object->need_shader_update) {
+    }
+    else if (object->need_shader_update) {
+      if (object->schema_type == AlembicObject::POLY_MESH) {
         IPolyMesh polymesh(object->iobject, Alembic::Abc::kWrapExisting);
         const IPolyMeshSchema schema = polymesh.getSchema();
-        read_attributes(this,
-                        object->get_cached_data(),
+        read_attributes(object->get_cached_data(),
                         schema,
                         schema.getUVsParam(),
-                        object->get_requested_attributes(),
+                        settings.requested_attributes,
                         progress);
       }
-    }
-    else if (object->schema_type == AlembicObject::CURVES) {
-      if (!object->has_data_loaded() || default_radius_is_modified() ||
-          object->radius_scale_is_modified())
-      {
-        ICurves curves(object->iobject, Alembic::Abc::kWrapExisting);
-        const ICurvesSchema schema = curves.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
-    }
-    else if (object->schema_type == AlembicObject::POINTS) {
-      if (!object->has_data_loaded() || default_radius_is_modified() ||
-          object->radius_scale_is_modified())
-      {
-        IPoints points(object->iobject, Alembic::Abc::kWrapExisting);
-        const IPointsSchema schema = points.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
-    }
-    else if (object->schema_type == AlembicObject::SUBD) {
-      if (!object->has_data_loaded()) {
-        ISubD subd_mesh(object->iobject, Alembic::Abc::kWrapExisting);
-        ISubDSchema schema = subd_mesh.getSchema();
-        object->load_data_in_cache(object->get_cached_data(), this, schema, progress);
-      }
-      else if (object->need_shader_update) {
+      else if (object->schema_type == AlembicObject::SUBD) {
         ISubD subd_mesh(object->iobject, Alembic::Abc::kWrapExisting);
         const ISubDSchema schema = subd_mesh.getSchema();
-        read_attributes(this,
-                        object->get_cached_data(),
+        read_attributes(object->get_cached_data(),
                         schema,
                         schema.getUVsParam(),
-                        object->get_requested_attributes(),
+                        settings.requested_attributes,
                         progress);
       }
     }
@@ -1554,18 +1648,145 @@ void AlembicProcedural::build_caches(Progress &progress)
     if (scale_is_modified() || object->get_cached_data().transforms.size() == 0) {
       object->setup_transform_cache(object->get_cached_data(), scale);
     }
+  });
 
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  size_t memory_used = 0;
+
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
     memory_used += object->get_cached_data().memory_used();
+  }
+
+  if (use_prefetch && memory_used > get_prefetch_cache_size_in_bytes()) {
+    progress.set_error("Error: Alembic Procedural memory limit reached");
+    return;
+  }
+
+  VLOG_WORK << "AlembicProcedural memory usage : " << string_human_readable_size(memory_used);
+}
+
+void AlembicProcedural::update_stream_window(Progress &progress)
+{
+  if (frame >= window_start_frame && frame <= window_end_frame) {
+    return;
+  }
+
+  if (stream_pending && frame >= stream_start_frame && frame <= stream_end_frame) {
+    stream_pool.wait_work();
 
-    if (use_prefetch) {
-      if (memory_used > get_prefetch_cache_size_in_bytes()) {
-        progress.set_error("Error: Alembic Procedural memory limit reached");
-        return;
+    /* Both windows were in memory while streaming, so count them both against the limit. */
+    size_t memory_used = 0;
+    for (Node *node : nodes) {
+      AlembicObject *object = static_cast<AlembicObject *>(node);
+      memory_used += object->get_cached_data().memory_used();
+      memory_used += object->streamed_data_.memory_used();
+    }
+
+    if (memory_used > get_prefetch_cache_size_in_bytes()) {
+      progress.set_error("Error: Alembic Procedural memory limit reached");
+      cancel_stream();
+      return;
+    }
+
+    stream_pending = false;
+
+    if (!stream_progress.get_cancel()) {
+      for (Node *node : nodes) {
+        AlembicObject *object = static_cast<AlembicObject *>(node);
+
+        if (!object->has_streamed_data) {
+          continue;
+        }
+
+        std::swap(object->cached_data_, object->streamed_data_);
+        object->streamed_data_.clear();
+        object->has_streamed_data = false;
+        object->need_data_update = true;
       }
+
+      window_start_frame = stream_start_frame;
+      window_end_frame = stream_end_frame;
+      return;
     }
   }
 
-  VLOG_WORK << "AlembicProcedural memory usage : " << string_human_readable_size(memory_used);
+  /* The frame was not read in the background, e.g. after seeking, so read it now. */
+  cancel_stream();
+
+  window_start_frame = frame;
+  window_end_frame = min(frame + static_cast<float>(prefetch_window - 1), end_frame);
+
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+    object->data_loaded = false;
+  }
+}
+
+void AlembicProcedural::start_stream()
+{
+  /* The current and the next window are in memory at the same time. The next window is not read
+   * yet, so assume it is as large as the current one. */
+  size_t memory_used = 0;
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+    memory_used += object->get_cached_data().memory_used();
+  }
+
+  if (memory_used * 2 > get_prefetch_cache_size_in_bytes()) {
+    VLOG_WORK << "AlembicProcedural not streaming, the next window may not fit in memory";
+    return;
+  }
+
+  stream_start_frame = window_end_frame + 1.0f;
+  stream_end_frame = min(stream_start_frame + static_cast<float>(prefetch_window - 1), end_frame);
+
+  const double start_time = (static_cast<double>(stream_start_frame) - frame_offset) / frame_rate;
+  const double end_time = (static_cast<double>(stream_end_frame) - frame_offset + 1) / frame_rate;
+
+  stream_progress.reset();
+  stream_pending = true;
+
+  /* Read the objects in parallel. Instances only have transforms, which are set up when the data
+   * is swapped in. Each task owns a copy of the settings, as the objects and shaders may be
+   * modified while the data is read. */
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+
+    if (object->instance_of || object->schema_type == AlembicObject::INVALID) {
+      continue;
+    }
+
+    stream_pool.push([this, object, settings = object->get_load_settings(this), start_time,
+                      end_time]() {
+      load_object_data(
+          object, settings, object->streamed_data_, start_time, end_time, stream_progress);
+      object->has_streamed_data = !stream_progress.get_cancel();
+    });
+  }
+
+  VLOG_WORK << "AlembicProcedural streaming frames " << stream_start_frame << " to "
+            << stream_end_frame;
+}
+
+void AlembicProcedural::cancel_stream()
+{
+  if (!stream_pending) {
+    return;
+  }
+
+  stream_progress.set_cancel("Cancelled");
+  stream_pool.cancel();
+  stream_pending = false;
+
+  for (Node *node : nodes) {
+    AlembicObject *object = static_cast<AlembicObject *>(node);
+    object->streamed_data_.clear();
+    object->has_streamed_data = false;
+  }
 }
 
 CCL_NAMESPACE_END
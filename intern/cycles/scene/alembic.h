@@ -7,6 +7,8 @@
 #include "graph/node.h"
 #include "scene/attribute.h"
 #include "scene/procedural.h"
+#include "util/progress.h"
+#include "util/task.h"
 #include "util/transform.h"
 #include "util/vector.h"
 
@@ -20,7 +22,6 @@ CCL_NAMESPACE_BEGIN
 class AlembicProcedural;
 class Geometry;
 class Object;
-class Progress;
 class Shader;
 
 using MatrixSampleMap = std::map<Alembic::Abc::chrono_t, Alembic::Abc::M44d>;
@@ -273,11 +274,25 @@ template<typename T> class DataStore {
   }
 
  private:
+  /* Entries do not necessarily start at the first sample of the time sampling, as only a window
+   * of frames may be loaded, so look up the entry nearest to the time instead. */
   const TimeIndexPair &get_index_for_time(const double time) const
   {
-    std::pair<size_t, Alembic::Abc::chrono_t> index_pair;
-    index_pair = time_sampling.getNearIndex(time, index_data_map.size());
-    return index_data_map[index_pair.first];
+    typename vector<TimeIndexPair>::const_iterator it = std::lower_bound(
+        index_data_map.begin(),
+        index_data_map.end(),
+        time,
+        [](const TimeIndexPair &pair, const double value) { return pair.time < value; });
+
+    if (it == index_data_map.end()) {
+      return index_data_map.back();
+    }
+
+    if (it != index_data_map.begin() && (time - (it - 1)->time) < (it->time - time)) {
+      --it;
+    }
+
+    return *it;
   }
 };
 
@@ -286,6 +301,10 @@ template<typename T> class DataStore {
  * inside of DataStores.
  */
 struct CachedData {
+  /* Time range in seconds to load data for, set before loading. */
+  double start_time = 0.0;
+  double end_time = 0.0;
+
   DataStore<Transform> transforms{};
 
   /* mesh data */
@@ -384,20 +403,32 @@ class AlembicObject : public Node {
   void set_object(Object *object);
   Object *get_object();
 
+  /* Settings used to load the data, copied from the sockets and the shaders before loading so
+   * that worker threads never access them while the scene is synchronized. */
+  struct LoadSettings {
+    AttributeRequestSet requested_attributes;
+    vector<ustring> shader_names;
+    float default_radius = 0.0f;
+    float radius_scale = 1.0f;
+    bool ignore_subdivision = false;
+  };
+
+  LoadSettings get_load_settings(const AlembicProcedural *proc);
+
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const LoadSettings &settings,
                           Alembic::AbcGeom::IPolyMeshSchema &schema,
                           Progress &progress);
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const LoadSettings &settings,
                           Alembic::AbcGeom::ISubDSchema &schema,
                           Progress &progress);
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const LoadSettings &settings,
                           const Alembic::AbcGeom::ICurvesSchema &schema,
                           Progress &progress);
   void load_data_in_cache(CachedData &cached_data,
-                          AlembicProcedural *proc,
+                          const LoadSettings &settings,
                           const Alembic::AbcGeom::IPointsSchema &schema,
                           Progress &progress);
 
@@ -443,8 +474,16 @@ class AlembicObject : public Node {
 
   bool data_loaded = false;
 
+  /* Set when the cached data was replaced, so that the data is passed to the sockets again even if
+   * it is constant. */
+  bool need_data_update = false;
+
   CachedData cached_data_;
 
+  /* Data for the next window of frames, read in the background while streaming. */
+  CachedData streamed_data_;
+  bool has_streamed_data = false;
+
   void setup_transform_cache(CachedData &cached_data, const float scale);
 
   AttributeRequestSet get_requested_attributes();
@@ -458,6 +497,10 @@ class AlembicObject : public Node {
  * This procedural will load the data set for the entire animation in memory on the first frame,
  * and directly set the data for the new frames on the created Nodes if needed. This allows for
  * faster updates between frames as it avoids reseeking the data on disk.
+ *
+ * For animations too large to fit in memory, a window of frames can be set instead. Only the
+ * data for the window of the current frame is kept in memory, while the data for the next window
+ * is read on worker threads during rendering.
  */
 class AlembicProcedural : public Procedural {
   Alembic::AbcGeom::IArchive archive;
@@ -465,6 +508,17 @@ class AlembicProcedural : public Procedural {
   bool objects_modified = false;
   Scene *scene_ = nullptr;
 
+  /* Frames of the window whose data is in the objects' caches. */
+  float window_start_frame = 0.0f;
+  float window_end_frame = -1.0f;
+
+  /* Frames of the window being read in the background. */
+  float stream_start_frame = 0.0f;
+  float stream_end_frame = -1.0f;
+  bool stream_pending = false;
+  TaskPool stream_pool;
+  Progress stream_progress;
+
  public:
   NODE_DECLARE
 
@@ -505,6 +559,10 @@ class AlembicProcedural : public Procedural {
    */
   NODE_SOCKET_API(int, prefetch_cache_size)
 
+  /* Number of frames to keep in memory around the current frame, while the next frames are read
+   * in the background. When zero, the data for the entire animation is loaded at once. */
+  NODE_SOCKET_API(int, prefetch_window)
+
   AlembicProcedural();
   ~AlembicProcedural() override;
 
@@ -556,6 +614,29 @@ class AlembicProcedural : public Procedural {
 
   void build_caches(Progress &progress);
 
+  /* Load the data of the object for the given time range in seconds. */
+  void load_object_data(AlembicObject *object,
+                        const AlembicObject::LoadSettings &settings,
+                        CachedData &cached_data,
+                        const double start_time,
+                        const double end_time,
+                        Progress &progress);
+
+  bool use_streaming() const
+  {
+    return use_prefetch && prefetch_window > 0;
+  }
+
+  /* Make the caches hold the window of the current frame, either by taking the data read in the
+   * background, or by invalidating the caches so the data is read again. */
+  void update_stream_window(Progress &progress);
+
+  /* Start reading the data for the window following the current one on worker threads. */
+  void start_stream();
+
+  /* Stop reading data in the background and discard what was read. */
+  void cancel_stream();
+
   size_t get_prefetch_cache_size_in_bytes() const
   {
     /* prefetch_cache_size is in megabytes, so convert to bytes. */
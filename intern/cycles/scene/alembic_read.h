@@ -13,7 +13,6 @@
 
 CCL_NAMESPACE_BEGIN
 
-class AlembicProcedural;
 class AttributeRequestSet;
 class Progress;
 struct CachedData;
@@ -43,8 +42,7 @@ struct PolyMeshSchemaData {
   Alembic::AbcGeom::IV3fArrayProperty velocities;
 };
 
-void read_geometry_data(AlembicProcedural *proc,
-                        CachedData &cached_data,
+void read_geometry_data(CachedData &cached_data,
                         const PolyMeshSchemaData &data,
                         Progress &progress);
 
@@ -76,10 +74,7 @@ struct SubDSchemaData {
   Alembic::AbcGeom::IV3fArrayProperty velocities;
 };
 
-void read_geometry_data(AlembicProcedural *proc,
-                        CachedData &cached_data,
-                        const SubDSchemaData &data,
-                        Progress &progress);
+void read_geometry_data(CachedData &cached_data, const SubDSchemaData &data, Progress &progress);
 
 /* Data of a ICurvesSchema that we need to read. */
 struct CurvesSchemaData {
@@ -106,10 +101,7 @@ struct CurvesSchemaData {
   // TODO(@kevindietrich): type, basis, wrap
 };
 
-void read_geometry_data(AlembicProcedural *proc,
-                        CachedData &cached_data,
-                        const CurvesSchemaData &data,
-                        Progress &progress);
+void read_geometry_data(CachedData &cached_data, const CurvesSchemaData &data, Progress &progress);
 
 /* Data of a IPointsSchema that we need to read. */
 struct PointsSchemaData {
@@ -126,13 +118,9 @@ struct PointsSchemaData {
   Alembic::AbcGeom::IV3fArrayProperty velocities;
 };
 
-void read_geometry_data(AlembicProcedural *proc,
-                        CachedData &cached_data,
-                        const PointsSchemaData &data,
-                        Progress &progress);
+void read_geometry_data(CachedData &cached_data, const PointsSchemaData &data, Progress &progress);
 
-void read_attributes(AlembicProcedural *proc,
-                     CachedData &cache,
+void read_attributes(CachedData &cache,
                      const Alembic::AbcGeom::ICompoundProperty &arb_geom_params,
                      const Alembic::AbcGeom::IV2fGeomParam &default_uvs_param,
                      const AttributeRequestSet &requested_attributes,
@@ -20,6 +20,7 @@ DeviceScene::DeviceScene(Device *device)
       tri_verts(device, "tri_verts", MEM_GLOBAL),
       tri_shader(device, "tri_shader", MEM_GLOBAL),
       tri_vnormal(device, "tri_vnormal", MEM_GLOBAL),
+      tri_vnormal_packed(device, "tri_vnormal_packed", MEM_GLOBAL),
       tri_vindex(device, "tri_vindex", MEM_GLOBAL),
       tri_patch(device, "tri_patch", MEM_GLOBAL),
       tri_patch_uv(device, "tri_patch_uv", MEM_GLOBAL),
@@ -39,6 +40,7 @@ DeviceScene::DeviceScene(Device *device)
       attributes_map(device, "attributes_map", MEM_GLOBAL),
       attributes_float(device, "attributes_float", MEM_GLOBAL),
       attributes_float2(device, "attributes_float2", MEM_GLOBAL),
+      attributes_half2(device, "attributes_half2", MEM_GLOBAL),
       attributes_float3(device, "attributes_float3", MEM_GLOBAL),
       attributes_float4(device, "attributes_float4", MEM_GLOBAL),
       attributes_uchar4(device, "attributes_uchar4", MEM_GLOBAL),
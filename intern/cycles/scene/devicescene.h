@@ -27,6 +27,7 @@ class DeviceScene {
   device_vector<packed_float3> tri_verts;
   device_vector<uint> tri_shader;
   device_vector<packed_float3> tri_vnormal;
+  device_vector<uint> tri_vnormal_packed;
   device_vector<packed_uint3> tri_vindex;
   device_vector<uint> tri_patch;
   device_vector<float2> tri_patch_uv;
@@ -56,6 +57,7 @@ class DeviceScene {
   device_vector<AttributeMap> attributes_map;
   device_vector<float> attributes_float;
   device_vector<float2> attributes_float2;
+  device_vector<uint> attributes_half2;
   device_vector<packed_float3> attributes_float3;
   device_vector<float4> attributes_float4;
   device_vector<uchar4> attributes_uchar4;
@@ -511,6 +511,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     if (device_update_flags & DEVICE_MESH_DATA_NEEDS_REALLOC) {
       dscene->tri_verts.tag_realloc();
       dscene->tri_vnormal.tag_realloc();
+      dscene->tri_vnormal_packed.tag_realloc();
       dscene->tri_vindex.tag_realloc();
       dscene->tri_patch.tag_realloc();
       dscene->tri_patch_uv.tag_realloc();
@@ -538,55 +539,30 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT_MODIFIED) {
-    dscene->attributes_float.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT2_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float2.tag_realloc();
-  }
-  else if (device_update_flags & ATTR_FLOAT2_MODIFIED) {
-    dscene->attributes_float2.tag_modified();
+    dscene->attributes_half2.tag_realloc();
   }
 
   if (device_update_flags & ATTR_FLOAT3_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float3.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT3_MODIFIED) {
-    dscene->attributes_float3.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT4_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float4.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT4_MODIFIED) {
-    dscene->attributes_float4.tag_modified();
-  }
 
   if (device_update_flags & ATTR_UCHAR4_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_uchar4.tag_realloc();
   }
-  else if (device_update_flags & ATTR_UCHAR4_MODIFIED) {
-    dscene->attributes_uchar4.tag_modified();
-  }
-
-  if (device_update_flags & DEVICE_MESH_DATA_MODIFIED) {
-    /* if anything else than vertices or shaders are modified, we would need to reallocate, so
-     * these are the only arrays that can be updated */
-    dscene->tri_verts.tag_modified();
-    dscene->tri_vnormal.tag_modified();
-    dscene->tri_shader.tag_modified();
-  }
 
-  if (device_update_flags & DEVICE_CURVE_DATA_MODIFIED) {
-    dscene->curve_keys.tag_modified();
-    dscene->curves.tag_modified();
-    dscene->curve_segments.tag_modified();
-  }
+  /* Modified attributes, meshes and curves are tagged as modified ranges while packing them, so
+   * that only those ranges are copied to the device. */
 
   if (device_update_flags & DEVICE_POINT_DATA_MODIFIED) {
     dscene->points.tag_modified();
@@ -840,6 +816,7 @@ void GeometryManager::device_update(Device *device,
   const BVHLayout bvh_layout = BVHParams::best_bvh_layout(
       scene->params.bvh_layout, device->get_bvh_layout_mask(dscene->data.kernel_features));
   geom_calc_offset(scene, bvh_layout);
+  dscene->data.bvh.use_compact_geometry = scene->params.use_compact_geometry;
   if (true_displacement_used || curve_shadow_transparency_used) {
     const scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
@@ -1053,6 +1030,7 @@ void GeometryManager::device_update(Device *device,
   dscene->tri_vindex.clear_modified();
   dscene->tri_patch.clear_modified();
   dscene->tri_vnormal.clear_modified();
+  dscene->tri_vnormal_packed.clear_modified();
   dscene->tri_patch_uv.clear_modified();
   dscene->curves.clear_modified();
   dscene->curve_keys.clear_modified();
@@ -1063,6 +1041,7 @@ void GeometryManager::device_update(Device *device,
   dscene->attributes_map.clear_modified();
   dscene->attributes_float.clear_modified();
   dscene->attributes_float2.clear_modified();
+  dscene->attributes_half2.clear_modified();
   dscene->attributes_float3.clear_modified();
   dscene->attributes_float4.clear_modified();
   dscene->attributes_uchar4.clear_modified();
@@ -1081,6 +1060,7 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene, bool forc
   dscene->tri_verts.free_if_need_realloc(force_free);
   dscene->tri_shader.free_if_need_realloc(force_free);
   dscene->tri_vnormal.free_if_need_realloc(force_free);
+  dscene->tri_vnormal_packed.free_if_need_realloc(force_free);
   dscene->tri_vindex.free_if_need_realloc(force_free);
   dscene->tri_patch.free_if_need_realloc(force_free);
   dscene->tri_patch_uv.free_if_need_realloc(force_free);
@@ -1093,6 +1073,7 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene, bool forc
   dscene->attributes_map.free_if_need_realloc(force_free);
   dscene->attributes_float.free_if_need_realloc(force_free);
   dscene->attributes_float2.free_if_need_realloc(force_free);
+  dscene->attributes_half2.free_if_need_realloc(force_free);
   dscene->attributes_float3.free_if_need_realloc(force_free);
   dscene->attributes_float4.free_if_need_realloc(force_free);
   dscene->attributes_uchar4.free_if_need_realloc(force_free);
@@ -19,7 +19,9 @@
 
 #include "subd/split.h"
 
+#include "util/half.h"
 #include "util/progress.h"
+#include "util/set.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -288,7 +290,22 @@ template<typename T> struct AttributeTableEntry {
       for (size_t k = 0; k < attr_size; k++) {
         data[offset + k] = attr_data[k];
       }
-      data.tag_modified();
+      data.tag_modified(offset, attr_size);
+    }
+    offset += attr_size;
+    return start_offset;
+  }
+
+  /* Store float2 values as two packed half floats. */
+  size_t add_half2(const float2 *attr_data, const size_t attr_size, const bool modified)
+  {
+    assert(data.size() >= offset + attr_size);
+    size_t start_offset = offset;
+    if (modified) {
+      for (size_t k = 0; k < attr_size; k++) {
+        data[offset + k] = float2_to_half2_packed(attr_data[k]);
+      }
+      data.tag_modified(offset, attr_size);
     }
     offset += attr_size;
     return start_offset;
@@ -300,23 +317,57 @@ template<typename T> struct AttributeTableEntry {
   }
 };
 
+/* With compact geometry, only UV maps within the unit square are stored at half precision, where
+ * the error is at most 2^-12. Other float2 attributes can hold arbitrary values that would lose
+ * too much precision or not be representable at all. */
+static bool attribute_use_half2(Geometry *geom, const Attribute *mattr, AttributePrimitive prim)
+{
+  if (mattr->std != ATTR_STD_UV) {
+    return false;
+  }
+  const float2 *data = mattr->data_float2();
+  const size_t size = mattr->element_size(geom, prim);
+  for (size_t i = 0; i < size; i++) {
+    if (!(data[i].x >= 0.0f && data[i].x <= 1.0f && data[i].y >= 0.0f && data[i].y <= 1.0f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 class AttributeTableBuilder {
  public:
-  AttributeTableBuilder(DeviceScene *dscene)
+  AttributeTableBuilder(DeviceScene *dscene, const bool use_half2)
       : attr_float{dscene->attributes_float, 0, 0},
         attr_float2{dscene->attributes_float2, 0, 0},
+        attr_half2{dscene->attributes_half2, 0, 0},
         attr_float3{dscene->attributes_float3, 0, 0},
         attr_float4{dscene->attributes_float4, 0, 0},
-        attr_uchar4{dscene->attributes_uchar4, 0, 0}
+        attr_uchar4{dscene->attributes_uchar4, 0, 0},
+        use_half2(use_half2)
   {
   }
 
   AttributeTableEntry<float> attr_float;
   AttributeTableEntry<float2> attr_float2;
+  AttributeTableEntry<uint> attr_half2;
   AttributeTableEntry<packed_float3> attr_float3;
   AttributeTableEntry<float4> attr_float4;
   AttributeTableEntry<uchar4> attr_uchar4;
 
+  /* Store UV maps at half precision where possible, for compact geometry storage. */
+  bool use_half2;
+  /* Float2 attributes stored at half precision, decided when reserving space. */
+  unordered_set<const Attribute *> half2_attributes;
+
+  /* Whether float2 attributes moved between the full and half precision arrays, because their
+   * values changed range. Then the offsets of all of them change and they have to be copied. */
+  bool float2_storage_resized() const
+  {
+    return attr_float2.size != attr_float2.data.size() ||
+           attr_half2.size != attr_half2.data.size();
+  }
+
   void add(Geometry *geom,
            Attribute *mattr,
            AttributePrimitive prim,
@@ -353,7 +404,13 @@ class AttributeTableBuilder {
       offset = attr_float.add(mattr->data_float(), size, mattr->modified);
     }
     else if (mattr->type == TypeFloat2) {
-      offset = attr_float2.add(mattr->data_float2(), size, mattr->modified);
+      if (half2_attributes.count(mattr)) {
+        offset = attr_half2.add_half2(mattr->data_float2(), size, mattr->modified);
+        desc.flags |= ATTR_HALF_PRECISION;
+      }
+      else {
+        offset = attr_float2.add(mattr->data_float2(), size, mattr->modified);
+      }
     }
     else if (mattr->type == TypeMatrix) {
       offset = attr_float4.add((float4 *)mattr->data_transform(), size * 3, mattr->modified);
@@ -438,7 +495,16 @@ class AttributeTableBuilder {
       attr_float.reserve(size);
     }
     else if (mattr->type == TypeFloat2) {
-      attr_float2.reserve(size);
+      if (use_half2 && !half2_attributes.count(mattr) && attribute_use_half2(geom, mattr, prim))
+      {
+        half2_attributes.insert(mattr);
+      }
+      if (half2_attributes.count(mattr)) {
+        attr_half2.reserve(size);
+      }
+      else {
+        attr_float2.reserve(size);
+      }
     }
     else if (mattr->type == TypeMatrix) {
       attr_float4.reserve(size * 3);
@@ -455,6 +521,7 @@ class AttributeTableBuilder {
   {
     attr_float.alloc();
     attr_float2.alloc();
+    attr_half2.alloc();
     attr_float3.alloc();
     attr_float4.alloc();
     attr_uchar4.alloc();
@@ -464,6 +531,7 @@ class AttributeTableBuilder {
   {
     attr_float.data.copy_to_device_if_modified();
     attr_float2.data.copy_to_device_if_modified();
+    attr_half2.data.copy_to_device_if_modified();
     attr_float3.data.copy_to_device_if_modified();
     attr_float4.data.copy_to_device_if_modified();
     attr_uchar4.data.copy_to_device_if_modified();
@@ -538,7 +606,7 @@ void GeometryManager::device_update_attributes(Device *device,
   /* Pre-allocate attributes to avoid arrays re-allocation which would
    * take 2x of overall attribute memory usage.
    */
-  AttributeTableBuilder builder(dscene);
+  AttributeTableBuilder builder(dscene, scene->params.use_compact_geometry);
 
   for (size_t i = 0; i < scene->geometry.size(); i++) {
     Geometry *geom = scene->geometry[i];
@@ -565,12 +633,14 @@ void GeometryManager::device_update_attributes(Device *device,
     }
   }
 
+  const bool float2_storage_resized = builder.float2_storage_resized();
   builder.alloc();
 
   /* The order of those flags needs to match that of AttrKernelDataType. */
   const bool attributes_need_realloc[AttrKernelDataType::NUM] = {
       dscene->attributes_float.need_realloc(),
-      dscene->attributes_float2.need_realloc(),
+      dscene->attributes_float2.need_realloc() || dscene->attributes_half2.need_realloc() ||
+          float2_storage_resized,
       dscene->attributes_float3.need_realloc(),
       dscene->attributes_float4.need_realloc(),
       dscene->attributes_uchar4.need_realloc(),
@@ -81,6 +81,8 @@ void Geometry::compute_bvh(Device *device,
       bparams.num_motion_point_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
+      bparams.cache_directory = params->bvh_cache_directory;
+      bparams.cache_size = size_t(params->bvh_cache_size) * 1024 * 1024;
 
       bvh = BVH::create(bparams, geometry, objects, device);
       MEM_GUARDED_CALL(progress, device->build_bvh, bvh.get(), *progress, false);
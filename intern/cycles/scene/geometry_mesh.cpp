@@ -79,9 +79,15 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
+    /* Vertex normals are stored in only one of the arrays, depending on the layout. */
+    const bool use_compact_geometry = scene->params.use_compact_geometry;
+    const size_t vnormal_size = (use_compact_geometry) ? 0 : vert_size;
+    const size_t vnormal_packed_size = (use_compact_geometry) ? vert_size : 0;
+
     packed_float3 *tri_verts = dscene->tri_verts.alloc(vert_size);
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
-    packed_float3 *vnormal = dscene->tri_vnormal.alloc(vert_size);
+    packed_float3 *vnormal = dscene->tri_vnormal.alloc(vnormal_size);
+    uint *vnormal_packed = dscene->tri_vnormal_packed.alloc(vnormal_packed_size);
     packed_uint3 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
@@ -89,21 +95,34 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
     const bool copy_all_data = dscene->tri_shader.need_realloc() ||
                                dscene->tri_vindex.need_realloc() ||
                                dscene->tri_vnormal.need_realloc() ||
+                               dscene->tri_vnormal_packed.need_realloc() ||
                                dscene->tri_patch.need_realloc() ||
                                dscene->tri_patch_uv.need_realloc();
 
+    /* Only the ranges of modified meshes are copied to the device, unless the arrays were
+     * reallocated. */
     for (Geometry *geom : scene->geometry) {
       if (geom->is_mesh() || geom->is_volume()) {
         Mesh *mesh = static_cast<Mesh *>(geom);
+        const size_t num_verts = mesh->verts.size();
+        const size_t num_triangles = mesh->num_triangles();
 
         if (mesh->shader_is_modified() || mesh->smooth_is_modified() ||
             mesh->triangles_is_modified() || copy_all_data)
         {
           mesh->pack_shaders(scene, &tri_shader[mesh->prim_offset]);
+          dscene->tri_shader.tag_modified(mesh->prim_offset, num_triangles);
         }
 
         if (mesh->verts_is_modified() || copy_all_data) {
-          mesh->pack_normals(&vnormal[mesh->vert_offset]);
+          if (use_compact_geometry) {
+            mesh->pack_normals(&vnormal_packed[mesh->vert_offset]);
+            dscene->tri_vnormal_packed.tag_modified(mesh->vert_offset, num_verts);
+          }
+          else {
+            mesh->pack_normals(&vnormal[mesh->vert_offset]);
+            dscene->tri_vnormal.tag_modified(mesh->vert_offset, num_verts);
+          }
         }
 
         if (mesh->verts_is_modified() || mesh->triangles_is_modified() ||
@@ -113,6 +132,10 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
                            &tri_vindex[mesh->prim_offset],
                            &tri_patch[mesh->prim_offset],
                            &tri_patch_uv[mesh->vert_offset]);
+          dscene->tri_verts.tag_modified(mesh->vert_offset, num_verts);
+          dscene->tri_vindex.tag_modified(mesh->prim_offset, num_triangles);
+          dscene->tri_patch.tag_modified(mesh->prim_offset, num_triangles);
+          dscene->tri_patch_uv.tag_modified(mesh->vert_offset, num_verts);
         }
 
         if (progress.get_cancel()) {
@@ -127,6 +150,7 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
     dscene->tri_verts.copy_to_device_if_modified();
     dscene->tri_shader.copy_to_device_if_modified();
     dscene->tri_vnormal.copy_to_device_if_modified();
+    dscene->tri_vnormal_packed.copy_to_device_if_modified();
     dscene->tri_vindex.copy_to_device_if_modified();
     dscene->tri_patch.copy_to_device_if_modified();
     dscene->tri_patch_uv.copy_to_device_if_modified();
@@ -160,6 +184,9 @@ void GeometryManager::device_update_mesh(Device * /*unused*/,
                           &curve_keys[hair->curve_key_offset],
                           &curves[hair->prim_offset],
                           &curve_segments[hair->curve_segment_offset]);
+        dscene->curve_keys.tag_modified(hair->curve_key_offset, hair->get_curve_keys().size());
+        dscene->curves.tag_modified(hair->prim_offset, hair->num_curves());
+        dscene->curve_segments.tag_modified(hair->curve_segment_offset, hair->num_segments());
         if (progress.get_cancel()) {
           return;
         }
@@ -5,6 +5,7 @@
 #include "scene/image.h"
 #include "device/device.h"
 #include "scene/colorspace.h"
+#include "scene/image_cache.h"
 #include "scene/image_oiio.h"
 #include "scene/image_vdb.h"
 #include "scene/scene.h"
@@ -52,6 +53,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_fpn";
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
       return "nanovdb_fp16";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -305,7 +308,7 @@ bool ImageLoader::is_vdb_loader() const
 
 /* Image Manager */
 
-ImageManager::ImageManager(const DeviceInfo &info)
+ImageManager::ImageManager(const DeviceInfo &info, const int texture_cache_size)
 {
   need_update_ = true;
   osl_texture_system = nullptr;
@@ -313,6 +316,11 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+
+  /* Texture cache lookups call into OIIO from the kernel, which only works on the CPU. */
+  if (texture_cache_size > 0 && info.type == DEVICE_CPU) {
+    texture_cache = make_unique<ImageTextureCache>(texture_cache_size);
+  }
 }
 
 ImageManager::~ImageManager()
@@ -327,6 +335,11 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+bool ImageManager::use_texture_cache() const
+{
+  return texture_cache != nullptr;
+}
+
 bool ImageManager::set_animation_frame_update(const int frame)
 {
   if (frame != animation_frame) {
@@ -693,6 +706,57 @@ bool ImageManager::file_load_image(Image *img, const int texture_limit)
   return true;
 }
 
+bool ImageManager::texture_cache_load_image(Device *device, Image *img, const size_t slot)
+{
+  if (!texture_cache || img->builtin) {
+    return false;
+  }
+
+  /* Only files can be looked up in the cache. */
+  const ustring filepath = img->loader->osl_filepath();
+  if (filepath.empty()) {
+    return false;
+  }
+
+  /* Color space conversion and alpha other than associated are handled while loading pixels,
+   * which the cache doesn't do. sRGB is converted in the kernel. */
+  const ImageMetaData &metadata = img->metadata;
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels >= 4);
+  if (metadata.channels <= 0 || metadata.depth > 1 ||
+      (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) ||
+      (has_alpha && !image_associate_alpha(img)))
+  {
+    return false;
+  }
+
+  TextureCacheHandle handle;
+  if (!texture_cache->get_handle(filepath, metadata.channels, handle)) {
+    return false;
+  }
+
+  img->mem_name = string_printf(
+      "tex_image_%s_%03d", name_from_type(IMAGE_DATA_TYPE_TEXTURE_CACHE), (int)slot);
+
+  const thread_scoped_lock device_lock(device_mutex);
+  img->mem = make_unique<device_texture>(device,
+                                         img->mem_name.c_str(),
+                                         slot,
+                                         IMAGE_DATA_TYPE_TEXTURE_CACHE,
+                                         img->params.interpolation,
+                                         img->params.extension);
+  void *data = img->mem->alloc(sizeof(TextureCacheHandle), 0);
+  if (data == nullptr) {
+    img->mem.reset();
+    return false;
+  }
+  memcpy(data, &handle, sizeof(TextureCacheHandle));
+  /* Keep the actual resolution for anything that might query it. */
+  img->mem->info.width = metadata.width;
+  img->mem->info.height = metadata.height;
+  img->mem->copy_to_device();
+  return true;
+}
+
 void ImageManager::device_load_image(Device *device,
                                      Scene *scene,
                                      const size_t slot,
@@ -709,10 +773,6 @@ void ImageManager::device_load_image(Device *device,
   const int texture_limit = scene->params.texture_limit;
 
   load_image_metadata(img);
-  const ImageDataType type = img->metadata.type;
-
-  /* Name for debugging. */
-  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
 
   /* Free previous texture in slot. */
   if (img->mem) {
@@ -720,6 +780,17 @@ void ImageManager::device_load_image(Device *device,
     img->mem.reset();
   }
 
+  if (texture_cache_load_image(device, img, slot)) {
+    img->loader->cleanup();
+    img->need_load = false;
+    return;
+  }
+
+  const ImageDataType type = img->metadata.type;
+
+  /* Name for debugging. */
+  img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
+
   img->mem = make_unique<device_texture>(
       device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
   img->mem->info.use_transform_3d = img->metadata.use_transform_3d;
@@ -849,6 +920,13 @@ void ImageManager::device_free_image(Device * /*unused*/, size_t slot)
 #endif
   }
 
+  if (texture_cache) {
+    const ustring filepath = img->loader->osl_filepath();
+    if (!filepath.empty()) {
+      texture_cache->invalidate(filepath);
+    }
+  }
+
   if (img->mem) {
     const thread_scoped_lock device_lock(device_mutex);
     img->mem.reset();
@@ -22,6 +22,7 @@ class ImageHandle;
 class ImageKey;
 class ImageMetaData;
 class ImageManager;
+class ImageTextureCache;
 class Progress;
 class RenderStats;
 class Scene;
@@ -162,7 +163,7 @@ class ImageHandle {
  * texture images and 3D volume images. */
 class ImageManager {
  public:
-  explicit ImageManager(const DeviceInfo &info);
+  explicit ImageManager(const DeviceInfo &info, const int texture_cache_size = 0);
   ~ImageManager();
 
   ImageHandle add_image(const string &filename, const ImageParams &params);
@@ -182,6 +183,9 @@ class ImageManager {
   void device_free_builtin(Device *device);
 
   void set_osl_texture_system(void *texture_system);
+
+  /* Image files are looked up through a texture cache instead of being fully loaded. */
+  bool use_texture_cache() const;
   bool set_animation_frame_update(const int frame);
 
   void collect_statistics(RenderStats *stats);
@@ -218,6 +222,7 @@ class ImageManager {
 
   vector<unique_ptr<Image>> images;
   void *osl_texture_system;
+  unique_ptr<ImageTextureCache> texture_cache;
 
   size_t add_image_slot(unique_ptr<ImageLoader> &&loader,
                         const ImageParams &params,
@@ -231,6 +236,8 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, const int texture_limit);
 
+  bool texture_cache_load_image(Device *device, Image *img, const size_t slot);
+
   void device_load_image(Device *device, Scene *scene, const size_t slot, Progress &progress);
   void device_free_image(Device *device, const size_t slot);
 
@@ -0,0 +1,142 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/image_cache.h"
+
+#include "util/log.h"
+
+CCL_NAMESPACE_BEGIN
+
+static OIIO::Tex::Wrap texture_cache_wrap_mode(const ExtensionType extension)
+{
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      return OIIO::Tex::Wrap::Periodic;
+    case EXTENSION_EXTEND:
+      return OIIO::Tex::Wrap::Clamp;
+    case EXTENSION_MIRROR:
+      return OIIO::Tex::Wrap::Mirror;
+    case EXTENSION_CLIP:
+    case EXTENSION_NUM_TYPES:
+      break;
+  }
+  return OIIO::Tex::Wrap::Black;
+}
+
+static OIIO::Tex::InterpMode texture_cache_interp_mode(const InterpolationType interpolation)
+{
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      return OIIO::Tex::InterpMode::Closest;
+    case INTERPOLATION_CUBIC:
+      return OIIO::Tex::InterpMode::Bicubic;
+    case INTERPOLATION_SMART:
+      return OIIO::Tex::InterpMode::SmartBicubic;
+    case INTERPOLATION_NONE:
+    case INTERPOLATION_LINEAR:
+    case INTERPOLATION_NUM_TYPES:
+      break;
+  }
+  return OIIO::Tex::InterpMode::Bilinear;
+}
+
+static float4 texture_cache_lookup(const TextureCacheHandle &handle,
+                                   const TextureInfo &info,
+                                   const float x,
+                                   const float y,
+                                   const float2 dx,
+                                   const float2 dy)
+{
+  OIIO::TextureSystem *texture_system = static_cast<OIIO::TextureSystem *>(
+      handle.texture_system);
+
+  OIIO::TextureOpt options;
+  const OIIO::Tex::Wrap wrap = texture_cache_wrap_mode(ExtensionType(info.extension));
+  options.swrap = static_cast<decltype(options.swrap)>(wrap);
+  options.twrap = static_cast<decltype(options.twrap)>(wrap);
+  options.interpmode = static_cast<decltype(options.interpmode)>(
+      texture_cache_interp_mode(InterpolationType(info.interpolation)));
+
+  /* Images are stored bottom to top in Cycles, texture lookups go from top to bottom. */
+  float result[4];
+  if (!texture_system->texture(
+          static_cast<OIIO::TextureSystem::TextureHandle *>(handle.texture_handle),
+          nullptr,
+          options,
+          x,
+          1.0f - y,
+          dx.x,
+          -dx.y,
+          dy.x,
+          -dy.y,
+          handle.channels,
+          result))
+  {
+    /* Clear the error, it would accumulate otherwise. */
+    (void)texture_system->geterror();
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  /* Expand to RGBA in the same way as images that are fully loaded. */
+  switch (handle.channels) {
+    case 1:
+      return make_float4(result[0], result[0], result[0], 1.0f);
+    case 2:
+      return make_float4(result[0], result[0], result[0], result[1]);
+    case 3:
+      return make_float4(result[0], result[1], result[2], 1.0f);
+    default:
+      return make_float4(result[0], result[1], result[2], result[3]);
+  }
+}
+
+ImageTextureCache::ImageTextureCache(const int max_memory_mb)
+{
+#if OIIO_VERSION_MAJOR >= 3
+  texture_system = OIIO::TextureSystem::create(false);
+#else
+  texture_system = std::shared_ptr<OIIO::TextureSystem>(OIIO::TextureSystem::create(false),
+                                                        OIIO::TextureSystem::destroy);
+#endif
+
+  /* Tile and mip-map files that are not stored that way on the fly, so that they can still be
+   * used. Pre-processed `.tx` or tiled EXR files are much more efficient though. */
+  texture_system->attribute("automip", 1);
+  texture_system->attribute("autotile", 64);
+  texture_system->attribute("max_memory_MB", float(max_memory_mb));
+
+  VLOG_INFO << "Using image texture cache of " << max_memory_mb << " MB.";
+}
+
+ImageTextureCache::~ImageTextureCache()
+{
+  VLOG_INFO << "Image texture cache statistics:\n" << texture_system->getstats(1);
+}
+
+bool ImageTextureCache::get_handle(const ustring &filepath,
+                                   const int channels,
+                                   TextureCacheHandle &handle)
+{
+  OIIO::TextureSystem::TextureHandle *texture_handle = texture_system->get_texture_handle(
+      filepath);
+  if (texture_handle == nullptr || !texture_system->good(texture_handle)) {
+    VLOG_WARNING << "Failed to open " << filepath << " through texture cache: "
+                 << texture_system->geterror();
+    return false;
+  }
+
+  handle.texture_system = texture_system.get();
+  handle.texture_handle = texture_handle;
+  handle.channels = min(channels, 4);
+  handle.lookup = texture_cache_lookup;
+  return true;
+}
+
+void ImageTextureCache::invalidate(const ustring &filepath)
+{
+  texture_system->invalidate(filepath);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,37 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <memory>
+
+#include <OpenImageIO/texture.h>
+
+#include "util/param.h"
+#include "util/texture.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Image Texture Cache
+ *
+ * Looks up image files through an OpenImageIO texture system, which loads tiles of the needed
+ * mip levels on demand and keeps at most a fixed amount of them in memory. This way scenes with
+ * more texture data than fits in memory can be rendered on the CPU. */
+class ImageTextureCache {
+ public:
+  explicit ImageTextureCache(const int max_memory_mb);
+  ~ImageTextureCache();
+
+  /* Fill in the handle to look up the file in the kernel. Returns false if the file can't be
+   * read as texture. */
+  bool get_handle(const ustring &filepath, const int channels, TextureCacheHandle &handle);
+
+  /* Forget cached tiles of the file, in case it changed on disk. */
+  void invalidate(const ustring &filepath);
+
+ private:
+  std::shared_ptr<OIIO::TextureSystem> texture_system;
+};
+
+CCL_NAMESPACE_END
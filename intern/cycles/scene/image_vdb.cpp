@@ -4,8 +4,14 @@
 
 #include "scene/image_vdb.h"
 
+#include "util/list.h"
 #include "util/log.h"
+#include "util/map.h"
+#include "util/md5.h"
 #include "util/openvdb.h"
+#include "util/path.h"
+#include "util/thread.h"
+#include "util/time.h"
 
 #ifdef WITH_OPENVDB
 #  include <openvdb/tools/Dense.h>
@@ -134,6 +140,205 @@ VDBImageLoader::VDBImageLoader(openvdb::GridBase::ConstPtr grid_, const string &
 }
 #endif
 
+#ifdef WITH_NANOVDB
+/* NanoVDB Cache
+ *
+ * Grids converted to NanoVDB, kept in memory with least recently used eviction and optionally
+ * stored on disk as raw grid buffers, with least recently used files removed when the directory
+ * exceeds its size. The settings come with every request, so that sessions with different
+ * settings share the cache without reconfiguring it for each other. Only the in-memory lookup is
+ * done under the lock, files are read and written outside of it. */
+
+class NanoVDBCache {
+ public:
+  std::shared_ptr<nanovdb::GridHandle<>> find(const string &key,
+                                              const size_t memory_limit,
+                                              const string &directory)
+  {
+    std::shared_ptr<nanovdb::GridHandle<>> nanogrid;
+    {
+      const thread_scoped_lock lock(mutex);
+
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        nanogrid = it->second->second;
+      }
+    }
+
+    if (directory.empty()) {
+      return nanogrid;
+    }
+
+    if (nanogrid) {
+      /* Keep the file of a grid used from memory from being removed as least recently used. */
+      path_cache_mark_used(filepath(directory, key));
+      return nanogrid;
+    }
+
+    nanogrid = read(filepath(directory, key));
+    if (nanogrid) {
+      path_cache_mark_used(filepath(directory, key));
+      const thread_scoped_lock lock(mutex);
+      add(key, nanogrid, memory_limit);
+    }
+    return nanogrid;
+  }
+
+  void insert(const string &key,
+              const std::shared_ptr<nanovdb::GridHandle<>> &nanogrid,
+              const size_t memory_limit,
+              const string &directory,
+              const size_t disk_limit)
+  {
+    {
+      const thread_scoped_lock lock(mutex);
+      add(key, nanogrid, memory_limit);
+    }
+
+    if (!directory.empty()) {
+      write(filepath(directory, key), *nanogrid, disk_limit);
+    }
+  }
+
+ protected:
+  using Entry = std::pair<string, std::shared_ptr<nanovdb::GridHandle<>>>;
+
+  void add(const string &key,
+           const std::shared_ptr<nanovdb::GridHandle<>> &nanogrid,
+           const size_t memory_limit)
+  {
+    /* Another thread may have added the same grid while this one was reading or converting. */
+    if (entries.find(key) != entries.end()) {
+      return;
+    }
+
+    if (nanogrid->size() > memory_limit) {
+      evict(memory_limit);
+      return;
+    }
+
+    evict(memory_limit - nanogrid->size());
+    lru.emplace_front(key, nanogrid);
+    entries[key] = lru.begin();
+    memory_used += nanogrid->size();
+  }
+
+  void evict(const size_t limit)
+  {
+    while (memory_used > limit) {
+      const Entry &entry = lru.back();
+      memory_used -= entry.second->size();
+      entries.erase(entry.first);
+      lru.pop_back();
+    }
+  }
+
+  static string filepath(const string &directory, const string &key)
+  {
+    return path_join(directory, key + ".nanogrid");
+  }
+
+  static std::shared_ptr<nanovdb::GridHandle<>> read(const string &filepath)
+  {
+    const size_t size = path_file_size(filepath);
+    if (size == size_t(-1) || size < sizeof(nanovdb::GridData)) {
+      return nullptr;
+    }
+
+    FILE *f = path_fopen(filepath, "rb");
+    if (!f) {
+      return nullptr;
+    }
+
+    nanovdb::HostBuffer buffer = nanovdb::HostBuffer::create(size);
+    const bool ok = fread(buffer.data(), 1, size, f) == size &&
+                    ((const nanovdb::GridData *)buffer.data())->mGridSize == size;
+    fclose(f);
+
+    if (!ok) {
+      VLOG_WARNING << "Ignoring invalid NanoVDB cache file " << filepath;
+      return nullptr;
+    }
+
+    VLOG_INFO << "Loaded NanoVDB grid from cache file " << filepath;
+    return std::make_shared<nanovdb::GridHandle<>>(std::move(buffer));
+  }
+
+  static void write(const string &filepath,
+                    const nanovdb::GridHandle<> &nanogrid,
+                    const size_t disk_limit)
+  {
+    path_create_directories(filepath);
+
+    /* Write to a file with a unique name first, so that renders running at the same time never
+     * see a partially written file. */
+    const string tmp_filepath = string_printf(
+        "%s.%llx.tmp",
+        filepath.c_str(),
+        (unsigned long long)((uintptr_t)&nanogrid ^ (uintptr_t)(time_dt() * 1e6)));
+
+    FILE *f = path_fopen(tmp_filepath, "wb");
+    if (!f) {
+      return;
+    }
+
+    const bool ok = fwrite(nanogrid.data(), 1, nanogrid.size(), f) == nanogrid.size();
+    if (fclose(f) != 0 || !ok || rename(tmp_filepath.c_str(), filepath.c_str()) != 0) {
+      path_remove(tmp_filepath);
+      return;
+    }
+
+    path_cache_mark_added_and_clear_to_size(filepath, disk_limit);
+  }
+
+  thread_mutex mutex;
+  size_t memory_used = 0;
+  list<Entry> lru;
+  unordered_map<string, list<Entry>::iterator> entries;
+};
+
+static NanoVDBCache nanovdb_cache;
+
+string VDBImageLoader::nanovdb_cache_key() const
+{
+  if (source_filepath.empty() || (nanovdb_cache_size == 0 && nanovdb_cache_directory.empty())) {
+    return "";
+  }
+
+  /* Detect changes to the file by its modification time and size. */
+  const uint64_t modified_time = path_modified_time(source_filepath);
+  const uint64_t file_size = path_file_size(source_filepath);
+  const int version[3] = {NANOVDB_MAJOR_VERSION_NUMBER,
+                          NANOVDB_MINOR_VERSION_NUMBER,
+                          NANOVDB_PATCH_VERSION_NUMBER};
+  /* The same file gives different grids depending on the volume simplify setting, which changes
+   * the voxel size and so the transform. */
+  const openvdb::Mat4d transform = grid->transform().baseMap()->getAffineMap()->getMat4();
+
+  MD5Hash md5;
+  md5.append(source_filepath);
+  md5.append(grid_name);
+  md5.append((const uint8_t *)&modified_time, sizeof(modified_time));
+  md5.append((const uint8_t *)&file_size, sizeof(file_size));
+  md5.append((const uint8_t *)&precision, sizeof(precision));
+  md5.append((const uint8_t *)version, sizeof(version));
+  md5.append((const uint8_t *)transform.asPointer(), sizeof(double) * 16);
+  return md5.get_hex();
+}
+#endif
+
+void VDBImageLoader::set_nanovdb_cache(const string &filepath,
+                                       const size_t memory_size,
+                                       const string &directory,
+                                       const size_t disk_size)
+{
+  source_filepath = filepath;
+  nanovdb_cache_size = memory_size;
+  nanovdb_cache_directory = directory;
+  nanovdb_cache_disk_size = disk_size;
+}
+
 VDBImageLoader::VDBImageLoader(const string &grid_name) : grid_name(grid_name) {}
 
 VDBImageLoader::~VDBImageLoader() = default;
@@ -162,12 +367,29 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
     openvdb::tools::pruneInactive(pruned_grid.tree());
     nanogrid = nanovdb::openToNanoVDB(pruned_grid);
 #    endif
-    ToNanoOp op;
-    op.precision = precision;
-    if (!openvdb::grid_type_operation(grid, op)) {
-      return false;
+    const string cache_key = nanovdb_cache_key();
+    if (!cache_key.empty()) {
+      nanogrid = nanovdb_cache.find(cache_key, nanovdb_cache_size, nanovdb_cache_directory);
+    }
+
+    if (!nanogrid) {
+      ToNanoOp op;
+      op.precision = precision;
+      if (!openvdb::grid_type_operation(grid, op)) {
+        return false;
+      }
+
+      if (op.nanogrid) {
+        nanogrid = std::make_shared<nanovdb::GridHandle<>>(std::move(op.nanogrid));
+        if (!cache_key.empty()) {
+          nanovdb_cache.insert(cache_key,
+                               nanogrid,
+                               nanovdb_cache_size,
+                               nanovdb_cache_directory,
+                               nanovdb_cache_disk_size);
+        }
+      }
     }
-    nanogrid = std::move(op.nanogrid);
   }
 #  endif
 
@@ -184,7 +406,7 @@ bool VDBImageLoader::load_metadata(const ImageDeviceFeatures &features, ImageMet
 
 #  ifdef WITH_NANOVDB
   if (nanogrid) {
-    metadata.byte_size = nanogrid.size();
+    metadata.byte_size = nanogrid->size();
     if (metadata.channels == 1) {
       if (precision == 0) {
         metadata.type = IMAGE_DATA_TYPE_NANOVDB_FPN;
@@ -255,7 +477,7 @@ bool VDBImageLoader::load_pixels(const ImageMetaData & /*metadata*/,
 #ifdef WITH_OPENVDB
 #  ifdef WITH_NANOVDB
   if (nanogrid) {
-    memcpy(pixels, nanogrid.data(), nanogrid.size());
+    memcpy(pixels, nanogrid->data(), nanogrid->size());
   }
   else
 #  endif
@@ -48,15 +48,32 @@ class VDBImageLoader : public ImageLoader {
   openvdb::GridBase::ConstPtr get_grid();
 #endif
 
+  /* Cache the grid converted to NanoVDB by the file it was read from without modifications. The
+   * cache is shared by all scenes, so that rendering again does not need to convert the same
+   * grids again. A memory size of zero disables the in-memory cache, an empty directory disables
+   * the on-disk cache. The least recently used files are removed from the directory when it
+   * exceeds the disk size in bytes. */
+  void set_nanovdb_cache(const string &filepath,
+                         const size_t memory_size,
+                         const string &directory,
+                         const size_t disk_size);
+
  protected:
   string grid_name;
+  /* File the grid was read from without modifications, if any. Only such grids are cached. */
+  string source_filepath;
+  size_t nanovdb_cache_size = 0;
+  string nanovdb_cache_directory;
+  size_t nanovdb_cache_disk_size = 0;
 #ifdef WITH_OPENVDB
   openvdb::GridBase::ConstPtr grid;
   openvdb::CoordBBox bbox;
 #endif
 #ifdef WITH_NANOVDB
-  nanovdb::GridHandle<> nanogrid;
+  std::shared_ptr<nanovdb::GridHandle<>> nanogrid;
   int precision = 0;
+
+  string nanovdb_cache_key() const;
 #endif
 };
 
@@ -2,6 +2,9 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <array>
+#include <map>
+
 #include "scene/light_tree.h"
 #include "scene/mesh.h"
 #include "scene/object.h"
@@ -376,8 +379,33 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
   });
   task_pool.wait_work();
 
+  /* Instances whose transformations only differ in translation have the same measure up to a
+   * translation of the bounding box. So when the measure is not directly transformable, only count
+   * the triangles again for the first instance of every combination of mesh and linear part of
+   * the transformation, and translate its measure for the other instances. */
+  vector<int> measure_source(num_mesh_lights, -1);
+  std::map<std::pair<Mesh *, std::array<float, 9>>, int> unique_transforms;
+  for (int i = 0; i < num_mesh_lights; i++) {
+    Object *object = scene->objects[mesh_lights_[i].object_id];
+    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+    const Transform &tfm = object->get_tfm();
+
+    float scale_squared;
+    if (mesh->transform_applied || transform_uniform_scale(tfm, scale_squared)) {
+      continue;
+    }
+
+    const std::array<float, 9> linear = {
+        tfm.x.x, tfm.x.y, tfm.x.z, tfm.y.x, tfm.y.y, tfm.y.z, tfm.z.x, tfm.z.y, tfm.z.z};
+    const auto [it, inserted] = unique_transforms.emplace(std::make_pair(mesh, linear), i);
+    if (!inserted) {
+      measure_source[i] = it->second;
+    }
+  }
+
   /* Update measure. */
-  parallel_for_each(mesh_lights_, [&](LightTreeEmitter &emitter) {
+  parallel_for(0, num_mesh_lights, [&](const int i) {
+    LightTreeEmitter &emitter = mesh_lights_[i];
     Object *object = scene->objects[emitter.object_id];
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
 
@@ -391,17 +419,34 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
      * and solving a cubic equation (https://doi.org/10.1016/j.nima.2009.11.075 section 3.4), then
      * the angle is derived from the major axis of the resulted right elliptic cone's base, which
      * can be an overestimation. */
-    if (!mesh->transform_applied && !emitter.measure.transform(object->get_tfm())) {
+    if (!mesh->transform_applied && !emitter.measure.transform(object->get_tfm()) &&
+        measure_source[i] == -1)
+    {
       emitter.measure.reset();
       size_t const mesh_num_triangles = mesh->num_triangles();
-      for (size_t i = 0; i < mesh_num_triangles; i++) {
-        if (triangle_usable_as_light(mesh, i)) {
-          emitter.measure.add(LightTreeEmitter(scene, i, emitter.object_id, true).measure);
+      for (size_t prim_id = 0; prim_id < mesh_num_triangles; prim_id++) {
+        if (triangle_usable_as_light(mesh, prim_id)) {
+          emitter.measure.add(LightTreeEmitter(scene, prim_id, emitter.object_id, true).measure);
         }
       }
     }
   });
 
+  parallel_for(0, num_mesh_lights, [&](const int i) {
+    if (measure_source[i] == -1) {
+      return;
+    }
+
+    LightTreeEmitter &emitter = mesh_lights_[i];
+    const LightTreeEmitter &source = mesh_lights_[measure_source[i]];
+    const float3 offset = transform_get_column(&scene->objects[emitter.object_id]->get_tfm(), 3) -
+                          transform_get_column(&scene->objects[source.object_id]->get_tfm(), 3);
+
+    emitter.measure = source.measure;
+    emitter.measure.bbox = BoundBox(source.measure.bbox.min + offset,
+                                    source.measure.bbox.max + offset);
+  });
+
   for (LightTreeEmitter &emitter : mesh_lights_) {
     emitter.root->measure = emitter.measure;
   }
@@ -750,6 +750,26 @@ void Mesh::pack_normals(packed_float3 *vnormal)
   }
 }
 
+void Mesh::pack_normals(uint *vnormal_packed)
+{
+  Attribute *attr_vN = attributes.find(ATTR_STD_VERTEX_NORMAL);
+  if (attr_vN == nullptr) {
+    /* Happens on objects with just hair. */
+    return;
+  }
+
+  const bool do_transform = transform_applied;
+  const Transform ntfm = transform_normal;
+
+  float3 *vN = attr_vN->data_float3();
+  const size_t verts_size = verts.size();
+
+  for (size_t i = 0; i < verts_size; i++) {
+    const float3 N = (do_transform) ? safe_normalize(transform_direction(&ntfm, vN[i])) : vN[i];
+    vnormal_packed[i] = float3_to_octahedral_packed(N);
+  }
+}
+
 void Mesh::pack_verts(packed_float3 *tri_verts,
                       packed_uint3 *tri_vindex,
                       uint *tri_patch,
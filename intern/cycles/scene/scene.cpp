@@ -60,7 +60,7 @@ Scene ::Scene(const SceneParams &params_, Device *device)
   light_manager = make_unique<LightManager>();
   geometry_manager = make_unique<GeometryManager>();
   object_manager = make_unique<ObjectManager>();
-  image_manager = make_unique<ImageManager>(device->info);
+  image_manager = make_unique<ImageManager>(device->info, params.texture_cache_size);
   particle_system_manager = make_unique<ParticleSystemManager>();
   bake_manager = make_unique<BakeManager>();
   procedural_manager = make_unique<ProceduralManager>();
@@ -179,14 +179,28 @@ void Scene::device_update(Device *device_, Progress &progress)
 
   const scoped_callback_timer timer([this, print_stats](double time) {
     if (update_stats) {
+      update_stats->end_stage(device->stats);
       update_stats->scene.times.add_entry({"device_update", time});
 
       if (print_stats) {
         printf("Update statistics:\n%s\n", update_stats->full_report().c_str());
       }
+
+      if (!update_stats->trace_filepath.empty() &&
+          !update_stats->write_trace(update_stats->trace_filepath))
+      {
+        VLOG_WARNING << "Failed to write update trace to " << update_stats->trace_filepath;
+      }
     }
   });
 
+  /* Each stage is timed separately for the update statistics. */
+  auto begin_stage = [this](const char *stage) {
+    if (update_stats) {
+      update_stats->begin_stage(stage, device->stats);
+    }
+  };
+
   /* The order of updates is important, because there's dependencies between
    * the different managers, using data computed by previous managers.
    *
@@ -208,6 +222,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Shaders");
+  begin_stage("Shaders");
   osl_manager->device_update_pre(device, this);
   shader_manager->device_update(device, &dscene, this, progress);
   osl_manager->device_update_post(device, this, progress);
@@ -216,6 +231,7 @@ void Scene::device_update(Device *device_, Progress &progress)
     return;
   }
 
+  begin_stage("Procedurals");
   procedural_manager->update(this, progress);
 
   if (progress.get_cancel()) {
@@ -223,6 +239,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Background");
+  begin_stage("Background");
   background->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -230,12 +247,14 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Camera");
+  begin_stage("Camera");
   camera->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
     return;
   }
 
+  begin_stage("Geometry Preprocess");
   geometry_manager->device_update_preprocess(device, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -243,6 +262,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Objects");
+  begin_stage("Objects");
   object_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -250,6 +270,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Particle Systems");
+  begin_stage("Particle Systems");
   particle_system_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -257,6 +278,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Meshes");
+  begin_stage("Geometry");
   geometry_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -264,6 +286,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Objects Flags");
+  begin_stage("Object Flags");
   object_manager->device_update_flags(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -271,6 +294,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Primitive Offsets");
+  begin_stage("Primitive Offsets");
   object_manager->device_update_prim_offsets(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -278,6 +302,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Images");
+  begin_stage("Images");
   image_manager->device_update(device, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -285,6 +310,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Camera Volume");
+  begin_stage("Camera Volume");
   camera->device_update_volume(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -292,6 +318,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Lookup Tables");
+  begin_stage("Lookup Tables");
   lookup_tables->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -299,6 +326,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Lights");
+  begin_stage("Lights");
   light_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -306,6 +334,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Integrator");
+  begin_stage("Integrator");
   integrator->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -313,6 +342,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Film");
+  begin_stage("Film");
   film->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -320,6 +350,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Lookup Tables");
+  begin_stage("Film Lookup Tables");
   lookup_tables->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -327,6 +358,7 @@ void Scene::device_update(Device *device_, Progress &progress)
   }
 
   progress.set_status("Updating Baking");
+  begin_stage("Baking");
   bake_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error()) {
@@ -337,6 +369,7 @@ void Scene::device_update(Device *device_, Progress &progress)
     dscene.data.volume_stack_size = get_volume_stack_size();
 
     progress.set_status("Updating Device", "Writing constant memory");
+    begin_stage("Constant Memory");
     device->const_copy_to("data", &dscene.data, sizeof(dscene.data));
   }
 
@@ -453,11 +486,12 @@ void Scene::collect_statistics(RenderStats *stats)
   image_manager->collect_statistics(stats);
 }
 
-void Scene::enable_update_stats()
+void Scene::enable_update_stats(const string &trace_filepath)
 {
   if (!update_stats) {
     update_stats = make_unique<SceneUpdateStats>();
   }
+  update_stats->trace_filepath = trace_filepath;
 }
 
 void Scene::update_kernel_features()
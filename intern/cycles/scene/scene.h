@@ -72,6 +72,20 @@ class SceneParams {
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  /* Size of the image texture cache in megabytes, zero to load images fully. */
+  int texture_cache_size;
+  /* Directory to cache geometry BVHs in across frames and renders, disabled when empty. */
+  string bvh_cache_directory;
+  /* Maximum size of the BVH cache directory in megabytes. */
+  int bvh_cache_size;
+  /* Store vertex normals octahedral encoded and UV maps within [0, 1] at half precision. */
+  bool use_compact_geometry;
+  /* Size of the in-memory cache of NanoVDB converted volume grids in megabytes. */
+  int volume_cache_size;
+  /* Directory to store NanoVDB converted volume grids in across renders, disabled when empty. */
+  string volume_cache_directory;
+  /* Maximum size of the volume cache directory in megabytes. */
+  int volume_disk_cache_size;
 
   bool background;
 
@@ -87,6 +101,11 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_cache_size = 0;
+    bvh_cache_size = 0;
+    use_compact_geometry = false;
+    volume_cache_size = 0;
+    volume_disk_cache_size = 0;
     background = true;
   }
 
@@ -99,7 +118,14 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size &&
+             bvh_cache_directory == params.bvh_cache_directory &&
+             bvh_cache_size == params.bvh_cache_size &&
+             use_compact_geometry == params.use_compact_geometry &&
+             volume_cache_size == params.volume_cache_size &&
+             volume_cache_directory == params.volume_cache_directory &&
+             volume_disk_cache_size == params.volume_disk_cache_size);
   }
 
   int curve_subdivisions()
@@ -192,7 +218,8 @@ class Scene : public NodeOwner {
 
   void collect_statistics(RenderStats *stats);
 
-  void enable_update_stats();
+  /* Collect update statistics, optionally writing them as a trace file after every update. */
+  void enable_update_stats(const string &trace_filepath = "");
 
   bool load_kernels(Progress &progress);
   bool update(Progress &progress);
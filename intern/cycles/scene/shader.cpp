@@ -281,12 +281,22 @@ void Shader::set_graph(unique_ptr<ShaderGraph> &&graph_)
    * are connected but proxy nodes should not count */
   if (graph_) {
     graph_->remove_proxy_nodes();
+    graph_->compute_structure_hash();
 
     if (displacement_method != DISPLACE_BUMP) {
       graph_->compute_displacement_hash();
     }
   }
 
+  /* Keep the existing graph if the new one is identical, so that the shader manager can reuse
+   * the already simplified and compiled graph instead of doing the work again. Simplification
+   * of AOV outputs depends on the film passes, so those graphs are always replaced. */
+  if (graph && graph_ && !displacement_method_is_modified() &&
+      graph->structure_hash == graph_->structure_hash && !graph_->has_aov_output())
+  {
+    return;
+  }
+
   /* update geometry if displacement changed */
   if (displacement_method != DISPLACE_BUMP) {
     const char *old_hash = (graph) ? graph->displacement_hash.c_str() : "";
@@ -207,8 +207,11 @@ bool ShaderNode::equals(const ShaderNode &other)
 
 /* Graph */
 
+std::atomic<uint64_t> ShaderGraph::next_generation = 0;
+
 ShaderGraph::ShaderGraph()
 {
+  generation = next_generation++;
   finalized = false;
   simplified = false;
   num_node_ids = 0;
@@ -733,6 +736,35 @@ void ShaderGraph::break_cycles(ShaderNode *node, vector<bool> &visited, vector<b
   on_stack[node->id] = false;
 }
 
+static void hash_node(MD5Hash &md5, ShaderNode *node)
+{
+  node->hash(md5);
+  for (ShaderInput *input : node->inputs) {
+    int link_id = (input->link) ? input->link->parent->id : 0;
+    md5.append((uint8_t *)&link_id, sizeof(link_id));
+    md5.append((input->link) ? input->link->name().c_str() : "");
+  }
+
+  if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
+    /* Hash takes into account socket values, to detect changes
+     * in the code of the node we need an exception. */
+    OSLNode *oslnode = static_cast<OSLNode *>(node);
+    md5.append(oslnode->bytecode_hash);
+  }
+  else if (node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT ||
+           node->type == PointDensityTextureNode::get_node_type())
+  {
+    /* Images may be provided through a loader rather than a filename socket. */
+    const ImageHandle &handle = (node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT) ?
+                                    static_cast<ImageSlotTextureNode *>(node)->handle :
+                                    static_cast<PointDensityTextureNode *>(node)->handle;
+    for (int i = 0; i < handle.num_svm_slots(); i++) {
+      const int slot = handle.svm_slot(i);
+      md5.append((const uint8_t *)&slot, sizeof(slot));
+    }
+  }
+}
+
 void ShaderGraph::compute_displacement_hash()
 {
   /* Compute hash of all nodes linked to displacement, to detect if we need
@@ -749,24 +781,26 @@ void ShaderGraph::compute_displacement_hash()
 
   MD5Hash md5;
   for (ShaderNode *node : nodes_displace) {
-    node->hash(md5);
-    for (ShaderInput *input : node->inputs) {
-      int link_id = (input->link) ? input->link->parent->id : 0;
-      md5.append((uint8_t *)&link_id, sizeof(link_id));
-      md5.append((input->link) ? input->link->name().c_str() : "");
-    }
-
-    if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
-      /* Hash takes into account socket values, to detect changes
-       * in the code of the node we need an exception. */
-      OSLNode *oslnode = static_cast<OSLNode *>(node);
-      md5.append(oslnode->bytecode_hash);
-    }
+    hash_node(md5, node);
   }
 
   displacement_hash = md5.get_hex();
 }
 
+void ShaderGraph::compute_structure_hash()
+{
+  /* Compute hash of all nodes and links, to detect if a new graph is identical
+   * to the one it replaces. Node ids are included, so this relies on graphs
+   * being built in the same order, as is the case for repeated syncs. */
+  MD5Hash md5;
+  for (ShaderNode *node : nodes) {
+    md5.append((uint8_t *)&node->id, sizeof(node->id));
+    hash_node(md5, node);
+  }
+
+  structure_hash = md5.get_hex();
+}
+
 void ShaderGraph::clean(Scene *scene)
 {
   /* Graph simplification */
@@ -1187,6 +1221,16 @@ int ShaderGraph::get_num_closures()
   return num_closures;
 }
 
+bool ShaderGraph::has_aov_output() const
+{
+  for (const ShaderNode *node : nodes) {
+    if (node->special_type == SHADER_SPECIAL_TYPE_OUTPUT_AOV) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ShaderGraph::dump_graph(const char *filename)
 {
   FILE *fd = fopen(filename, "w");
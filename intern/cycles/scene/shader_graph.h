@@ -17,6 +17,8 @@
 #include "util/unique_ptr_vector.h"
 #include "util/vector.h"
 
+#include <atomic>
+
 CCL_NAMESPACE_BEGIN
 
 class AttributeRequestSet;
@@ -297,6 +299,9 @@ class ShaderGraph : public NodeOwner {
   bool finalized;
   bool simplified;
   string displacement_hash;
+  string structure_hash;
+  /* Unique number of the graph. Unlike its address, it is never reused by a later graph. */
+  uint64_t generation;
 
   ShaderGraph();
   ~ShaderGraph() override;
@@ -312,10 +317,12 @@ class ShaderGraph : public NodeOwner {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  void compute_structure_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene, bool do_bump = false, bool bump_in_object_space = false);
 
   int get_num_closures();
+  bool has_aov_output() const;
 
   void dump_graph(const char *filename);
 
@@ -350,6 +357,8 @@ class ShaderGraph : public NodeOwner {
  protected:
   using NodePair = pair<ShaderNode *const, ShaderNode *>;
 
+  static std::atomic<uint64_t> next_generation;
+
   void add_node(unique_ptr<ShaderNode> &&node);
 
   void find_dependencies(ShaderNodeSet &dependencies, ShaderInput *input);
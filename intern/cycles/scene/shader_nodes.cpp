@@ -394,6 +394,34 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
     }
   }
 
+  /* When the coordinates come straight from a UV map, pass its derivatives along so the texture
+   * cache can pick a mip level. */
+  uint uv_attr = ATTR_STD_NOT_FOUND;
+  if (projection == NODE_IMAGE_PROJ_FLAT && compiler.scene->image_manager->use_texture_cache() &&
+      tex_mapping.skip())
+  {
+    if (vector_in->link) {
+      ShaderNode *node = vector_in->link->parent;
+      if (node->type == UVMapNode::get_node_type()) {
+        UVMapNode *uvmap = (UVMapNode *)node;
+        if (!uvmap->get_from_dupli()) {
+          uv_attr = (uvmap->get_attribute().empty()) ?
+                        compiler.attribute(ATTR_STD_UV) :
+                        compiler.attribute(uvmap->get_attribute());
+        }
+      }
+      else if (node->type == TextureCoordinateNode::get_node_type()) {
+        TextureCoordinateNode *texco = (TextureCoordinateNode *)node;
+        if (vector_in->link == node->output("UV") && !texco->get_from_dupli()) {
+          uv_attr = compiler.attribute(ATTR_STD_UV);
+        }
+      }
+    }
+    if (uv_attr != ATTR_STD_NOT_FOUND) {
+      flags |= NODE_IMAGE_UV_DERIVATIVES;
+    }
+  }
+
   if (projection != NODE_IMAGE_PROJ_BOX) {
     /* If there only is one image (a very common case), we encode it as a negative value. */
     int num_nodes;
@@ -412,6 +440,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              flags),
                       projection);
 
+    if (flags & NODE_IMAGE_UV_DERIVATIVES) {
+      compiler.add_node(uv_attr, 0, 0, 0);
+    }
+
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
         int4 node;
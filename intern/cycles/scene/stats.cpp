@@ -6,7 +6,9 @@
 #include "scene/object.h"
 #include "util/algorithm.h"
 
+#include "util/path.h"
 #include "util/string.h"
+#include "util/task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -45,9 +47,12 @@ NamedSizeEntry::NamedSizeEntry() : size(0) {}
 
 NamedSizeEntry::NamedSizeEntry(const string &name, const size_t size) : name(name), size(size) {}
 
-NamedTimeEntry::NamedTimeEntry() : time(0) {}
+NamedTimeEntry::NamedTimeEntry() : time(0), end_time(0) {}
 
-NamedTimeEntry::NamedTimeEntry(const string &name, const double time) : name(name), time(time) {}
+NamedTimeEntry::NamedTimeEntry(const string &name, const double time)
+    : name(name), time(time), end_time(0)
+{
+}
 
 /* Named size statistics. */
 
@@ -310,11 +315,61 @@ string UpdateTimeStats::full_report(const int indent_level)
   return times.full_report(indent_level + 1);
 }
 
-SceneUpdateStats::SceneUpdateStats() = default;
+SceneUpdateStage::SceneUpdateStage()
+    : start_time(0.0), time(0.0), cpu_time(0.0), bytes_copied(0), num_threads(1)
+{
+}
+
+float SceneUpdateStage::thread_utilization() const
+{
+  if (time <= 0.0) {
+    return 0.0f;
+  }
+  return min(float(cpu_time / (time * num_threads)), 1.0f);
+}
+
+SceneUpdateStats::SceneUpdateStats()
+    : start_time(time_dt()), stage_cpu_time(0.0), stage_bytes_copied(0)
+{
+}
+
+void SceneUpdateStats::begin_stage(const string &name, const Stats &device_stats)
+{
+  end_stage(device_stats);
+
+  current_stage.name = name;
+  current_stage.start_time = time_dt();
+  current_stage.num_threads = TaskScheduler::max_concurrency();
+  stage_cpu_time = time_process_cpu();
+  stage_bytes_copied = device_stats.mem_copied;
+}
+
+void SceneUpdateStats::end_stage(const Stats &device_stats)
+{
+  if (current_stage.name.empty()) {
+    return;
+  }
+
+  current_stage.time = time_dt() - current_stage.start_time;
+  current_stage.cpu_time = time_process_cpu() - stage_cpu_time;
+  current_stage.bytes_copied = device_stats.mem_copied - stage_bytes_copied;
+  stages.push_back(current_stage);
+
+  current_stage = SceneUpdateStage();
+}
 
 string SceneUpdateStats::full_report()
 {
   string result;
+  result += "Stages:\n";
+  for (const SceneUpdateStage &stage : stages) {
+    result += string_printf("%s%-40s %fs, %3.0f%% threads, %s copied\n",
+                            string(2 * kIndentNumSpaces, ' ').c_str(),
+                            stage.name.c_str(),
+                            stage.time,
+                            stage.thread_utilization() * 100.0f,
+                            string_human_readable_size(stage.bytes_copied).c_str());
+  }
   result += "Scene:\n" + scene.full_report(1);
   result += "Geometry:\n" + geometry.full_report(1);
   result += "Light:\n" + light.full_report(1);
@@ -350,6 +405,106 @@ void SceneUpdateStats::clear()
   svm.times.clear();
   tables.times.clear();
   procedurals.times.clear();
+  stages.clear();
+
+  start_time = time_dt();
+  current_stage = SceneUpdateStage();
+}
+
+static string trace_escape(const string &str)
+{
+  string result;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20) {
+      /* Control characters are not allowed in JSON strings. */
+      result += string_printf("\\u%04x", static_cast<unsigned char>(c));
+    }
+    else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+string SceneUpdateStats::trace_json()
+{
+  /* Stages go on the first track, the timings reported by every manager on their own track
+   * below it. Timestamps and durations are in microseconds. */
+  const std::pair<const char *, const UpdateTimeStats *> managers[] = {
+      {"Scene", &scene},
+      {"Geometry", &geometry},
+      {"Light", &light},
+      {"Object", &object},
+      {"Image", &image},
+      {"Background", &background},
+      {"Bake", &bake},
+      {"Camera", &camera},
+      {"Film", &film},
+      {"Integrator", &integrator},
+      {"OSL", &osl},
+      {"Particles", &particles},
+      {"SVM", &svm},
+      {"Tables", &tables},
+      {"Procedurals", &procedurals}};
+
+  string result = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  result += "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, ";
+  result += "\"args\": {\"name\": \"Stages\"}}";
+
+  for (const SceneUpdateStage &stage : stages) {
+    result += string_printf(
+        ",\n{\"name\": \"%s\", \"cat\": \"stage\", \"ph\": \"X\", \"pid\": 1, \"tid\": 0, "
+        "\"ts\": %.0f, \"dur\": %.0f, \"args\": {\"cpu_time\": %f, "
+        "\"thread_utilization\": %f, \"bytes_copied\": %zu}}",
+        trace_escape(stage.name).c_str(),
+        (stage.start_time - start_time) * 1e6,
+        stage.time * 1e6,
+        stage.cpu_time,
+        stage.thread_utilization(),
+        stage.bytes_copied);
+  }
+
+  int tid = 1;
+  for (const auto &manager : managers) {
+    result += string_printf(
+        ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+        "\"args\": {\"name\": \"%s\"}}",
+        tid,
+        manager.first);
+
+    for (const NamedTimeEntry &entry : manager.second->times.entries) {
+      result += string_printf(
+          ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+          "\"ts\": %.0f, \"dur\": %.0f}",
+          trace_escape(entry.name).c_str(),
+          manager.first,
+          tid,
+          (entry.end_time - entry.time - start_time) * 1e6,
+          entry.time * 1e6);
+    }
+
+    tid++;
+  }
+
+  result += "\n]}\n";
+  return result;
+}
+
+bool SceneUpdateStats::write_trace(const string &filepath)
+{
+  const string json = trace_json();
+
+  FILE *f = path_fopen(filepath, "wb");
+  if (!f) {
+    return false;
+  }
+
+  const bool ok = fwrite(json.data(), 1, json.size(), f) == json.size();
+  return fclose(f) == 0 && ok;
 }
 
 CCL_NAMESPACE_END
@@ -6,7 +6,9 @@
 
 #include "scene/scene.h"
 
+#include "util/stats.h"
 #include "util/string.h"
+#include "util/time.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -34,6 +36,8 @@ class NamedTimeEntry {
 
   string name;
   double time;
+  /* Time at which the entry was added, for the trace export. */
+  double end_time;
 };
 
 /* Container of named size entries. Used, for example, to store per-mesh memory
@@ -68,6 +72,7 @@ class NamedTimeStats {
   {
     total_time += entry.time;
     entries.push_back(entry);
+    entries.back().end_time = time_dt();
   }
 
   /* Generate full human-readable report. */
@@ -187,6 +192,27 @@ class UpdateTimeStats {
   NamedTimeStats times;
 };
 
+/* Stage of Scene::device_update, with the resources it used. */
+class SceneUpdateStage {
+ public:
+  SceneUpdateStage();
+
+  string name;
+  double start_time;
+  /* Wall time in seconds. */
+  double time;
+  /* CPU time of the whole process in seconds, so it includes other work running at the same
+   * time. */
+  double cpu_time;
+  /* Bytes copied to the device. */
+  size_t bytes_copied;
+  /* Number of threads which could have worked on the stage. */
+  int num_threads;
+
+  /* Fraction of the available threads that were busy on average. */
+  float thread_utilization() const;
+};
+
 class SceneUpdateStats {
  public:
   SceneUpdateStats();
@@ -207,9 +233,30 @@ class SceneUpdateStats {
   UpdateTimeStats tables;
   UpdateTimeStats procedurals;
 
+  /* Stages of the last update, in the order they ran. */
+  vector<SceneUpdateStage> stages;
+
+  /* Write the stages and timings of the last update to this file after every update, as Chrome
+   * trace event JSON that can be opened in chrome://tracing or Perfetto. Disabled when empty. */
+  string trace_filepath;
+
+  /* End the current stage, if any, and start a new one. */
+  void begin_stage(const string &name, const Stats &device_stats);
+  void end_stage(const Stats &device_stats);
+
   string full_report();
+  string trace_json();
+  bool write_trace(const string &filepath);
 
   void clear();
+
+ protected:
+  /* Start of the last update, trace timestamps are relative to it. */
+  double start_time;
+
+  SceneUpdateStage current_stage;
+  double stage_cpu_time;
+  size_t stage_bytes_copied;
 };
 
 CCL_NAMESPACE_END
@@ -7,6 +7,7 @@
 #include "device/device.h"
 
 #include "scene/background.h"
+#include "scene/image.h"
 #include "scene/light.h"
 #include "scene/mesh.h"
 #include "scene/scene.h"
@@ -17,6 +18,7 @@
 #include "scene/svm.h"
 
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/progress.h"
 #include "util/task.h"
 
@@ -48,6 +50,19 @@ void SVMShaderManager::device_update_shader(Scene *scene,
             << summary.full_report();
 }
 
+string SVMShaderManager::compiled_shader_hash(Scene *scene, Shader *shader)
+{
+  MD5Hash md5;
+  shader->hash(md5);
+
+  const bool background = (shader == scene->background->get_shader(scene));
+  const bool use_texture_cache = scene->image_manager->use_texture_cache();
+  md5.append((const uint8_t *)&background, sizeof(background));
+  md5.append((const uint8_t *)&use_texture_cache, sizeof(use_texture_cache));
+
+  return md5.get_hex();
+}
+
 void SVMShaderManager::device_update_specific(Device *device,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -72,20 +87,42 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* test if we need to update */
   device_free(device, dscene, scene);
 
-  /* Build all shaders. */
+  /* Build all shaders, reusing nodes of shaders for which nothing changed. Finalization
+   * modifies the graph, so a finalized graph was compiled before and still holds the images
+   * referenced by the cached nodes. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
+  vector<string> shader_hashes(num_shaders);
+  int num_reused = 0;
   for (int i = 0; i < num_shaders; i++) {
+    Shader *shader = scene->shaders[i];
+    shader_hashes[i] = compiled_shader_hash(scene, shader);
+
+    const auto it = compiled_shaders.find(shader);
+    if (it != compiled_shaders.end() &&
+        it->second.graph_generation == shader->graph->generation && shader->graph->finalized &&
+        it->second.hash == shader_hashes[i])
+    {
+      shader_svm_nodes[i].steal_data(it->second.svm_nodes);
+      num_reused++;
+      continue;
+    }
+
     task_pool.push([this, scene, &progress, &shader_svm_nodes, i] {
       device_update_shader(scene, scene->shaders[i], progress, &shader_svm_nodes[i]);
     });
   }
   task_pool.wait_work();
 
+  /* Shaders removed from the scene are dropped from the cache here. */
+  compiled_shaders.clear();
+
   if (progress.get_cancel()) {
     return;
   }
 
+  VLOG_INFO << "Reused " << num_reused << " compiled shaders.";
+
   /* The global node list contains a jump table (one node per shader)
    * followed by the nodes of all shaders. */
   int svm_nodes_size = num_shaders;
@@ -132,6 +169,14 @@ void SVMShaderManager::device_update_specific(Device *device,
     return;
   }
 
+  for (int i = 0; i < num_shaders; i++) {
+    Shader *shader = scene->shaders[i];
+    CompiledShader &compiled = compiled_shaders[shader];
+    compiled.graph_generation = shader->graph->generation;
+    compiled.hash = std::move(shader_hashes[i]);
+    compiled.svm_nodes.steal_data(shader_svm_nodes[i]);
+  }
+
   dscene->svm_nodes.copy_to_device();
 
   device_update_common(device, dscene, scene, progress);
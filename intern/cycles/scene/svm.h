@@ -10,6 +10,7 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/string.h"
 
 CCL_NAMESPACE_BEGIN
@@ -41,6 +42,19 @@ class SVMShaderManager : public ShaderManager {
                             Shader *shader,
                             Progress &progress,
                             array<int4> *svm_nodes);
+
+  /* Hash of the shader settings that affect compilation besides the graph. */
+  string compiled_shader_hash(Scene *scene, Shader *shader);
+
+  /* Nodes of the last compilation of each shader, reused as long as the shader keeps the
+   * same finalized graph and settings. This avoids recompiling all shaders when only a few
+   * of them changed, or when the host application synced identical graphs again. */
+  struct CompiledShader {
+    uint64_t graph_generation = 0;
+    string hash;
+    array<int4> svm_nodes;
+  };
+  unordered_map<const Shader *, CompiledShader> compiled_shaders;
 };
 
 /* Graph Compiler */
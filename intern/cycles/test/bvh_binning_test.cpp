@@ -0,0 +1,94 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "bvh/binning.h"
+
+#include "testing/testing.h"
+
+#include "util/algorithm.h"
+#include "util/hash.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+static void expect_float3_eq(const float3 a, const float3 b)
+{
+  EXPECT_EQ(a.x, b.x);
+  EXPECT_EQ(a.y, b.y);
+  EXPECT_EQ(a.z, b.z);
+}
+
+static vector<int> sorted_prim_indices(const vector<BVHReference> &prims, const BVHRange &range)
+{
+  vector<int> indices;
+  for (int i = range.start(); i < range.end(); i++) {
+    indices.push_back(prims[i].prim_index());
+  }
+  sort(indices.begin(), indices.end());
+  return indices;
+}
+
+/* Split both ranges recursively and check that they have the same primitives and bounds. The
+ * order of the primitives within a range differs, since the serial partition is not stable. */
+static void expect_same_splits(const BVHObjectBinning &serial,
+                               vector<BVHReference> &serial_prims,
+                               const BVHObjectBinning &parallel,
+                               vector<BVHReference> &parallel_prims,
+                               const int depth)
+{
+  ASSERT_EQ(serial.start(), parallel.start());
+  ASSERT_EQ(serial.size(), parallel.size());
+  expect_float3_eq(serial.bounds().min, parallel.bounds().min);
+  expect_float3_eq(serial.bounds().max, parallel.bounds().max);
+  expect_float3_eq(serial.cent_bounds().min, parallel.cent_bounds().min);
+  expect_float3_eq(serial.cent_bounds().max, parallel.cent_bounds().max);
+  EXPECT_EQ(sorted_prim_indices(serial_prims, serial),
+            sorted_prim_indices(parallel_prims, parallel));
+
+  /* Binning is a reduction of bounds and counts, so the cost is not affected by the order. */
+  EXPECT_EQ(serial.splitSAH, parallel.splitSAH);
+  EXPECT_EQ(serial.leafSAH, parallel.leafSAH);
+
+  if (depth == 0) {
+    return;
+  }
+
+  BVHObjectBinning serial_left, serial_right;
+  BVHObjectBinning parallel_left, parallel_right;
+  serial.split(serial_prims.data(), serial_left, serial_right);
+  parallel.split(parallel_prims.data(), parallel_left, parallel_right);
+
+  expect_same_splits(serial_left, serial_prims, parallel_left, parallel_prims, depth - 1);
+  expect_same_splits(serial_right, serial_prims, parallel_right, parallel_prims, depth - 1);
+}
+
+TEST(BVHObjectBinning, parallel_matches_serial)
+{
+  /* Boxes of varying size scattered in a flat volume, enough to be split by multiple tasks. */
+  const int num_prims = 100000;
+  vector<BVHReference> prims;
+  BoundBox bounds = BoundBox::empty;
+  BoundBox cent_bounds = BoundBox::empty;
+  for (int i = 0; i < num_prims; i++) {
+    const float3 min = make_float3(hash_uint2_to_float(i, 0) * 100.0f,
+                                   hash_uint2_to_float(i, 1) * 30.0f,
+                                   hash_uint2_to_float(i, 2) * 100.0f);
+    const float3 size = make_float3(hash_uint2_to_float(i, 3) + 0.01f);
+    const BoundBox prim_bounds(min, min + size);
+    prims.push_back(BVHReference(prim_bounds, i, 0, PRIMITIVE_TRIANGLE));
+    bounds.grow(prim_bounds);
+    cent_bounds.grow(prim_bounds.center2());
+  }
+
+  vector<BVHReference> serial_prims = prims;
+  vector<BVHReference> parallel_prims = prims;
+  const BVHRange range(bounds, cent_bounds, 0, num_prims);
+
+  const BVHObjectBinning serial(range, serial_prims.data(), nullptr, nullptr, SIZE_MAX);
+  const BVHObjectBinning parallel(range, parallel_prims.data(), nullptr, nullptr, 0);
+
+  expect_same_splits(serial, serial_prims, parallel, parallel_prims, 4);
+}
+
+CCL_NAMESPACE_END
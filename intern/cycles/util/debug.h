@@ -45,6 +45,10 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Render a batch of paths per thread, executing the same kernel for many paths in a row,
+     * instead of tracing one path at a time from start to finish. */
+    bool wavefront = false;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
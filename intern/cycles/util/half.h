@@ -126,6 +126,41 @@ ccl_device_inline float4 half4_to_float4_image(const half4 h)
   return f;
 }
 
+/* Conversion to/from two half floats packed into an unsigned integer, for compact storage of
+ * attributes. Rounds to nearest, flushes small values to zero and clamps large values, so that
+ * decoding does not need to handle denormals, inf or NaN. */
+
+ccl_device_inline uint float_to_half_bits(const float f)
+{
+  const uint u = __float_as_uint(f);
+  const uint sign = (u >> 16) & 0x8000;
+  const uint abs_u = u & 0x7FFFFFFF;
+  if (abs_u < 0x38800000) {
+    return sign;
+  }
+  if (abs_u >= 0x477FF000) {
+    return sign | 0x7BFF;
+  }
+  return sign | ((abs_u - 0x38000000 + 0x1000) >> 13);
+}
+
+ccl_device_inline float half_bits_to_float(const uint h)
+{
+  const uint sign = (h & 0x8000) << 16;
+  const uint abs_h = h & 0x7FFF;
+  return __uint_as_float((abs_h == 0) ? sign : sign | ((abs_h << 13) + 0x38000000));
+}
+
+ccl_device_inline uint float2_to_half2_packed(const float2 f)
+{
+  return float_to_half_bits(f.x) | (float_to_half_bits(f.y) << 16);
+}
+
+ccl_device_inline float2 half2_packed_to_float2(const uint packed)
+{
+  return make_float2(half_bits_to_float(packed & 0xFFFF), half_bits_to_float(packed >> 16));
+}
+
 /* Conversion to half float texture for display.
  *
  * Simplified float to half for fast display texture conversion on processors
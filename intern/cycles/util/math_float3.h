@@ -625,4 +625,41 @@ ccl_device_inline float2 map_to_sphere(const float3 co)
   return make_float2(u, v);
 }
 
+/* Octahedral encoding of a unit vector into two 16-bit signed normalized values, used for
+ * compact storage of normals. */
+ccl_device_inline uint float3_to_octahedral_packed(const float3 n)
+{
+  const float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+  if (l1 == 0.0f) {
+    return 0;
+  }
+
+  float u = n.x / l1;
+  float v = n.y / l1;
+  if (n.z < 0.0f) {
+    /* Fold the lower hemisphere over the diagonals. */
+    const float u_fold = (1.0f - fabsf(v)) * ((u >= 0.0f) ? 1.0f : -1.0f);
+    const float v_fold = (1.0f - fabsf(u)) * ((v >= 0.0f) ? 1.0f : -1.0f);
+    u = u_fold;
+    v = v_fold;
+  }
+
+  const int iu = (int)roundf(clamp(u, -1.0f, 1.0f) * 32767.0f);
+  const int iv = (int)roundf(clamp(v, -1.0f, 1.0f) * 32767.0f);
+  return ((uint)iu & 0xFFFF) | ((uint)iv << 16);
+}
+
+ccl_device_inline float3 octahedral_packed_to_float3(const uint packed)
+{
+  /* Sign extend both 16-bit values. */
+  const float u = (float)((int)(packed << 16) >> 16) * (1.0f / 32767.0f);
+  const float v = (float)((int)packed >> 16) * (1.0f / 32767.0f);
+
+  float3 n = make_float3(u, v, 1.0f - fabsf(u) - fabsf(v));
+  const float t = max(-n.z, 0.0f);
+  n.x += (n.x >= 0.0f) ? -t : t;
+  n.y += (n.y >= 0.0f) ? -t : t;
+  return normalize(n);
+}
+
 CCL_NAMESPACE_END
@@ -1034,4 +1034,59 @@ void path_cache_kernel_mark_added_and_clear_old(const string &new_path,
   }
 }
 
+/* LRU Cache of Limited Size */
+
+void path_cache_mark_used(const string &path)
+{
+  path_cache_kernel_mark_used(path);
+}
+
+void path_cache_mark_added_and_clear_to_size(const string &new_path, const size_t max_size)
+{
+  path_cache_kernel_mark_used(new_path);
+
+  const string dir = path_dirname(new_path);
+  if (!path_exists(dir)) {
+    return;
+  }
+
+  directory_iterator it(dir);
+  const directory_iterator it_end;
+  vector<pair<std::time_t, string>> old_files;
+  size_t total_size = path_file_size(new_path);
+
+  for (; it != it_end; ++it) {
+    const string &path = it->path();
+    /* Skip the new file, and temporary files that other processes are still writing. */
+    if (path == new_path || path_is_directory(path) || string_endswith(path, ".tmp")) {
+      continue;
+    }
+
+    const size_t size = path_file_size(path);
+    if (size == size_t(-1)) {
+      continue;
+    }
+
+    total_size += size;
+    old_files.emplace_back(OIIO::Filesystem::last_write_time(path), path);
+  }
+
+  if (total_size <= max_size) {
+    return;
+  }
+
+  sort(old_files.begin(), old_files.end());
+
+  for (const pair<std::time_t, string> &old_file : old_files) {
+    if (total_size <= max_size) {
+      break;
+    }
+
+    const size_t size = path_file_size(old_file.second);
+    if (path_remove(old_file.second)) {
+      total_size = (size < total_size) ? total_size - size : 0;
+    }
+  }
+}
+
 CCL_NAMESPACE_END
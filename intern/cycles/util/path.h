@@ -66,4 +66,11 @@ bool path_cache_kernel_exists_and_mark_used(const string &path);
 void path_cache_kernel_mark_added_and_clear_old(const string &path,
                                                 const size_t max_old_kernel_of_same_type = 5);
 
+/* Least-recently-used cache of files limited in total size.
+ *
+ * Whenever a file is used, its last modified time is updated. When a new file is added, the least
+ * recently used files in the same directory are removed until it fits in the maximum size. */
+void path_cache_mark_used(const string &path);
+void path_cache_mark_added_and_clear_to_size(const string &path, const size_t max_size);
+
 CCL_NAMESPACE_END
@@ -12,7 +12,7 @@ class Stats {
  public:
   enum static_init_t { static_init = 0 };
 
-  Stats() : mem_used(0), mem_peak(0) {}
+  Stats() : mem_used(0), mem_peak(0), mem_copied(0) {}
   explicit Stats(static_init_t /*unused*/) {}
 
   void mem_alloc(const size_t size)
@@ -27,8 +27,15 @@ class Stats {
     atomic_sub_and_fetch_z(&mem_used, size);
   }
 
+  void mem_copy(const size_t size)
+  {
+    atomic_add_and_fetch_z(&mem_copied, size);
+  }
+
   size_t mem_used;
   size_t mem_peak;
+  /* Total bytes copied from host to device memory. */
+  size_t mem_copied;
 };
 
 CCL_NAMESPACE_END
@@ -41,6 +41,7 @@ enum ImageDataType {
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
   IMAGE_DATA_TYPE_NANOVDB_FPN = 10,
   IMAGE_DATA_TYPE_NANOVDB_FP16 = 11,
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 12,
 
   IMAGE_DATA_NUM_TYPES
 };
@@ -90,4 +91,22 @@ struct TextureInfo {
   Transform transform_3d = transform_zero();
 };
 
+#ifndef __KERNEL_GPU__
+/* Data of #IMAGE_DATA_TYPE_TEXTURE_CACHE textures, which are not loaded into memory up front
+ * but looked up through a texture cache on the host. Only supported by the CPU device. */
+struct TextureCacheHandle {
+  void *texture_system;
+  void *texture_handle;
+  int channels;
+
+  /* Filtered lookup, where the derivatives of the texture coordinates select the mip level. */
+  float4 (*lookup)(const TextureCacheHandle &handle,
+                   const TextureInfo &info,
+                   const float x,
+                   const float y,
+                   const float2 dx,
+                   const float2 dy);
+};
+#endif
+
 CCL_NAMESPACE_END
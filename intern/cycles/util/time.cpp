@@ -4,9 +4,11 @@
 
 #include "util/time.h"
 
+#include <cstdint>
 #include <cstdlib>
 
 #if !defined(_WIN32)
+#  include <ctime>
 #  include <sys/time.h>
 #  include <unistd.h>
 #endif
@@ -34,6 +36,21 @@ void time_sleep(const double t)
 {
   Sleep((int)(t * 1000));
 }
+
+double time_process_cpu()
+{
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+  {
+    return 0.0;
+  }
+
+  /* Both times are in 100 nanosecond intervals. */
+  const uint64_t kernel = (uint64_t(kernel_time.dwHighDateTime) << 32) |
+                          kernel_time.dwLowDateTime;
+  const uint64_t user = (uint64_t(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+  return (kernel + user) * 1e-7;
+}
 #else
 double time_dt()
 {
@@ -62,6 +79,16 @@ void time_sleep(double t)
     usleep(us);
   }
 }
+
+double time_process_cpu()
+{
+  struct timespec now;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0) {
+    return 0.0;
+  }
+
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
 #endif
 
 /* Time in format "hours:minutes:seconds.hundreds" */
@@ -18,6 +18,10 @@ double time_dt();
 
 void time_sleep(const double t);
 
+/* Give CPU time used by all threads of the process in seconds. */
+
+double time_process_cpu();
+
 /* Scoped timer. */
 
 class scoped_timer {
@@ -806,6 +806,13 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
         col.prop(system, "vbo_time_out", text="VBO Time Out")
         col.prop(system, "vbo_collection_rate", text="Garbage Collection Rate")
 
+        # Only available when the OpenVDB library was built with delayed loading.
+        if bpy.app.build_options.openvdb_delayed_loading:
+            layout.separator()
+
+            col = layout.column()
+            col.prop(system, "use_volume_delay_load")
+
         if sys.platform != "darwin":
             layout.separator()
             col = layout.column()
@@ -2871,6 +2878,7 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
                 ({"property": "use_new_curves_tools"}, ("blender/blender/issues/68981", "#68981")),
                 ({"property": "use_new_pointcloud_type"}, ("blender/blender/issues/75717", "#75717")),
                 ({"property": "use_sculpt_texture_paint"}, ("blender/blender/issues/96225", "#96225")),
+                ({"property": "use_delta_blend_save"}, None),
             ),
         )
 
@@ -34,6 +34,12 @@ struct BakeMaterialsList;
 
 void BKE_volumes_init();
 
+/**
+ * Whether the OpenVDB library supports delayed loading of files, which is required for
+ * #USER_VOLUME_DELAY_LOAD.
+ */
+bool BKE_volume_delay_load_supported();
+
 /* Data-block Management */
 
 void BKE_volume_init_grids(Volume *volume);
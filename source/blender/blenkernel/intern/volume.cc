@@ -129,6 +129,15 @@ void BKE_volumes_init()
 #endif
 }
 
+bool BKE_volume_delay_load_supported()
+{
+#if defined(WITH_OPENVDB) && defined(OPENVDB_USE_DELAYED_LOADING)
+  return true;
+#else
+  return false;
+#endif
+}
+
 /* Volume datablock */
 
 static void volume_init_data(ID *id)
@@ -7,10 +7,13 @@
 #  include "BKE_volume_grid_file_cache.hh"
 #  include "BKE_volume_openvdb.hh"
 
+#  include "BLI_fileops.h"
 #  include "BLI_map.hh"
 #  include "BLI_memory_cache.hh"
 #  include "BLI_memory_counter.hh"
 
+#  include "DNA_userdef_types.h"
+
 #  include <openvdb/openvdb.h>
 
 namespace blender::bke::volume_grid::file_cache {
@@ -118,6 +121,21 @@ static FileCache create_file_cache(const StringRef file_path)
   return file_cache;
 }
 
+/**
+ * With delayed loading, only the topology of a tree is read when the grid is loaded. The file is
+ * memory mapped and the voxel data of leaf nodes is only read when it is accessed. This is much
+ * faster when only parts of large files are used, but has poor performance on network drives, so
+ * it is only used when enabled in the preferences.
+ */
+static bool use_delay_load()
+{
+#  ifdef OPENVDB_USE_DELAYED_LOADING
+  return (U.flag & USER_VOLUME_DELAY_LOAD) != 0;
+#  else
+  return false;
+#  endif
+}
+
 static FileCache &get_file_cache(const StringRef file_path)
 {
   GlobalCache &global_cache = get_global_cache();
@@ -128,20 +146,34 @@ static FileCache &get_file_cache(const StringRef file_path)
 }
 
 /**
- * Identifies a grid in the global memory cache.
+ * Identifies a grid in the global memory cache. The modification time and size of the file are
+ * part of the key, so that a file that is written again is read again instead of using grids
+ * that were read from the old file. This matters most for delay loaded grids, which keep reading
+ * from the memory mapped file, which would fail when the file is written in place.
  */
 class GridReadKey : public GenericKey {
  public:
   std::string file_path;
   std::string grid_name;
   int simplify_level;
+  bool delay_load;
+  int64_t file_modified_time;
+  int64_t file_size;
 
   uint64_t hash() const override
   {
-    return get_default_hash(this->file_path, this->grid_name, this->simplify_level);
+    return get_default_hash(
+        get_default_hash(this->file_path, this->grid_name, this->simplify_level, this->delay_load),
+        get_default_hash(this->file_modified_time, this->file_size));
   }
 
-  BLI_STRUCT_EQUALITY_OPERATORS_3(GridReadKey, file_path, grid_name, simplify_level)
+  friend bool operator==(const GridReadKey &a, const GridReadKey &b)
+  {
+    return a.file_path == b.file_path && a.grid_name == b.grid_name &&
+           a.simplify_level == b.simplify_level && a.delay_load == b.delay_load &&
+           a.file_modified_time == b.file_modified_time && a.file_size == b.file_size;
+  }
+  BLI_STRUCT_DERIVED_UNEQUAL_OPERATOR(GridReadKey)
 
   bool equal_to(const GenericKey &other) const override
   {
@@ -164,12 +196,17 @@ class GridReadValue : public memory_cache::CachedValue {
  public:
   ImplicitSharingPtr<> tree_sharing_info;
   openvdb::GridBase::Ptr grid;
+  /** True when leaf buffers of the tree are only read from the file once they are accessed. */
+  bool delay_loaded = false;
 
   void count_memory(MemoryCounter &memory) const override
   {
     /* Avoid computing the amount of memory from scratch every time. */
     if (bytes_ == 0) {
-      this->bytes_ = grid->baseTree().memUsage();
+      /* With delayed loading, leaf buffers are read while the grid is used, which the cache is
+       * not notified about. Count the memory of the fully loaded tree up front instead. */
+      this->bytes_ = this->delay_loaded ? grid->baseTree().memUsageIfLoaded() :
+                                          grid->baseTree().memUsage();
     }
     memory.add(bytes_);
   }
@@ -180,14 +217,13 @@ class GridReadValue : public memory_cache::CachedValue {
  * and the tree.
  */
 static openvdb::GridBase::Ptr load_single_grid_from_disk(const StringRef file_path,
-                                                         const StringRef grid_name)
+                                                         const StringRef grid_name,
+                                                         const bool delay_load)
 {
-  /* Disable delay loading and file copying, this has poor performance
-   * on network drivers. */
-  const bool delay_load = false;
-
   openvdb::io::File file(file_path);
 #  ifdef OPENVDB_USE_DELAYED_LOADING
+  /* Disable file copying, this has poor performance on network drives. With delayed loading, the
+   * leaf buffers are read from the memory mapped original file instead. */
   file.setCopyMaxBytes(0);
 #  endif
   file.open(delay_load);
@@ -206,11 +242,22 @@ static LazyLoadedGrid load_single_grid_from_disk_cached(const StringRef file_pat
   key.file_path = file_path;
   key.grid_name = grid_name;
   key.simplify_level = simplify_level;
+  /* Simplified grids are computed from the full grid and are always fully loaded. */
+  key.delay_load = simplify_level == 0 && use_delay_load();
+  BLI_stat_t file_stat;
+  if (BLI_stat(key.file_path.c_str(), &file_stat) == 0) {
+    key.file_modified_time = int64_t(file_stat.st_mtime);
+    key.file_size = int64_t(file_stat.st_size);
+  }
+  else {
+    key.file_modified_time = 0;
+    key.file_size = 0;
+  }
 
   std::shared_ptr<const GridReadValue> value = memory_cache::get<GridReadValue>(key, [&key]() {
     openvdb::GridBase::Ptr grid;
     if (key.simplify_level == 0) {
-      grid = load_single_grid_from_disk(key.file_path, key.grid_name);
+      grid = load_single_grid_from_disk(key.file_path, key.grid_name, key.delay_load);
     }
     else {
       /* Build the simplified grid from the main grid. */
@@ -223,6 +270,7 @@ static LazyLoadedGrid load_single_grid_from_disk_cached(const StringRef file_pat
     }
     auto value = std::make_unique<GridReadValue>();
     value->grid = std::move(grid);
+    value->delay_loaded = key.delay_load;
     value->tree_sharing_info = OpenvdbTreeSharingInfo::make(value->grid->baseTreePtr());
     return value;
   });
@@ -12,6 +12,8 @@
 
 #include "BLI_fileops.hh"
 #include "BLI_filereader.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #ifdef __BIG_ENDIAN__
 #  include "BLI_endian_switch.h"
@@ -19,6 +21,39 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
+/**
+ * Upper bound of the number of frames kept decompressed ahead of the read position when reading
+ * seekable files with multiple threads. Frames written by Blender are ~1mb, so this bounds the
+ * memory used for prefetching.
+ */
+#define ZSTD_PREFETCH_FRAMES_MAX 16
+
+enum {
+  /** The slot doesn't hold any frame. */
+  ZSTD_SLOT_EMPTY = 0,
+  /** The compressed frame has been read, and a task to decompress it has been pushed. */
+  ZSTD_SLOT_QUEUED,
+  /** A thread is decompressing the frame. */
+  ZSTD_SLOT_RUNNING,
+  /** The frame has been decompressed (check #ZstdFrameSlot.is_error). */
+  ZSTD_SLOT_DONE,
+};
+
+/** A frame that is decompressed ahead of time by the task pool. */
+struct ZstdFrameSlot {
+  int frame;
+  /** One of the `ZSTD_SLOT_` values, only changes atomically or while holding the mutex. */
+  int32_t state;
+  bool is_error;
+
+  char *compressed_data;
+  size_t compressed_size;
+  char *uncompressed_data;
+  size_t uncompressed_size;
+};
+
 struct ZstdReader {
   FileReader reader;
 
@@ -36,6 +71,22 @@ struct ZstdReader {
     char *cached_content;
     int cached_frame;
   } seek;
+
+  /**
+   * Ring of frames decompressed in parallel, only used for seekable files when more than one
+   * thread is available. Frame `i` is always stored in `slots[i % slots_num]`, so the frames
+   * following the one being read never evict it.
+   */
+  struct {
+    TaskPool *task_pool;
+    ThreadMutex mutex;
+    ThreadCondition condition;
+
+    ZstdFrameSlot *slots;
+    int slots_num;
+    /** The most recently requested frame, used to only prefetch on forward reading. */
+    int last_frame;
+  } prefetch;
 };
 
 static bool zstd_read_u32(FileReader *base, uint32_t *val)
@@ -198,6 +249,184 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
   return uncompressed_data;
 }
 
+static void zstd_slot_decompress(ZstdReader *zstd, ZstdFrameSlot *slot)
+{
+  size_t res = ZSTD_decompress(slot->uncompressed_data,
+                               slot->uncompressed_size,
+                               slot->compressed_data,
+                               slot->compressed_size);
+  MEM_freeN(slot->compressed_data);
+  slot->compressed_data = nullptr;
+
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  slot->is_error = ZSTD_isError(res) || res < slot->uncompressed_size;
+  atomic_cas_int32(&slot->state, ZSTD_SLOT_RUNNING, ZSTD_SLOT_DONE);
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+  BLI_condition_notify_all(&zstd->prefetch.condition);
+}
+
+/**
+ * Take ownership of decompressing a queued frame.
+ * Whoever comes first (the task or a reader waiting for the frame) does the work, this way
+ * waiting for a frame never depends on the task scheduler having a free thread.
+ */
+static bool zstd_slot_claim(ZstdFrameSlot *slot)
+{
+  return atomic_cas_int32(&slot->state, ZSTD_SLOT_QUEUED, ZSTD_SLOT_RUNNING) == ZSTD_SLOT_QUEUED;
+}
+
+static void zstd_slot_decompress_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReader *zstd = static_cast<ZstdReader *>(BLI_task_pool_user_data(pool));
+  ZstdFrameSlot *slot = static_cast<ZstdFrameSlot *>(taskdata);
+  if (zstd_slot_claim(slot)) {
+    zstd_slot_decompress(zstd, slot);
+  }
+}
+
+/* Block until the frame in the slot (if any) is decompressed. */
+static void zstd_slot_wait(ZstdReader *zstd, ZstdFrameSlot *slot)
+{
+  if (zstd_slot_claim(slot)) {
+    zstd_slot_decompress(zstd, slot);
+    return;
+  }
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  while (ELEM(atomic_load_int32(&slot->state), ZSTD_SLOT_QUEUED, ZSTD_SLOT_RUNNING)) {
+    BLI_condition_wait(&zstd->prefetch.condition, &zstd->prefetch.mutex);
+  }
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+}
+
+static void zstd_slot_clear(ZstdFrameSlot *slot)
+{
+  BLI_assert(!ELEM(slot->state, ZSTD_SLOT_QUEUED, ZSTD_SLOT_RUNNING));
+  MEM_SAFE_FREE(slot->compressed_data);
+  MEM_SAFE_FREE(slot->uncompressed_data);
+  slot->frame = -1;
+  slot->state = ZSTD_SLOT_EMPTY;
+  slot->is_error = false;
+}
+
+/**
+ * Read the compressed frame from the base file and push a task decompressing it.
+ * Must only be called from the thread reading the file, since the base reader isn't thread-safe.
+ */
+static bool zstd_slot_schedule(ZstdReader *zstd, ZstdFrameSlot *slot, int frame)
+{
+  zstd_slot_clear(slot);
+
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                             zstd->seek.uncompressed_ofs[frame];
+
+  char *compressed_data = static_cast<char *>(MEM_mallocN(compressed_size, __func__));
+  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
+  {
+    MEM_freeN(compressed_data);
+    return false;
+  }
+
+  slot->frame = frame;
+  slot->compressed_data = compressed_data;
+  slot->compressed_size = compressed_size;
+  slot->uncompressed_data = static_cast<char *>(MEM_mallocN(uncompressed_size, __func__));
+  slot->uncompressed_size = uncompressed_size;
+  slot->state = ZSTD_SLOT_QUEUED;
+
+  BLI_task_pool_push(zstd->prefetch.task_pool, zstd_slot_decompress_task, slot, false, nullptr);
+  return true;
+}
+
+/* Decompress the frames following the given one in the background, as far as the ring allows. */
+static void zstd_prefetch_frames(ZstdReader *zstd, int frame)
+{
+  const int frame_end = std::min(frame + zstd->prefetch.slots_num, zstd->seek.frames_num);
+  for (int next_frame = frame + 1; next_frame < frame_end; next_frame++) {
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[next_frame % zstd->prefetch.slots_num];
+    if (slot->frame == next_frame) {
+      continue;
+    }
+    if (ELEM(atomic_load_int32(&slot->state), ZSTD_SLOT_QUEUED, ZSTD_SLOT_RUNNING)) {
+      /* Don't block on frames nobody needs anymore, try again on the next read. */
+      continue;
+    }
+    if (!zstd_slot_schedule(zstd, slot, next_frame)) {
+      break;
+    }
+  }
+}
+
+/* Same as #zstd_ensure_cache, but serving frames from the ring of prefetched frames. */
+static const char *zstd_ensure_prefetched(ZstdReader *zstd, int frame)
+{
+  ZstdFrameSlot *slot = &zstd->prefetch.slots[frame % zstd->prefetch.slots_num];
+
+  if (slot->frame != frame) {
+    /* Not prefetched, the slot may still be used by a frame that isn't needed anymore. */
+    zstd_slot_wait(zstd, slot);
+    if (!zstd_slot_schedule(zstd, slot, frame)) {
+      zstd_slot_clear(slot);
+      return nullptr;
+    }
+  }
+
+  /* Only read ahead when reading forward, seeking back is typical for on-demand reading of
+   * blocks that were skipped before, and won't continue reading sequentially from there. */
+  if (frame > zstd->prefetch.last_frame) {
+    zstd_prefetch_frames(zstd, frame);
+  }
+  zstd->prefetch.last_frame = frame;
+
+  zstd_slot_wait(zstd, slot);
+  if (slot->is_error) {
+    zstd_slot_clear(slot);
+    return nullptr;
+  }
+  return slot->uncompressed_data;
+}
+
+static void zstd_prefetch_init(ZstdReader *zstd)
+{
+  /* Waiting for a frame never depends on other threads (see #zstd_slot_claim), but prefetching
+   * only makes sense when there are other threads to do the work. */
+  const int threads_num = BLI_task_scheduler_num_threads();
+  if (threads_num <= 1 || zstd->seek.frames_num <= 1) {
+    return;
+  }
+
+  zstd->prefetch.slots_num = std::min(2 * threads_num, ZSTD_PREFETCH_FRAMES_MAX);
+  zstd->prefetch.slots = MEM_calloc_arrayN<ZstdFrameSlot>(zstd->prefetch.slots_num, __func__);
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    zstd->prefetch.slots[i].frame = -1;
+  }
+  zstd->prefetch.last_frame = -1;
+
+  BLI_mutex_init(&zstd->prefetch.mutex);
+  BLI_condition_init(&zstd->prefetch.condition);
+  zstd->prefetch.task_pool = BLI_task_pool_create(zstd, TASK_PRIORITY_HIGH);
+}
+
+static void zstd_prefetch_free(ZstdReader *zstd)
+{
+  if (zstd->prefetch.task_pool == nullptr) {
+    return;
+  }
+
+  /* Tasks for slots that were claimed by the reader return immediately. */
+  BLI_task_pool_work_and_wait(zstd->prefetch.task_pool);
+  BLI_task_pool_free(zstd->prefetch.task_pool);
+
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    zstd_slot_clear(&zstd->prefetch.slots[i]);
+  }
+  MEM_freeN(zstd->prefetch.slots);
+
+  BLI_mutex_end(&zstd->prefetch.mutex);
+  BLI_condition_end(&zstd->prefetch.condition);
+}
+
 static int64_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
 {
   ZstdReader *zstd = (ZstdReader *)reader;
@@ -210,7 +439,8 @@ static int64_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
       break;
     }
 
-    const char *framedata = zstd_ensure_cache(zstd, frame);
+    const char *framedata = (zstd->prefetch.task_pool) ? zstd_ensure_prefetched(zstd, frame) :
+                                                         zstd_ensure_cache(zstd, frame);
     if (framedata == nullptr) {
       /* Error while reading the frame, so return as much as we can. */
       break;
@@ -286,6 +516,7 @@ static void zstd_close(FileReader *reader)
 
   ZSTD_freeDCtx(zstd->ctx);
   if (zstd->reader.seek) {
+    zstd_prefetch_free(zstd);
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
     /* When an error has occurred this may be nullptr, see: #99744. */
@@ -311,6 +542,8 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+
+    zstd_prefetch_init(zstd);
   }
   else {
     zstd->reader.read = zstd_read;
@@ -0,0 +1,131 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <cstring>
+#include <zstd.h>
+
+#include "testing/testing.h"
+
+#include "BLI_filereader.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+namespace blender::tests {
+
+static void append_u32(Vector<char> &data, const uint32_t value)
+{
+  char bytes[sizeof(uint32_t)];
+  memcpy(bytes, &value, sizeof(uint32_t));
+  data.extend(bytes, sizeof(uint32_t));
+}
+
+/**
+ * Compress the content into independent frames of varying size followed by a seek table, the
+ * same format as written by Blender for compressed files.
+ */
+static Vector<char> zstd_compress_seekable(const Span<char> content, const int frames_num)
+{
+  Vector<char> file;
+  Vector<std::pair<uint32_t, uint32_t>> frame_sizes;
+  int64_t offset = 0;
+  for (const int frame : IndexRange(frames_num)) {
+    const int64_t frame_end = (frame == frames_num - 1) ?
+                                  content.size() :
+                                  (content.size() * (frame + 1) / frames_num) + (frame % 3) * 17;
+    const Span<char> src = content.slice(offset, frame_end - offset);
+    Vector<char> dst(ZSTD_compressBound(src.size()));
+    const size_t compressed_size = ZSTD_compress(
+        dst.data(), dst.size(), src.data(), src.size(), 3);
+    EXPECT_FALSE(ZSTD_isError(compressed_size));
+    file.extend(dst.as_span().take_front(compressed_size));
+    frame_sizes.append({uint32_t(compressed_size), uint32_t(src.size())});
+    offset = frame_end;
+  }
+
+  append_u32(file, 0x184D2A5E);
+  append_u32(file, frames_num * 8 + 9);
+  for (const std::pair<uint32_t, uint32_t> &sizes : frame_sizes) {
+    append_u32(file, sizes.first);
+    append_u32(file, sizes.second);
+  }
+  append_u32(file, frames_num);
+  file.append(0);
+  append_u32(file, 0x8F92EAB1);
+  return file;
+}
+
+static void expect_read(FileReader *reader,
+                        const Span<char> content,
+                        const int64_t offset,
+                        const int64_t size)
+{
+  ASSERT_EQ(reader->seek(reader, offset, SEEK_SET), offset);
+  Vector<char> buffer(size);
+  const int64_t expected_size = std::min(size, content.size() - offset);
+  ASSERT_EQ(reader->read(reader, buffer.data(), size), expected_size);
+  EXPECT_TRUE(buffer.as_span().take_front(expected_size) == content.slice(offset, expected_size));
+}
+
+/**
+ * Read the whole content forward in pieces that don't line up with the frames, then jump back
+ * and forth, which reuses or discards frames that were decompressed ahead of time.
+ */
+static void test_zstd_seekable_read(const int frames_num)
+{
+  Vector<char> content(1000000);
+  for (const int64_t i : content.index_range()) {
+    content[i] = char((i * 7) ^ (i >> 9));
+  }
+  const Vector<char> file = zstd_compress_seekable(content, frames_num);
+
+  FileReader *reader = BLI_filereader_new_zstd(
+      BLI_filereader_new_memory(file.data(), file.size()));
+  ASSERT_NE(reader, nullptr);
+  ASSERT_NE(reader->seek, nullptr);
+
+  Vector<char> result;
+  Vector<char> buffer(12345);
+  while (true) {
+    const int64_t read_size = reader->read(reader, buffer.data(), buffer.size());
+    ASSERT_GE(read_size, 0);
+    if (read_size == 0) {
+      break;
+    }
+    result.extend(buffer.as_span().take_front(read_size));
+  }
+  EXPECT_TRUE(result.as_span() == content.as_span());
+
+  expect_read(reader, content, 0, 100);
+  expect_read(reader, content, 900000, 50000);
+  expect_read(reader, content, 10000, 300000);
+  expect_read(reader, content, 5000, 10);
+  expect_read(reader, content, 990000, 20000);
+  expect_read(reader, content, 400000, 600000);
+  expect_read(reader, content, 123456, 1);
+
+  reader->close(reader);
+}
+
+TEST(filereader, ZstdSeekable)
+{
+  test_zstd_seekable_read(1);
+  test_zstd_seekable_read(40);
+}
+
+TEST(filereader, ZstdSeekablePrefetch)
+{
+  /* Frames are only decompressed ahead of time when the task scheduler has multiple threads. */
+  BLI_system_num_threads_override_set(4);
+  BLI_task_scheduler_init();
+
+  test_zstd_seekable_read(2);
+  test_zstd_seekable_read(40);
+
+  BLI_task_scheduler_exit();
+  BLI_system_num_threads_override_set(0);
+  BLI_task_scheduler_init();
+}
+
+}  // namespace blender::tests
@@ -52,6 +52,11 @@ enum {
    * (written to #BLENDER_STARTUP_FILE & #BLENDER_USERPREF_FILE).
    */
   BLO_CODE_USER = BLEND_MAKE_ID('U', 'S', 'E', 'R'),
+  /**
+   * Index of the blocks in use, written right before #ENDB when only the changes were appended
+   * to an existing file (see #BlendFileWriteParams.use_delta_save).
+   */
+  BLO_CODE_DLTI = BLEND_MAKE_ID('D', 'L', 'T', 'I'),
   /**
    * Terminate reading (no data).
    */
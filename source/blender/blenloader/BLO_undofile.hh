@@ -17,6 +17,8 @@ namespace blender {
 class ImplicitSharingInfo;
 }
 struct Main;
+struct MemFileChunkBuffer;
+struct MemFileChunkStore;
 struct Scene;
 
 struct MemFileSharedStorage {
@@ -30,10 +32,14 @@ struct MemFileSharedStorage {
 
 struct MemFileChunk {
   void *next, *prev;
-  const char *buf;
+  /**
+   * Reference counted storage of the chunk data. It may be shared with other chunks with the same
+   * content, and compressed while the chunk is not used by recent undo steps.
+   */
+  MemFileChunkBuffer *buffer;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the matching #MemFileChunk of the previous step. */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -52,6 +58,11 @@ struct MemFile {
    * without making a copy. This is faster and requires less memory.
    */
   MemFileSharedStorage *shared_storage;
+  /**
+   * Content based storage of the chunk buffers, shared by all the memfiles written with each other
+   * as reference (i.e. all the steps of an undo stack).
+   */
+  MemFileChunkStore *chunk_store;
 };
 
 struct MemFileWriteData {
@@ -107,6 +118,11 @@ void BLO_memfile_merge(MemFile *first, MemFile *second);
  * Clear is_identical_future before adding next memfile.
  */
 void BLO_memfile_clear_future(MemFile *memfile);
+/**
+ * Memory used by the chunks owned by this memfile. This is #MemFile.size, which may be reduced
+ * in the background while chunks that are not used by recent steps are compressed.
+ */
+size_t BLO_memfile_size_get(const MemFile *memfile);
 
 /* Utilities. */
 
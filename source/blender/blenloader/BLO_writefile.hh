@@ -44,6 +44,14 @@ struct BlendFileWriteParams {
   /** On write, restore paths after editing them (see #BLO_WRITE_PATH_REMAP_RELATIVE). */
   uint use_save_as_copy : 1;
   uint use_userdef : 1;
+  /**
+   * When saving an uncompressed file that was saved with this option before in the same session,
+   * only append the changed data to it, followed by an index of the data in use.
+   *
+   * \note Blender versions without support for this read such files as they were when first
+   * saved, #BLO_write_file_compact turns them into regular files.
+   */
+  uint use_delta_save : 1;
   const BlendThumbnail *thumb;
 };
 
@@ -61,4 +69,17 @@ extern bool BLO_write_file(Main *mainvar,
  */
 extern bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, int write_flags);
 
+/**
+ * Rewrite a file saved with #BlendFileWriteParams.use_delta_save to a regular file, leaving out
+ * the outdated data. Other files are left unchanged.
+ *
+ * \return Success.
+ */
+extern bool BLO_write_file_compact(const char *filepath, ReportList *reports);
+
+/**
+ * Register the `compact_blend` command (see #BLO_write_file_compact).
+ */
+void BLO_write_file_compact_command_register();
+
 /** \} */
@@ -1072,6 +1072,184 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
   return false;
 }
 
+/**
+ * Read the #BLO_CODE_DLTI block at \a index_offset, and replace the list of blocks with the
+ * groups of blocks it refers to, followed by the #BLO_CODE_ENDB block written after the index.
+ */
+static bool read_file_delta_index_apply(FileData *fd, const off64_t index_offset)
+{
+  BLI_freelistN(&fd->bhead_list);
+  fd->is_eof = false;
+
+  if (fd->file->seek(fd->file, index_offset, SEEK_SET) == -1) {
+    return false;
+  }
+  BHeadN *index_bhead = get_bhead(fd);
+  const off64_t endb_offset = fd->file->offset;
+  BHeadN *endb_bhead = get_bhead(fd);
+  if (index_bhead == nullptr || endb_bhead == nullptr ||
+      index_bhead->bhead.code != BLO_CODE_DLTI || endb_bhead->bhead.code != BLO_CODE_ENDB ||
+      index_bhead->bhead.len < int(sizeof(BlendDeltaIndexTail)))
+  {
+    return false;
+  }
+
+  const int64_t entries_size = index_bhead->bhead.len - int64_t(sizeof(BlendDeltaIndexTail));
+  BlendDeltaIndexTail tail;
+  memcpy(&tail, POINTER_OFFSET(index_bhead + 1, entries_size), sizeof(tail));
+  if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+    BLI_endian_switch_uint64(&tail.entries_num);
+  }
+  if (memcmp(tail.magic, BLEND_DELTA_INDEX_MAGIC, sizeof(tail.magic)) != 0 ||
+      tail.entries_num != uint64_t(entries_size) / sizeof(BlendDeltaIndexEntry) ||
+      entries_size % sizeof(BlendDeltaIndexEntry) != 0)
+  {
+    return false;
+  }
+
+  blender::Vector<BlendDeltaIndexEntry> index(int64_t(tail.entries_num));
+  memcpy(index.data(), index_bhead + 1, size_t(entries_size));
+  if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+    BLI_endian_switch_uint64_array(reinterpret_cast<uint64_t *>(index.data()), index.size() * 2);
+  }
+  BLI_freelistN(&fd->bhead_list);
+
+  for (const BlendDeltaIndexEntry &entry : index) {
+    const off64_t group_end = off64_t(entry.offset + entry.size);
+    if (fd->file->seek(fd->file, off64_t(entry.offset), SEEK_SET) == -1) {
+      return false;
+    }
+    /* The group starts with an ID (or other non-data block), followed by its data blocks. */
+    bool is_first = true;
+    while (fd->file->offset < group_end) {
+      BHeadN *new_bhead = get_bhead(fd);
+      if (new_bhead == nullptr) {
+        return false;
+      }
+      const int code = new_bhead->bhead.code;
+      if (is_first ? ELEM(code, BLO_CODE_DATA, BLO_CODE_DLTI, BLO_CODE_ENDB) :
+                     code != BLO_CODE_DATA)
+      {
+        return false;
+      }
+      is_first = false;
+    }
+    if (fd->file->offset != group_end) {
+      return false;
+    }
+  }
+
+  if (fd->file->seek(fd->file, endb_offset, SEEK_SET) == -1 || get_bhead(fd) == nullptr) {
+    return false;
+  }
+  fd->delta_index = std::move(index);
+  /* Everything after the end block was read already. */
+  fd->is_eof = true;
+  return true;
+}
+
+/**
+ * When changes were appended to the file (see #BlendDeltaIndexEntry), read the blocks listed by
+ * its last index as if they had been written in one go.
+ *
+ * \param use_recovery: When the file doesn't end with an index, look for the last complete one,
+ * in case appending changes was interrupted. This reads the headers of all blocks up to the first
+ * #BLO_CODE_ENDB, which reading the DNA needs to do anyway.
+ * \return Success if the file is read correctly, else set \a r_error_message.
+ */
+static bool read_file_delta_index(FileData *fd,
+                                  const bool use_recovery,
+                                  ReportList *reports,
+                                  const char **r_error_message)
+{
+  if ((fd->flags & FD_FLAGS_IS_MEMFILE) || fd->file->seek == nullptr) {
+    return true;
+  }
+  BLI_assert(BLI_listbase_is_empty(&fd->bhead_list));
+
+  const off64_t blocks_offset = fd->file->offset;
+  const off64_t bhead_size = (fd->flags & FD_FLAGS_FILE_POINTSIZE_IS_4) ? sizeof(BHead4) :
+                                                                          sizeof(BHead8);
+
+  /* Files with appended changes end with the index followed by the end block. */
+  const off64_t tail_offset = fd->file->seek(
+      fd->file, -(bhead_size + off64_t(sizeof(BlendDeltaIndexTail))), SEEK_END);
+  BlendDeltaIndexTail tail;
+  if (tail_offset > blocks_offset &&
+      fd->file->read(fd->file, &tail, sizeof(tail)) == int64_t(sizeof(tail)) &&
+      memcmp(tail.magic, BLEND_DELTA_INDEX_MAGIC, sizeof(tail.magic)) == 0)
+  {
+    if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+      BLI_endian_switch_uint64(&tail.entries_num);
+    }
+    const uint64_t entries_size = tail.entries_num * sizeof(BlendDeltaIndexEntry);
+    if (tail.entries_num > uint64_t(tail_offset) / sizeof(BlendDeltaIndexEntry) ||
+        !read_file_delta_index_apply(fd, tail_offset - off64_t(entries_size) - bhead_size))
+    {
+      *r_error_message = "Invalid index of the saved changes";
+      return false;
+    }
+    return true;
+  }
+
+  if (fd->file->seek(fd->file, blocks_offset, SEEK_SET) == -1) {
+    *r_error_message = "Failed to seek in file";
+    return false;
+  }
+  if (!use_recovery) {
+    return true;
+  }
+
+  BHeadN *endb_bhead = get_bhead(fd);
+  while (endb_bhead && endb_bhead->bhead.code != BLO_CODE_ENDB) {
+    endb_bhead = get_bhead(fd);
+  }
+  if (endb_bhead == nullptr) {
+    /* A missing end block is reported when reading the DNA. */
+    return true;
+  }
+
+  /* Find the last index that is directly followed by an end block. */
+  off64_t index_offset = -1;
+  off64_t prev_offset = fd->file->offset;
+  int prev_code = BLO_CODE_ENDB;
+  bool has_trailing_data = false;
+  while (true) {
+    const off64_t offset = fd->file->offset;
+    BHeadN *new_bhead = get_bhead(fd);
+    if (new_bhead == nullptr) {
+      break;
+    }
+    has_trailing_data = true;
+    if (new_bhead->bhead.code == BLO_CODE_ENDB && prev_code == BLO_CODE_DLTI) {
+      index_offset = prev_offset;
+    }
+    prev_code = new_bhead->bhead.code;
+    prev_offset = offset;
+  }
+  if (!has_trailing_data) {
+    return true;
+  }
+
+  if (index_offset == -1) {
+    /* Only the first save is complete. */
+    while (endb_bhead->next) {
+      BHeadN *next_bhead = endb_bhead->next;
+      BLI_remlink(&fd->bhead_list, next_bhead);
+      MEM_freeN(next_bhead);
+    }
+  }
+  else if (!read_file_delta_index_apply(fd, index_offset)) {
+    *r_error_message = "Invalid index of the saved changes";
+    return false;
+  }
+  BKE_reportf(reports,
+              RPT_WARNING,
+              "Blend file '%s' ends with incomplete changes, they were ignored",
+              fd->relabase);
+  return true;
+}
+
 static int *read_file_thumbnail(FileData *fd)
 {
   BHead *bhead;
@@ -1192,7 +1370,9 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 
   if (fd->flags & FD_FLAGS_FILE_OK) {
     const char *error_message = nullptr;
-    if (read_file_dna(fd, &error_message) == false) {
+    if (read_file_delta_index(fd, true, reports, &error_message) == false ||
+        read_file_dna(fd, &error_message) == false)
+    {
       BKE_reportf(
           reports, RPT_ERROR, "Failed to read blend file '%s': %s", fd->relabase, error_message);
       blo_filedata_free(fd);
@@ -1460,7 +1640,11 @@ BlendThumbnail *BLO_thumbnail_from_file(const char *filepath)
 
   FileData *fd = blo_filedata_from_file_minimal(filepath);
   if (fd) {
-    if (const int *fd_data = read_file_thumbnail(fd)) {
+    const char *error_message = nullptr;
+    const int *fd_data = read_file_delta_index(fd, false, nullptr, &error_message) ?
+                             read_file_thumbnail(fd) :
+                             nullptr;
+    if (fd_data) {
       const int width = fd_data[0];
       const int height = fd_data[1];
       if (BLEN_THUMB_MEMSIZE_IS_VALID(width, height)) {
@@ -18,6 +18,7 @@
 
 #include "BLI_filereader.h"
 #include "BLI_map.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_sdna_types.h"
 #include "DNA_space_types.h"
@@ -53,6 +54,30 @@ enum eFileDataFlag {
 };
 ENUM_OPERATORS(eFileDataFlag, FD_FLAGS_IS_MEMFILE)
 
+/**
+ * Files saved with #BlendFileWriteParams.use_delta_save start out as regular files. Later saves
+ * append the groups of blocks that changed, a #BLO_CODE_DLTI block listing the groups in use,
+ * and a new #BLO_CODE_ENDB. A group is a block other than #BLO_CODE_DATA (typically an ID)
+ * followed by its #BLO_CODE_DATA blocks.
+ *
+ * The data of the index block is an array of #BlendDeltaIndexEntry followed by
+ * #BlendDeltaIndexTail, which makes it possible to find the index from the end of the file.
+ */
+struct BlendDeltaIndexEntry {
+  /** File offset of the header of the first block in the group. */
+  uint64_t offset;
+  /** Size of all blocks in the group, including their headers. */
+  uint64_t size;
+};
+
+struct BlendDeltaIndexTail {
+  uint64_t entries_num;
+  /** #BLEND_DELTA_INDEX_MAGIC. */
+  char magic[8];
+};
+
+#define BLEND_DELTA_INDEX_MAGIC "BLDELTA1"
+
 /* Disallow since it's 32bit on ms-windows. */
 #ifdef __GNUC__
 #  pragma GCC poison off_t
@@ -131,6 +156,12 @@ struct FileData {
   BHeadSort *bheadmap = nullptr;
   int tot_bheadmap = 0;
 
+  /**
+   * The groups of blocks in use when changes were appended to the file (see #BLO_CODE_DLTI),
+   * in the order they are read. Empty for regular files.
+   */
+  blender::Vector<BlendDeltaIndexEntry> delta_index;
+
   std::optional<blender::Map<blender::StringRefNull, BHead *>> bhead_idname_map;
 
   ListBase *mainlist = nullptr;
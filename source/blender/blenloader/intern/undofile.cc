@@ -19,11 +19,17 @@
 #  include <io.h>
 #endif
 
+#include <xxhash.h>
+#include <zstd.h>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_listBase.h"
 
 #include "BLI_implicit_sharing.hh"
+#include "BLI_map.hh"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -32,21 +38,246 @@
 #include "BKE_main.hh"
 #include "BKE_undo_system.hh"
 
+#include "atomic_ops.h"
+
 #include "BLI_strict_flags.h" /* IWYU pragma: keep. Keep last. */
 
+/* -------------------------------------------------------------------- */
+/** \name Chunk Storage
+ *
+ * Chunk buffers are reference counted and stored by the hash of their content, so that a chunk
+ * which is identical to any chunk of the previous steps reuses its memory, not only the one at
+ * the same position in the previous step (e.g. when toggling some data back and forth).
+ *
+ * Buffers that were not used by the last #MEMFILE_HOT_STEPS steps are compressed in a background
+ * task. Undoing to recent steps never has to decompress anything, older steps are decompressed on
+ * demand when they are read.
+ *
+ * Background compression only runs between the write of a step and the next access to the store,
+ * which always cancels it first. So apart from the memory accounting of the owner #MemFile, the
+ * buffers are never accessed from multiple threads at the same time.
+ * \{ */
+
+/** Number of recent steps for which chunk buffers are kept uncompressed. */
+#define MEMFILE_HOT_STEPS 4
+/** Smaller buffers are not worth compressing. */
+#define MEMFILE_COMPRESS_SIZE_MIN 256
+/** Amount of uncompressed data handled by a single compression task. */
+#define MEMFILE_COMPRESS_TASK_SIZE (4 * 1024 * 1024)
+/** Favor speed, undo pushes should not be slowed down by compression. */
+#define MEMFILE_COMPRESS_LEVEL 1
+
+struct MemFileChunkBuffer {
+  /** Uncompressed data, null while compressed. */
+  char *data;
+  /** Compressed data, null while uncompressed. */
+  void *data_compressed;
+  size_t size;
+  size_t size_compressed;
+  uint64_t hash;
+  /** Number of #MemFileChunk using this buffer. */
+  int users;
+  /** Value of #MemFileChunkStore::step when this buffer was last written or read. */
+  int used_step;
+  /** Compression did not reduce the size enough, don't try again. */
+  bool is_incompressible;
+  /** The memfile accounting for the memory of this buffer in its #MemFile::size, may be null. */
+  MemFile *owner;
+
+  size_t size_stored() const
+  {
+    return data ? size : size_compressed;
+  }
+};
+
+struct MemFileChunkStore {
+  /** Buffers by hash of their content, used to find identical chunks. */
+  blender::Map<uint64_t, MemFileChunkBuffer *> buffers;
+  /** Number of #MemFile using this store. */
+  int users = 0;
+  /** Incremented for every written step. */
+  int step = 0;
+  /** Compression of cold buffers, null when not running. */
+  TaskPool *compress_pool = nullptr;
+};
+
+static void memfile_chunk_store_compress_cancel(MemFileChunkStore *store)
+{
+  if (store->compress_pool) {
+    BLI_task_pool_cancel(store->compress_pool);
+    BLI_task_pool_free(store->compress_pool);
+    store->compress_pool = nullptr;
+  }
+}
+
+static void memfile_chunk_store_compress_task(TaskPool *__restrict pool, void *taskdata)
+{
+  const blender::Vector<MemFileChunkBuffer *> &buffers =
+      *static_cast<const blender::Vector<MemFileChunkBuffer *> *>(taskdata);
+
+  ZSTD_CCtx *ctx = ZSTD_createCCtx();
+  blender::Vector<char> compressed;
+
+  for (MemFileChunkBuffer *buffer : buffers) {
+    if (BLI_task_pool_current_canceled(pool)) {
+      break;
+    }
+    compressed.resize(int64_t(ZSTD_compressBound(buffer->size)));
+    const size_t size_compressed = ZSTD_compressCCtx(ctx,
+                                                     compressed.data(),
+                                                     size_t(compressed.size()),
+                                                     buffer->data,
+                                                     buffer->size,
+                                                     MEMFILE_COMPRESS_LEVEL);
+    if (ZSTD_isError(size_compressed) || size_compressed > buffer->size - buffer->size / 8) {
+      buffer->is_incompressible = true;
+      continue;
+    }
+
+    void *data_compressed = MEM_mallocN(size_compressed, "Chunk buffer compressed");
+    memcpy(data_compressed, compressed.data(), size_compressed);
+    MEM_freeN(buffer->data);
+    buffer->data = nullptr;
+    buffer->data_compressed = data_compressed;
+    buffer->size_compressed = size_compressed;
+
+    if (buffer->owner) {
+      atomic_sub_and_fetch_z(&buffer->owner->size, buffer->size - size_compressed);
+    }
+  }
+
+  ZSTD_freeCCtx(ctx);
+}
+
+static void memfile_chunk_store_compress_task_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<blender::Vector<MemFileChunkBuffer *> *>(taskdata));
+}
+
+/**
+ * Start compressing the buffers that were not used by the recent steps in the background.
+ */
+static void memfile_chunk_store_compress_cold(MemFileChunkStore *store)
+{
+  BLI_assert(store->compress_pool == nullptr);
+
+  blender::Vector<MemFileChunkBuffer *> *task_buffers = nullptr;
+  size_t task_size = 0;
+  for (MemFileChunkBuffer *buffer : store->buffers.values()) {
+    if (buffer->data == nullptr || buffer->is_incompressible ||
+        buffer->size < MEMFILE_COMPRESS_SIZE_MIN ||
+        store->step - buffer->used_step < MEMFILE_HOT_STEPS)
+    {
+      continue;
+    }
+    if (task_buffers == nullptr) {
+      task_buffers = MEM_new<blender::Vector<MemFileChunkBuffer *>>(__func__);
+    }
+    task_buffers->append(buffer);
+    task_size += buffer->size;
+
+    if (task_size >= MEMFILE_COMPRESS_TASK_SIZE) {
+      if (store->compress_pool == nullptr) {
+        store->compress_pool = BLI_task_pool_create_background(store, TASK_PRIORITY_LOW);
+      }
+      BLI_task_pool_push(store->compress_pool,
+                         memfile_chunk_store_compress_task,
+                         task_buffers,
+                         true,
+                         memfile_chunk_store_compress_task_free);
+      task_buffers = nullptr;
+      task_size = 0;
+    }
+  }
+
+  if (task_buffers) {
+    if (store->compress_pool == nullptr) {
+      store->compress_pool = BLI_task_pool_create_background(store, TASK_PRIORITY_LOW);
+    }
+    BLI_task_pool_push(store->compress_pool,
+                       memfile_chunk_store_compress_task,
+                       task_buffers,
+                       true,
+                       memfile_chunk_store_compress_task_free);
+  }
+}
+
+/**
+ * Get the uncompressed data of the buffer, decompressing it if needed.
+ */
+static const char *memfile_chunk_buffer_data_ensure(MemFileChunkStore *store,
+                                                    MemFileChunkBuffer *buffer)
+{
+  BLI_assert(store->compress_pool == nullptr);
+
+  if (buffer->data == nullptr) {
+    char *data = static_cast<char *>(MEM_mallocN(buffer->size, "Chunk buffer"));
+    const size_t size = ZSTD_decompress(
+        data, buffer->size, buffer->data_compressed, buffer->size_compressed);
+    BLI_assert(size == buffer->size);
+    UNUSED_VARS_NDEBUG(size);
+
+    MEM_freeN(buffer->data_compressed);
+    buffer->data = data;
+    buffer->data_compressed = nullptr;
+
+    if (buffer->owner) {
+      buffer->owner->size += buffer->size - buffer->size_compressed;
+    }
+  }
+  /* Keep the data of steps that are being restored uncompressed, as the neighbor steps are likely
+   * to be restored next. */
+  buffer->used_step = store->step;
+  return buffer->data;
+}
+
+static void memfile_chunk_buffer_release(MemFileChunkStore *store,
+                                         MemFileChunkBuffer *buffer,
+                                         const MemFile *memfile)
+{
+  if (buffer->owner == memfile) {
+    buffer->owner = nullptr;
+  }
+  buffer->users--;
+  if (buffer->users > 0) {
+    return;
+  }
+
+  if (store->buffers.lookup_default(buffer->hash, nullptr) == buffer) {
+    store->buffers.remove(buffer->hash);
+  }
+  MEM_SAFE_FREE(buffer->data);
+  MEM_SAFE_FREE(buffer->data_compressed);
+  MEM_freeN(buffer);
+}
+
+/** \} */
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 void BLO_memfile_free(MemFile *memfile)
 {
+  MemFileChunkStore *store = memfile->chunk_store;
+  if (store) {
+    memfile_chunk_store_compress_cancel(store);
+  }
+
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
+    memfile_chunk_buffer_release(store, chunk->buffer, memfile);
     MEM_freeN(chunk);
   }
   MEM_delete(memfile->shared_storage);
   memfile->shared_storage = nullptr;
   memfile->size = 0;
+
+  if (store) {
+    store->users--;
+    if (store->users == 0) {
+      BLI_assert(store->buffers.is_empty());
+      MEM_delete(store);
+    }
+    memfile->chunk_store = nullptr;
+  }
 }
 
 MemFileSharedStorage::~MemFileSharedStorage()
@@ -59,29 +290,18 @@ MemFileSharedStorage::~MemFileSharedStorage()
 
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
-  blender::Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
-
-  /* First, detect all memchunks in second memfile that are not owned by it. */
-  LISTBASE_FOREACH (MemFileChunk *, sc, &second->chunks) {
-    if (sc->is_identical) {
-      buffer_to_second_memchunk.add(sc->buf, sc);
-    }
+  if (first->chunk_store) {
+    memfile_chunk_store_compress_cancel(first->chunk_store);
   }
 
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
-  LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
-    if (!fc->is_identical) {
-      if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc->buf, nullptr)) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
+  /* Buffers are reference counted, so the ones used by the second memfile remain valid when the
+   * first one is freed. Only transfer the accounting of the memory of the buffers owned by the
+   * first memfile (the one we are removing) that are also used by the second memfile. */
+  LISTBASE_FOREACH (MemFileChunk *, sc, &second->chunks) {
+    MemFileChunkBuffer *buffer = sc->buffer;
+    if (buffer->owner == first) {
+      buffer->owner = second;
+      second->size += buffer->size_stored();
     }
   }
 
@@ -95,6 +315,11 @@ void BLO_memfile_clear_future(MemFile *memfile)
   }
 }
 
+size_t BLO_memfile_size_get(const MemFile *memfile)
+{
+  return atomic_load_z(&memfile->size);
+}
+
 void BLO_memfile_write_init(MemFileWriteData *mem_data,
                             MemFile *written_memfile,
                             MemFile *reference_memfile)
@@ -105,6 +330,17 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
                                                               reference_memfile->chunks.first) :
                                                           nullptr;
 
+  MemFileChunkStore *store = reference_memfile ? reference_memfile->chunk_store : nullptr;
+  if (store) {
+    memfile_chunk_store_compress_cancel(store);
+  }
+  else {
+    store = MEM_new<MemFileChunkStore>(__func__);
+  }
+  store->users++;
+  store->step++;
+  written_memfile->chunk_store = store;
+
   /* If we have a reference memfile, we generate a mapping between the session_uid's of the
    * IDs stored in that previous undo step, and its first matching memchunk. This will allow
    * us to easily find the existing undo memory storage of IDs even when some re-ordering in
@@ -124,17 +360,20 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
 {
   mem_data->id_session_uid_mapping.clear();
+
+  memfile_chunk_store_compress_cold(mem_data->written_memfile->chunk_store);
 }
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size)
 {
   MemFile *memfile = mem_data->written_memfile;
+  MemFileChunkStore *store = memfile->chunk_store;
   MemFileChunk **compchunk_step = &mem_data->reference_current_chunk;
 
   MemFileChunk *curchunk = static_cast<MemFileChunk *>(
       MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk"));
   curchunk->size = size;
-  curchunk->buf = nullptr;
+  curchunk->buffer = nullptr;
   curchunk->is_identical = false;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
@@ -147,8 +386,8 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   if (*compchunk_step != nullptr) {
     MemFileChunk *compchunk = *compchunk_step;
     if (compchunk->size == curchunk->size) {
-      if (memcmp(compchunk->buf, buf, size) == 0) {
-        curchunk->buf = compchunk->buf;
+      if (memcmp(memfile_chunk_buffer_data_ensure(store, compchunk->buffer), buf, size) == 0) {
+        curchunk->buffer = compchunk->buffer;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
       }
@@ -157,12 +396,37 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   }
 
   /* not equal... */
-  if (curchunk->buf == nullptr) {
-    char *buf_new = static_cast<char *>(MEM_mallocN(size, "Chunk buffer"));
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+  if (curchunk->buffer == nullptr) {
+    /* Look for the same content anywhere in the previous steps. This is not considered as
+     * identical, since it's not the same data the ID had in the previous step. */
+    const uint64_t hash = XXH3_64bits(buf, size);
+    MemFileChunkBuffer *buffer = store->buffers.lookup_default(hash, nullptr);
+    if (buffer && buffer->size == size &&
+        memcmp(memfile_chunk_buffer_data_ensure(store, buffer), buf, size) == 0)
+    {
+      if (buffer->owner == nullptr) {
+        buffer->owner = memfile;
+        memfile->size += buffer->size_stored();
+      }
+    }
+    else {
+      char *buf_new = static_cast<char *>(MEM_mallocN(size, "Chunk buffer"));
+      memcpy(buf_new, buf, size);
+
+      buffer = MEM_callocN<MemFileChunkBuffer>(__func__);
+      buffer->data = buf_new;
+      buffer->size = size;
+      buffer->hash = hash;
+      buffer->owner = memfile;
+      /* In case of a hash collision, the existing buffer is kept in the store. */
+      store->buffers.add(hash, buffer);
+      memfile->size += size;
+    }
+    curchunk->buffer = buffer;
   }
+
+  curchunk->buffer->users++;
+  curchunk->buffer->used_step = store->step;
 }
 
 Main *BLO_memfile_main_get(MemFile *memfile, Main *bmain, Scene **r_scene)
@@ -240,7 +504,9 @@ static int64_t undo_read(FileReader *reader, void *buffer, size_t size)
         readsize = chunk->size - chunkoffset;
       }
 
-      memcpy(POINTER_OFFSET(buffer, totread), chunk->buf + chunkoffset, readsize);
+      const char *chunk_data = memfile_chunk_buffer_data_ensure(undo->memfile->chunk_store,
+                                                                 chunk->buffer);
+      memcpy(POINTER_OFFSET(buffer, totread), chunk_data + chunkoffset, readsize);
       totread += readsize;
       undo->reader.offset += (off64_t)readsize;
       seek += readsize;
@@ -268,6 +534,11 @@ FileReader *BLO_memfile_new_filereader(MemFile *memfile, int undo_direction)
 {
   UndoReader *undo = static_cast<UndoReader *>(MEM_callocN(sizeof(UndoReader), __func__));
 
+  /* Reading may need to decompress buffers. */
+  if (memfile->chunk_store) {
+    memfile_chunk_store_compress_cancel(memfile->chunk_store);
+  }
+
   undo->memfile = memfile;
   undo->undo_direction = undo_direction;
 
@@ -58,12 +58,17 @@
  *   - #BLENDER_USERPREF_FILE (on UNIX `~/.config/blender/X.X/config/userpref.blend`).
  */
 
+#include <atomic>
 #include <cerrno>
 #include <climits>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -89,19 +94,25 @@
 #include "DNA_sdna_types.h"
 #include "DNA_userdef_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_endian_defines.h"
 #include "BLI_fileops.hh"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_linear_allocator.hh"
 #include "BLI_math_base.h"
 #include "BLI_multi_value_map.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_struct_equality_utils.hh"
+#include "BLI_task.h"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
 #include "BKE_asset.hh"
+#include "BKE_blender_cli_command.hh"
 #include "BKE_blender_version.h"
 #include "BKE_bpath.hh"
 #include "BKE_global.hh" /* For #Global `G`. */
@@ -131,6 +142,7 @@
 
 #include "readfile.hh"
 
+#include <xxhash.h>
 #include <zstd.h>
 
 /* Make preferences read-only. */
@@ -178,6 +190,11 @@ class WriteWrap {
 
   /** Buffer output (we only want when output isn't already buffered). */
   bool use_buf = true;
+  /**
+   * Write to the file directly, instead of a temporary file that replaces the file once writing
+   * succeeded.
+   */
+  bool use_in_place = false;
 };
 
 class RawWriteWrap : public WriteWrap {
@@ -403,10 +420,325 @@ bool ZstdWriteWrap::write(const void *buf, const size_t buf_len)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Delta Write Wrapper (Appends Changes)
+ *
+ * See #BlendFileWriteParams.use_delta_save and #BlendDeltaIndexEntry.
+ * \{ */
+
+/** Identifies the content of a group of blocks. */
+struct DeltaGroupKey {
+  uint64_t hash_low;
+  uint64_t hash_high;
+  uint64_t size;
+
+  uint64_t hash() const
+  {
+    return hash_low;
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_3(DeltaGroupKey, hash_low, hash_high, size)
+};
+
+/** What is known about a file saved with #DeltaWriteWrap earlier in this session. */
+struct DeltaSaveLayout {
+  /** Size and modification time of the file after saving, to detect changes made by others. */
+  int64_t file_size = 0;
+  int64_t file_mtime = 0;
+  /** Size of the data used by the last save, the rest of the file is outdated. */
+  int64_t live_size = 0;
+  /** File offsets of all groups of blocks stored in the file. */
+  blender::Map<DeltaGroupKey, uint64_t> group_offsets;
+};
+
+static std::mutex delta_save_layouts_mutex;
+
+/** Files saved with #DeltaWriteWrap in this session, by file path. */
+static blender::Map<std::string, DeltaSaveLayout> &delta_save_layouts()
+{
+  static blender::Map<std::string, DeltaSaveLayout> layouts;
+  return layouts;
+}
+
+static void delta_save_layout_clear(const char *filepath)
+{
+  std::scoped_lock lock(delta_save_layouts_mutex);
+  delta_save_layouts().remove(filepath);
+}
+
+/**
+ * Writes uncompressed files while splitting the output into groups of blocks. When the file was
+ * written this way before and nobody changed it since, only the groups that are not in the file
+ * yet are appended, followed by an index of the groups in use.
+ *
+ * Groups are identified by a 128 bit hash of their content, the chance of two different groups
+ * matching is negligible compared to the chance of the data getting corrupted on the disk.
+ */
+class DeltaWriteWrap : public WriteWrap {
+  std::string filepath_;
+  DeltaSaveLayout layout_;
+
+  int file_handle_ = -1;
+  /** Where the next write ends up in the file. */
+  uint64_t file_offset_ = 0;
+  bool write_error_ = false;
+
+  /** Remaining bytes of the file header, which starts the output. */
+  size_t header_remaining_ = SIZEOFBLENDERHEADER;
+  /** Header of the block being received and how much of it was received so far. */
+  BHead bhead_ = {};
+  size_t bhead_filled_ = 0;
+  /** Remaining bytes of the data of the block being received. */
+  int64_t data_remaining_ = 0;
+
+  /** The group being received, its content is only kept when appending. */
+  XXH3_state_t *group_hash_state_ = nullptr;
+  uint64_t group_offset_ = 0;
+  uint64_t group_size_ = 0;
+  blender::Vector<uchar> group_data_;
+
+  blender::Vector<BlendDeltaIndexEntry> index_;
+  blender::Set<uint64_t> used_offsets_;
+
+ public:
+  DeltaWriteWrap(const char *filepath, bool use_save_versions);
+  ~DeltaWriteWrap();
+
+  bool open(const char *filepath) override;
+  bool close() override;
+  bool write(const void *buf, size_t buf_len) override;
+
+  /** Remember the layout of the saved file, once it is at its final location. */
+  void store_layout();
+
+ private:
+  void write_to_file(const void *data, size_t size);
+  void block_begin();
+  void group_add(const void *data, size_t size);
+  void group_end();
+  void write_index();
+};
+
+DeltaWriteWrap::DeltaWriteWrap(const char *filepath, const bool use_save_versions)
+    : filepath_(filepath)
+{
+  group_hash_state_ = XXH3_createState();
+
+  std::optional<DeltaSaveLayout> layout;
+  {
+    std::scoped_lock lock(delta_save_layouts_mutex);
+    layout = delta_save_layouts().pop_try(filepath_);
+  }
+  if (!layout) {
+    return;
+  }
+  /* Version backups move the existing file away, so a new one has to be written. */
+  if (use_save_versions && U.versions > 0) {
+    return;
+  }
+  BLI_stat_t st;
+  if (BLI_stat(filepath, &st) == -1 || int64_t(st.st_size) != layout->file_size ||
+      int64_t(st.st_mtime) != layout->file_mtime)
+  {
+    return;
+  }
+  /* Write the whole file again once most of it is outdated. */
+  if (layout->file_size - layout->live_size > layout->live_size) {
+    return;
+  }
+  layout_ = std::move(*layout);
+  use_in_place = true;
+}
+
+DeltaWriteWrap::~DeltaWriteWrap()
+{
+  XXH3_freeState(group_hash_state_);
+}
+
+bool DeltaWriteWrap::open(const char *filepath)
+{
+  if (!use_in_place) {
+    file_handle_ = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+    return file_handle_ != -1;
+  }
+
+  file_handle_ = BLI_open(filepath, O_BINARY + O_WRONLY, 0666);
+  if (file_handle_ == -1) {
+    return false;
+  }
+  /* The file was checked to be unchanged, so its end is known. */
+  if (BLI_lseek(file_handle_, 0, SEEK_END) != layout_.file_size) {
+    ::close(file_handle_);
+    file_handle_ = -1;
+    return false;
+  }
+  file_offset_ = uint64_t(layout_.file_size);
+  return true;
+}
+
+bool DeltaWriteWrap::close()
+{
+  group_data_.clear_and_shrink();
+  return (::close(file_handle_) != -1) && !write_error_;
+}
+
+bool DeltaWriteWrap::write(const void *buf, const size_t buf_len)
+{
+  const uchar *data = static_cast<const uchar *>(buf);
+  size_t remaining = buf_len;
+  while (remaining > 0 && !write_error_) {
+    size_t size;
+    if (header_remaining_ > 0) {
+      size = std::min(remaining, header_remaining_);
+      header_remaining_ -= size;
+      /* When appending, the header of the existing file is used. */
+      if (!use_in_place) {
+        write_to_file(data, size);
+      }
+    }
+    else if (data_remaining_ > 0) {
+      size = size_t(std::min(int64_t(remaining), data_remaining_));
+      data_remaining_ -= int64_t(size);
+      group_add(data, size);
+    }
+    else {
+      size = std::min(remaining, sizeof(BHead) - bhead_filled_);
+      memcpy(reinterpret_cast<uchar *>(&bhead_) + bhead_filled_, data, size);
+      bhead_filled_ += size;
+      if (bhead_filled_ == sizeof(BHead)) {
+        bhead_filled_ = 0;
+        block_begin();
+      }
+    }
+    data += size;
+    remaining -= size;
+  }
+  return !write_error_;
+}
+
+void DeltaWriteWrap::write_to_file(const void *data, const size_t size)
+{
+  if (write_error_) {
+    return;
+  }
+  if (::write(file_handle_, data, size) != size) {
+    write_error_ = true;
+    return;
+  }
+  file_offset_ += size;
+}
+
+void DeltaWriteWrap::block_begin()
+{
+  /* Every block other than data starts a new group. */
+  if (bhead_.code != BLO_CODE_DATA) {
+    group_end();
+  }
+  if (bhead_.code == BLO_CODE_ENDB) {
+    if (use_in_place) {
+      write_index();
+    }
+    write_to_file(&bhead_, sizeof(BHead));
+    return;
+  }
+  group_add(&bhead_, sizeof(BHead));
+  data_remaining_ = bhead_.len;
+}
+
+void DeltaWriteWrap::group_add(const void *data, const size_t size)
+{
+  if (group_size_ == 0) {
+    XXH3_128bits_reset(group_hash_state_);
+    group_offset_ = file_offset_;
+  }
+  XXH3_128bits_update(group_hash_state_, data, size);
+  group_size_ += size;
+  if (use_in_place) {
+    group_data_.extend(static_cast<const uchar *>(data), int64_t(size));
+  }
+  else {
+    write_to_file(data, size);
+  }
+}
+
+void DeltaWriteWrap::group_end()
+{
+  if (group_size_ == 0) {
+    return;
+  }
+  const XXH128_hash_t hash = XXH3_128bits_digest(group_hash_state_);
+  const DeltaGroupKey key = {hash.low64, hash.high64, group_size_};
+
+  if (use_in_place) {
+    /* A group can only be used once, even if there happen to be multiple identical ones. */
+    const uint64_t *offset = layout_.group_offsets.lookup_ptr(key);
+    if (offset && used_offsets_.add(*offset)) {
+      index_.append({*offset, group_size_});
+    }
+    else {
+      index_.append({file_offset_, group_size_});
+      used_offsets_.add(file_offset_);
+      layout_.group_offsets.add_overwrite(key, file_offset_);
+      write_to_file(group_data_.data(), size_t(group_data_.size()));
+    }
+    group_data_.clear();
+  }
+  else {
+    index_.append({group_offset_, group_size_});
+    layout_.group_offsets.add(key, group_offset_);
+  }
+  group_size_ = 0;
+}
+
+void DeltaWriteWrap::write_index()
+{
+  BlendDeltaIndexTail tail = {};
+  tail.entries_num = uint64_t(index_.size());
+  memcpy(tail.magic, BLEND_DELTA_INDEX_MAGIC, sizeof(tail.magic));
+
+  BHead bhead{};
+  bhead.code = BLO_CODE_DLTI;
+  bhead.len = int(index_.as_span().size_in_bytes() + sizeof(tail));
+  write_to_file(&bhead, sizeof(bhead));
+  write_to_file(index_.data(), size_t(index_.as_span().size_in_bytes()));
+  write_to_file(&tail, sizeof(tail));
+}
+
+void DeltaWriteWrap::store_layout()
+{
+  BLI_stat_t st;
+  if (BLI_stat(filepath_.c_str(), &st) == -1) {
+    return;
+  }
+  layout_.file_size = int64_t(st.st_size);
+  layout_.file_mtime = int64_t(st.st_mtime);
+  layout_.live_size = SIZEOFBLENDERHEADER + sizeof(BHead);
+  for (const BlendDeltaIndexEntry &entry : index_) {
+    layout_.live_size += int64_t(entry.size);
+  }
+
+  std::scoped_lock lock(delta_save_layouts_mutex);
+  delta_save_layouts().add_overwrite(filepath_, std::move(layout_));
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Write Data Type & Functions
  * \{ */
 
+/**
+ * Copy of the data passed to every #mywrite call made while serializing a single ID, instead of
+ * writing it, so that IDs can be serialized on multiple threads (see #write_local_ids).
+ *
+ * Passing the recorded calls to #mywrite in order later on gives the exact same buffering as
+ * writing the ID directly, so the file and its compressed frames are identical.
+ */
+struct WriteRecording {
+  blender::LinearAllocator<> allocator;
+  blender::Vector<blender::Span<uchar>> writes;
+};
+
 struct WriteData {
   const SDNA *sdna;
   std::ostream *debug_dst = nullptr;
@@ -462,6 +794,9 @@ struct WriteData {
    * Will be nullptr for UNDO.
    */
   WriteWrap *ww;
+
+  /** When set, #mywrite calls are recorded instead of written. */
+  WriteRecording *recording = nullptr;
 };
 
 struct BlendWriter {
@@ -491,6 +826,14 @@ static WriteData *writedata_new(WriteWrap *ww)
   return wd;
 }
 
+static WriteData *writedata_new_recording(WriteRecording *recording)
+{
+  WriteData *wd = MEM_new<WriteData>(__func__);
+  wd->sdna = DNA_sdna_current_get();
+  wd->recording = recording;
+  return wd;
+}
+
 static void writedata_do_write(WriteData *wd, const void *mem, const size_t memlen)
 {
   if ((wd == nullptr) || wd->validation_data.critical_error || (mem == nullptr) || memlen < 1) {
@@ -559,6 +902,13 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
     return;
   }
 
+  if (wd->recording) {
+    uchar *data = static_cast<uchar *>(wd->recording->allocator.allocate(int64_t(len), 1));
+    memcpy(data, adr, len);
+    wd->recording->writes.append({data, int64_t(len)});
+    return;
+  }
+
 #ifdef USE_WRITE_DATA_LEN
   wd->write_len += len;
 #endif
@@ -1083,6 +1433,169 @@ static void write_id(WriteData *wd, ID *id)
   mywrite_id_end(wd, id);
 }
 
+/**
+ * Minimum number of local IDs to write before serializing them on multiple threads.
+ */
+#define WRITE_IDS_PARALLEL_MIN 16
+
+/**
+ * Whether the ID may be serialized on another thread than the main one. UI data-blocks are
+ * small, and their writing code may access window-manager state, so they are always written
+ * directly.
+ *
+ * Writing the other IDs concurrently is safe because their `blend_write` callbacks only read
+ * the data of other IDs, and only modify data owned by the ID being written:
+ * - The ID struct itself is written from a copy (see #BLO_Write_IDBuffer), where runtime data
+ *   is cleared.
+ * - Other data modified while writing (e.g. legacy data created for forward compatibility in
+ *   meshes and node trees, or the indices of particle instance weights) is not shared with other
+ *   IDs.
+ * - Lazily computed caches of other IDs that are read (e.g. the object cache of collections
+ *   instanced by particles) are built under a lock.
+ * - The writers don't use static buffers or global state. The only data they share is the SDNA,
+ *   which is read-only, and every thread has its own #WriteData.
+ *
+ * The exception is the syncing of view layers done when writing scenes, which can tag linked
+ * objects, so it is done before threaded writing starts (see #write_local_ids).
+ */
+static bool write_id_supports_threading(const ID *id)
+{
+  return !ELEM(GS(id->name), ID_WM, ID_SCR, ID_WS);
+}
+
+namespace {
+
+enum class IDWriteRecordState {
+  /** Not serialized yet. */
+  Pending,
+  /** Being serialized by a thread. */
+  Running,
+  /** Serialized, the recorded data can be written to the file. */
+  Done,
+};
+
+struct IDWriteRecord {
+  ID *id = nullptr;
+  std::unique_ptr<WriteRecording> recording;
+  std::atomic<IDWriteRecordState> state = IDWriteRecordState::Pending;
+};
+
+struct IDWriteRecords {
+  blender::MutableSpan<IDWriteRecord> records;
+  /** Notified when a record is done. */
+  std::mutex mutex;
+  std::condition_variable done_condition;
+};
+
+}  // namespace
+
+/**
+ * Serialize the ID into its record, unless another thread already started doing that.
+ * \return True if the record was written by the calling thread.
+ */
+static bool write_id_record_try(IDWriteRecords &records, IDWriteRecord &record)
+{
+  IDWriteRecordState expected = IDWriteRecordState::Pending;
+  if (!record.state.compare_exchange_strong(expected, IDWriteRecordState::Running)) {
+    return false;
+  }
+  record.recording = std::make_unique<WriteRecording>();
+  WriteData *id_wd = writedata_new_recording(record.recording.get());
+  write_id(id_wd, record.id);
+  writedata_free(id_wd);
+  {
+    std::lock_guard lock{records.mutex};
+    record.state = IDWriteRecordState::Done;
+  }
+  records.done_condition.notify_all();
+  return true;
+}
+
+static void write_id_record_task(TaskPool *__restrict pool, void *taskdata)
+{
+  IDWriteRecords &records = *static_cast<IDWriteRecords *>(BLI_task_pool_user_data(pool));
+  write_id_record_try(records, records.records[POINTER_AS_INT(taskdata)]);
+}
+
+/**
+ * Writes all given local IDs, in order.
+ *
+ * When writing to a file, the IDs are serialized concurrently into per-ID recordings, which are
+ * then written in the original order as soon as they are done. Only a limited number of IDs
+ * ahead of the one being written is serialized, to bound the memory used by recordings that
+ * aren't written yet. The recorded writes go through the same buffering as when writing
+ * serially, so the file is byte-for-byte the same.
+ */
+static void write_local_ids(WriteData *wd, const blender::Span<ID *> ids)
+{
+  using namespace blender;
+
+  const int threads_num = BLI_task_scheduler_num_threads();
+  /* Undo relies on the memfile chunks written for each ID, and the debug file on the order of
+   * the printed structs, so both need the serial path. */
+  if (wd->use_memfile || wd->debug_dst != nullptr || threads_num <= 1 ||
+      ids.size() < WRITE_IDS_PARALLEL_MIN)
+  {
+    for (ID *id : ids) {
+      write_id(wd, id);
+    }
+    return;
+  }
+
+  /* Syncing view layers can modify linked objects, which isn't safe while other IDs are written
+   * (see #write_id_supports_threading). Writing the scenes then doesn't change anything. */
+  for (ID *id : ids) {
+    if (GS(id->name) == ID_SCE) {
+      BKE_scene_view_layers_synced_ensure(reinterpret_cast<Scene *>(id));
+    }
+  }
+
+  Array<IDWriteRecord> records_data(ids.size());
+  for (const int64_t i : ids.index_range()) {
+    records_data[i].id = ids[i];
+  }
+  IDWriteRecords records;
+  records.records = records_data;
+
+  TaskPool *task_pool = BLI_task_pool_create(&records, TASK_PRIORITY_HIGH);
+  const int64_t window_size = int64_t(threads_num) * 2;
+  auto push_task = [&](const int64_t i) {
+    if (i < ids.size() && write_id_supports_threading(ids[i])) {
+      BLI_task_pool_push(
+          task_pool, write_id_record_task, POINTER_FROM_INT(int(i)), false, nullptr);
+    }
+  };
+  for (const int64_t i : IndexRange(std::min(window_size, ids.size()))) {
+    push_task(i);
+  }
+
+  for (const int64_t i : ids.index_range()) {
+    push_task(i + window_size);
+
+    IDWriteRecord &record = records_data[i];
+    if (!write_id_supports_threading(record.id)) {
+      write_id(wd, record.id);
+      continue;
+    }
+    /* Serialize the ID on this thread if no other thread started doing it yet, instead of
+     * waiting for it. */
+    if (!write_id_record_try(records, record)) {
+      std::unique_lock lock{records.mutex};
+      records.done_condition.wait(lock,
+                                  [&]() { return record.state == IDWriteRecordState::Done; });
+    }
+
+    for (const Span<uchar> data : record.recording->writes) {
+      mywrite(wd, data.data(), size_t(data.size()));
+    }
+    /* Free the recorded data as soon as possible. */
+    record.recording.reset();
+  }
+
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+}
+
 /** Keep it last of `write_*_data` functions. */
 static void write_libraries(WriteData *wd, Main *bmain)
 {
@@ -1500,9 +2013,7 @@ static bool write_file_handle(Main *mainvar,
   }
 
   /* Actually write local data-blocks to the file. */
-  for (ID *id : local_ids_to_write) {
-    write_id(wd, id);
-  }
+  write_local_ids(wd, local_ids_to_write);
 
   /* Write libraries about libraries and linked data-blocks. */
   write_libraries(wd, mainvar);
@@ -1645,7 +2156,12 @@ static bool BLO_write_file_impl(Main *mainvar,
   write_file_main_validate_pre(mainvar, reports);
 
   /* Open temporary file, so we preserve the original in case we crash. */
-  SNPRINTF(tempname, "%s@", filepath);
+  if (ww.use_in_place) {
+    STRNCPY(tempname, filepath);
+  }
+  else {
+    SNPRINTF(tempname, "%s@", filepath);
+  }
 
   if (ww.open(tempname) == false) {
     BKE_reportf(
@@ -1757,23 +2273,28 @@ static bool BLO_write_file_impl(Main *mainvar,
 
   if (err) {
     BKE_report(reports, RPT_ERROR, strerror(errno));
-    remove(tempname);
+    /* Incomplete changes appended in place are ignored when reading the file. */
+    if (!ww.use_in_place) {
+      remove(tempname);
+    }
 
     return false;
   }
 
-  /* File save to temporary file was successful, now do reverse file history
-   * (move `.blend1` -> `.blend2`, `.blend` -> `.blend1` .. etc). */
-  if (use_save_versions) {
-    if (!do_history(filepath, reports)) {
-      BKE_report(reports, RPT_ERROR, "Version backup failed (file saved with @)");
-      return false;
+  if (!ww.use_in_place) {
+    /* File save to temporary file was successful, now do reverse file history
+     * (move `.blend1` -> `.blend2`, `.blend` -> `.blend1` .. etc). */
+    if (use_save_versions) {
+      if (!do_history(filepath, reports)) {
+        BKE_report(reports, RPT_ERROR, "Version backup failed (file saved with @)");
+        return false;
+      }
     }
-  }
 
-  if (BLI_rename_overwrite(tempname, filepath) != 0) {
-    BKE_report(reports, RPT_ERROR, "Cannot change old file (file saved with @)");
-    return false;
+    if (BLI_rename_overwrite(tempname, filepath) != 0) {
+      BKE_report(reports, RPT_ERROR, "Cannot change old file (file saved with @)");
+      return false;
+    }
   }
 
   write_file_main_validate_post(mainvar, reports);
@@ -1793,6 +2314,18 @@ bool BLO_write_file(Main *mainvar,
                     const BlendFileWriteParams *params,
                     ReportList *reports)
 {
+  if (params->use_delta_save && !(write_flags & G_FILE_COMPRESS)) {
+    DeltaWriteWrap delta_wrap(filepath, params->use_save_versions);
+    const bool success = BLO_write_file_impl(
+        mainvar, filepath, write_flags, params, reports, delta_wrap);
+    if (success) {
+      delta_wrap.store_layout();
+    }
+    return success;
+  }
+  /* The file is replaced, so changes can't be appended to it anymore. */
+  delta_save_layout_clear(filepath);
+
   RawWriteWrap raw_wrap;
 
   if (write_flags & G_FILE_COMPRESS) {
@@ -1803,6 +2336,117 @@ bool BLO_write_file(Main *mainvar,
   return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, raw_wrap);
 }
 
+/**
+ * Copy \a size bytes at \a offset of the file being read to \a ww.
+ */
+static bool write_file_copy_range(FileData *fd,
+                                  WriteWrap &ww,
+                                  const uint64_t offset,
+                                  const uint64_t size,
+                                  blender::Vector<char> &buffer)
+{
+  if (fd->file->seek(fd->file, off64_t(offset), SEEK_SET) == -1) {
+    return false;
+  }
+  for (uint64_t copied = 0; copied < size;) {
+    const int64_t chunk_size = int64_t(std::min(size - copied, uint64_t(buffer.size())));
+    if (fd->file->read(fd->file, buffer.data(), size_t(chunk_size)) != chunk_size ||
+        !ww.write(buffer.data(), size_t(chunk_size)))
+    {
+      return false;
+    }
+    copied += uint64_t(chunk_size);
+  }
+  return true;
+}
+
+bool BLO_write_file_compact(const char *filepath, ReportList *reports)
+{
+  BlendFileReadReport bf_reports{};
+  bf_reports.reports = reports;
+  FileData *fd = blo_filedata_from_file(filepath, &bf_reports);
+  if (fd == nullptr) {
+    return false;
+  }
+  if (fd->delta_index.is_empty()) {
+    blo_filedata_free(fd);
+    return true;
+  }
+
+  char tempname[FILE_MAX + 1];
+  SNPRINTF(tempname, "%s@", filepath);
+  RawWriteWrap raw_wrap;
+  if (raw_wrap.open(tempname) == false) {
+    BKE_reportf(
+        reports, RPT_ERROR, "Cannot open file %s for writing: %s", tempname, strerror(errno));
+    blo_filedata_free(fd);
+    return false;
+  }
+
+  /* Copy the header, the groups of blocks in use and the end block. */
+  const off64_t file_size = fd->file->seek(fd->file, 0, SEEK_END);
+  const uint64_t endb_size = (fd->flags & FD_FLAGS_FILE_POINTSIZE_IS_4) ? sizeof(BHead4) :
+                                                                          sizeof(BHead8);
+  blender::Vector<char> buffer(MEM_BUFFER_SIZE);
+  bool success = write_file_copy_range(fd, raw_wrap, 0, SIZEOFBLENDERHEADER, buffer);
+  for (const BlendDeltaIndexEntry &entry : fd->delta_index) {
+    success = success && write_file_copy_range(fd, raw_wrap, entry.offset, entry.size, buffer);
+  }
+  success = success && write_file_copy_range(
+                           fd, raw_wrap, uint64_t(file_size) - endb_size, endb_size, buffer);
+  success = raw_wrap.close() && success;
+  blo_filedata_free(fd);
+
+  if (!success) {
+    BKE_reportf(reports, RPT_ERROR, "Failed to write file %s: %s", tempname, strerror(errno));
+    remove(tempname);
+    return false;
+  }
+  if (BLI_rename_overwrite(tempname, filepath) != 0) {
+    BKE_report(reports, RPT_ERROR, "Cannot change old file (file saved with @)");
+    return false;
+  }
+  delta_save_layout_clear(filepath);
+  return true;
+}
+
+class CompactBlendCommand : public CommandHandler {
+ public:
+  CompactBlendCommand() : CommandHandler("compact_blend") {}
+
+  int exec(bContext * /*C*/, const int argc, const char **argv) override
+  {
+    if (argc == 0) {
+      fprintf(stderr, "compact_blend requires at least one file path, see '--help'\n");
+      return EXIT_FAILURE;
+    }
+    if (STREQ(argv[0], "--help")) {
+      printf(
+          "usage: compact_blend FILEPATH...\n"
+          "\n"
+          "Rewrite blend-files that were saved with \"Delta Blend File Save\", leaving out the\n"
+          "outdated data. The result can be read by any Blender version.\n");
+      return EXIT_SUCCESS;
+    }
+    int exit_code = EXIT_SUCCESS;
+    for (const int i : blender::IndexRange(argc)) {
+      char filepath[FILE_MAX];
+      STRNCPY(filepath, argv[i]);
+      BLI_path_abs_from_cwd(filepath, sizeof(filepath));
+      /* Reports are printed when there is no report list. */
+      if (!BLO_write_file_compact(filepath, nullptr)) {
+        exit_code = EXIT_FAILURE;
+      }
+    }
+    return exit_code;
+  }
+};
+
+void BLO_write_file_compact_command_register()
+{
+  BKE_blender_cli_command_register(std::make_unique<CompactBlendCommand>());
+}
+
 bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, const int write_flags)
 {
   bool use_userdef = false;
@@ -0,0 +1,217 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include <cstring>
+
+#include "BKE_appdir.hh"
+#include "BKE_global.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "MEM_guardedalloc.h"
+
+namespace blender::blenloader::tests {
+
+class BlendfileWriteTest : public BlendfileLoadingBaseTest {};
+
+static float3 test_position(const int mesh_index, const int vert_index)
+{
+  return float3(mesh_index, vert_index, float(vert_index) * 0.5f);
+}
+
+static Mesh *add_test_mesh(Main *bmain, const int mesh_index, const int verts_num)
+{
+  char name[MAX_ID_NAME - 2];
+  SNPRINTF(name, "Mesh%03d", mesh_index);
+  Mesh *mesh = static_cast<Mesh *>(BKE_id_new(bmain, ID_ME, name));
+  id_fake_user_set(&mesh->id);
+  mesh->verts_num = verts_num;
+  bke::mesh_ensure_required_data_layers(*mesh);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = test_position(mesh_index, i);
+  }
+  return mesh;
+}
+
+static void write_file(Main *bmain,
+                       const char *filepath,
+                       const int write_flags,
+                       const int threads_num)
+{
+  /* The number of threads used for writing comes from the task scheduler. */
+  BLI_system_num_threads_override_set(threads_num);
+  BLI_task_scheduler_init();
+  BlendFileWriteParams params{};
+  const bool success = BLO_write_file(bmain, filepath, write_flags, &params, nullptr);
+  BLI_task_scheduler_exit();
+  BLI_system_num_threads_override_set(0);
+  EXPECT_TRUE(success);
+}
+
+static void expect_same_file_content(const char *filepath_a, const char *filepath_b)
+{
+  size_t size_a = 0;
+  size_t size_b = 0;
+  void *data_a = BLI_file_read_binary_as_mem(filepath_a, 0, &size_a);
+  void *data_b = BLI_file_read_binary_as_mem(filepath_b, 0, &size_b);
+  ASSERT_NE(data_a, nullptr);
+  ASSERT_NE(data_b, nullptr);
+  EXPECT_EQ(size_a, size_b);
+  EXPECT_TRUE(size_a == size_b && memcmp(data_a, data_b, size_a) == 0);
+  MEM_freeN(data_a);
+  MEM_freeN(data_b);
+}
+
+static void write_and_read_meshes(const int write_flags)
+{
+  /* Many meshes to use the multi-threaded writing, one of which is larger than the buffers used
+   * for writing. */
+  const int meshes_num = 64;
+  const int large_mesh_index = 10;
+  const int large_verts_num = 1000000;
+
+  Main *bmain = BKE_main_new();
+  for (const int mesh_index : IndexRange(meshes_num)) {
+    add_test_mesh(bmain, mesh_index, mesh_index == large_mesh_index ? large_verts_num : 100);
+  }
+
+  char filepath[FILE_MAX];
+  char filepath_serial[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), BKE_tempdir_session(), "write_test.blend");
+  BLI_path_join(
+      filepath_serial, sizeof(filepath_serial), BKE_tempdir_session(), "write_test_serial.blend");
+
+  write_file(bmain, filepath, write_flags, 4);
+  write_file(bmain, filepath_serial, write_flags, 1);
+  BKE_main_free(bmain);
+
+  /* Writing IDs on multiple threads must not change the file at all, including the boundaries of
+   * compressed frames. */
+  expect_same_file_content(filepath, filepath_serial);
+  BLI_delete(filepath_serial, false, false);
+
+  BlendFileReadReport reports = {};
+  BlendFileData *bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, &reports);
+  BLI_delete(filepath, false, false);
+  ASSERT_NE(bfile, nullptr);
+
+  EXPECT_EQ(BLI_listbase_count(&bfile->main->meshes), meshes_num);
+  int mesh_index = 0;
+  LISTBASE_FOREACH (const Mesh *, mesh, &bfile->main->meshes) {
+    char name[MAX_ID_NAME - 2];
+    SNPRINTF(name, "Mesh%03d", mesh_index);
+    EXPECT_STREQ(mesh->id.name + 2, name);
+    const Span<float3> positions = mesh->vert_positions();
+    ASSERT_EQ(positions.size(), mesh_index == large_mesh_index ? large_verts_num : 100);
+    for (const int i : positions.index_range()) {
+      if (positions[i] != test_position(mesh_index, i)) {
+        ADD_FAILURE() << "Wrong position " << i << " in " << name;
+        break;
+      }
+    }
+    mesh_index++;
+  }
+
+  BLO_blendfiledata_free(bfile);
+}
+
+static void write_file_delta(Main *bmain, const char *filepath)
+{
+  BlendFileWriteParams params{};
+  params.use_delta_save = true;
+  EXPECT_TRUE(BLO_write_file(bmain, filepath, 0, &params, nullptr));
+}
+
+static void expect_delta_meshes(const char *filepath,
+                                const int meshes_num,
+                                const int changed_mesh_index)
+{
+  BlendFileReadReport reports = {};
+  BlendFileData *bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, &reports);
+  ASSERT_NE(bfile, nullptr);
+
+  EXPECT_EQ(BLI_listbase_count(&bfile->main->meshes), meshes_num);
+  int mesh_index = 0;
+  LISTBASE_FOREACH (const Mesh *, mesh, &bfile->main->meshes) {
+    const Span<float3> positions = mesh->vert_positions();
+    for (const int i : positions.index_range()) {
+      const float3 expected = (mesh_index == changed_mesh_index) ? float3(-1.0f) :
+                                                                   test_position(mesh_index, i);
+      if (positions[i] != expected) {
+        ADD_FAILURE() << "Wrong position " << i << " in " << mesh->id.name;
+        break;
+      }
+    }
+    mesh_index++;
+  }
+
+  BLO_blendfiledata_free(bfile);
+}
+
+TEST_F(BlendfileWriteTest, DeltaSave)
+{
+  const int meshes_num = 32;
+  Main *bmain = BKE_main_new();
+  Vector<Mesh *> meshes;
+  for (const int mesh_index : IndexRange(meshes_num)) {
+    meshes.append(add_test_mesh(bmain, mesh_index, mesh_index == 0 ? 100000 : 100));
+  }
+
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), BKE_tempdir_session(), "write_test_delta.blend");
+
+  /* The first save writes the whole file. */
+  write_file_delta(bmain, filepath);
+  const size_t full_size = BLI_file_size(filepath);
+  expect_delta_meshes(filepath, meshes_num, -1);
+
+  /* Saving again only appends the changed mesh and the index. */
+  meshes[5]->vert_positions_for_write().fill(float3(-1.0f));
+  write_file_delta(bmain, filepath);
+  const size_t delta_size = BLI_file_size(filepath);
+  EXPECT_GT(delta_size, full_size);
+  EXPECT_LT(delta_size - full_size, full_size / 10);
+  expect_delta_meshes(filepath, meshes_num, 5);
+
+  /* Nothing changed, only a new index is appended. */
+  write_file_delta(bmain, filepath);
+  EXPECT_LT(BLI_file_size(filepath) - delta_size, full_size / 10);
+  expect_delta_meshes(filepath, meshes_num, 5);
+  BKE_main_free(bmain);
+
+  /* Compacting leaves out the outdated mesh and indices. */
+  EXPECT_TRUE(BLO_write_file_compact(filepath, nullptr));
+  EXPECT_EQ(BLI_file_size(filepath), full_size);
+  expect_delta_meshes(filepath, meshes_num, 5);
+
+  BLI_delete(filepath, false, false);
+}
+
+TEST_F(BlendfileWriteTest, WriteMeshesThreaded)
+{
+  write_and_read_meshes(0);
+}
+
+TEST_F(BlendfileWriteTest, WriteMeshesThreadedCompressed)
+{
+  write_and_read_meshes(G_FILE_COMPRESS);
+}
+
+}  // namespace blender::blenloader::tests
@@ -0,0 +1,123 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_undo_system.hh"
+
+#include "BLI_listbase.h"
+#include "BLI_span.hh"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
+
+#include "BLO_undofile.hh"
+
+namespace blender::blenloader::tests {
+
+/** Content that compresses well, different for every seed. */
+static Vector<char> chunk_content(const int seed, const int64_t size)
+{
+  Vector<char> data(size);
+  for (const int64_t i : data.index_range()) {
+    data[i] = char((i / 64) * seed + seed);
+  }
+  return data;
+}
+
+static void write_memfile(MemFile *memfile, MemFile *reference, const Span<Vector<char>> chunks)
+{
+  MemFileWriteData mem_data{};
+  BLO_memfile_write_init(&mem_data, memfile, reference);
+  for (const Vector<char> &chunk : chunks) {
+    BLO_memfile_chunk_add(&mem_data, chunk.data(), size_t(chunk.size()));
+  }
+  BLO_memfile_write_finalize(&mem_data);
+}
+
+static const MemFileChunk *memfile_chunk(const MemFile &memfile, const int index)
+{
+  return static_cast<const MemFileChunk *>(BLI_findlink(&memfile.chunks, index));
+}
+
+static void expect_memfile_content(MemFile *memfile, const Span<Vector<char>> chunks)
+{
+  Vector<char> expected;
+  for (const Vector<char> &chunk : chunks) {
+    expected.extend(chunk);
+  }
+
+  FileReader *reader = BLO_memfile_new_filereader(memfile, STEP_UNDO);
+  Vector<char> content(expected.size());
+  EXPECT_EQ(reader->read(reader, content.data(), size_t(content.size())), content.size());
+  reader->close(reader);
+  EXPECT_TRUE(content.as_span() == expected.as_span());
+}
+
+TEST(undofile, SharedChunks)
+{
+  const Vector<char> a = chunk_content(1, 1000);
+  const Vector<char> b = chunk_content(2, 1000);
+  const Vector<char> c = chunk_content(3, 1000);
+  const Vector<Vector<char>> first_chunks = {a, b, a};
+  const Vector<Vector<char>> second_chunks = {a, c, b};
+
+  MemFile first = {};
+  write_memfile(&first, nullptr, first_chunks);
+  /* Identical chunks of the same step share their memory. */
+  EXPECT_EQ(memfile_chunk(first, 0)->buffer, memfile_chunk(first, 2)->buffer);
+  EXPECT_NE(memfile_chunk(first, 0)->buffer, memfile_chunk(first, 1)->buffer);
+  EXPECT_EQ(BLO_memfile_size_get(&first), size_t(a.size() + b.size()));
+
+  MemFile second = {};
+  write_memfile(&second, &first, second_chunks);
+  /* Unchanged at the same position. */
+  EXPECT_EQ(memfile_chunk(second, 0)->buffer, memfile_chunk(first, 0)->buffer);
+  EXPECT_TRUE(memfile_chunk(second, 0)->is_identical);
+  /* Changed, but the content exists at another position of the previous step. */
+  EXPECT_EQ(memfile_chunk(second, 2)->buffer, memfile_chunk(first, 1)->buffer);
+  EXPECT_FALSE(memfile_chunk(second, 2)->is_identical);
+  EXPECT_FALSE(memfile_chunk(second, 1)->is_identical);
+  /* Only the new chunk is accounted for in the second step. */
+  EXPECT_EQ(BLO_memfile_size_get(&second), size_t(c.size()));
+
+  expect_memfile_content(&first, first_chunks);
+  expect_memfile_content(&second, second_chunks);
+
+  /* The shared chunks remain valid when the first step is merged into the second one. */
+  BLO_memfile_merge(&first, &second);
+  EXPECT_EQ(BLO_memfile_size_get(&second), size_t(a.size() + b.size() + c.size()));
+  expect_memfile_content(&second, second_chunks);
+  BLO_memfile_free(&second);
+}
+
+TEST(undofile, CompressedChunks)
+{
+  const Vector<char> cold = chunk_content(5, 256 * 1024);
+  const Vector<char> hot = chunk_content(7, 1000);
+  const Vector<Vector<char>> first_chunks = {cold, hot};
+  const Vector<Vector<char>> other_chunks = {hot};
+
+  /* The cold chunk is compressed once it wasn't used by the last few steps. */
+  MemFile steps[6] = {};
+  write_memfile(&steps[0], nullptr, first_chunks);
+  for (const int i : IndexRange(1, 5)) {
+    write_memfile(&steps[i], &steps[i - 1], other_chunks);
+  }
+  const size_t size_uncompressed = size_t(cold.size() + hot.size());
+  for (int i = 0; i < 1000 && BLO_memfile_size_get(&steps[0]) == size_uncompressed; i++) {
+    BLI_time_sleep_ms(10);
+  }
+  EXPECT_LT(BLO_memfile_size_get(&steps[0]), size_uncompressed);
+
+  /* Reading decompresses the chunk again. */
+  expect_memfile_content(&steps[0], first_chunks);
+  EXPECT_EQ(BLO_memfile_size_get(&steps[0]), size_uncompressed);
+  expect_memfile_content(&steps[5], other_chunks);
+
+  for (MemFile &step : steps) {
+    BLO_memfile_free(&step);
+  }
+}
+
+}  // namespace blender::blenloader::tests
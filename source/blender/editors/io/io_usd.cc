@@ -274,6 +274,7 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
   const bool selected_objects_only = RNA_boolean_get(op->ptr, "selected_objects_only");
   const bool visible_objects_only = RNA_boolean_get(op->ptr, "visible_objects_only");
   const bool export_animation = RNA_boolean_get(op->ptr, "export_animation");
+  const int animation_chunk_size = RNA_int_get(op->ptr, "animation_chunk_size");
   const bool export_hair = RNA_boolean_get(op->ptr, "export_hair");
   const bool export_uvmaps = RNA_boolean_get(op->ptr, "export_uvmaps");
   const bool rename_uvmaps = RNA_boolean_get(op->ptr, "rename_uvmaps");
@@ -365,6 +366,7 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
 
   USDExportParams params;
   params.export_animation = export_animation;
+  params.animation_chunk_size = animation_chunk_size;
   params.selected_objects_only = selected_objects_only;
   params.visible_objects_only = visible_objects_only;
 
@@ -445,6 +447,9 @@ static void wm_usd_export_draw(bContext *C, wmOperator *op)
       uiItemR(sub, ptr, "visible_objects_only", UI_ITEM_NONE, std::nullopt, ICON_NONE);
     }
     uiItemR(sub, ptr, "export_animation", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    if (RNA_boolean_get(ptr, "export_animation")) {
+      uiItemR(col, ptr, "animation_chunk_size", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    }
 
     sub = uiLayoutColumnWithHeading(col, true, IFACE_("Blender Data"));
     uiItemR(sub, ptr, "export_custom_properties", UI_ITEM_NONE, std::nullopt, ICON_NONE);
@@ -655,6 +660,17 @@ void WM_OT_usd_export(wmOperatorType *ot)
       false,
       "Animation",
       "Export all frames in the render frame range, rather than only the current frame");
+  RNA_def_int(ot->srna,
+              "animation_chunk_size",
+              0,
+              0,
+              INT_MAX,
+              "Frames per Clip",
+              "Write the animation to separate value clip files with this many frames each, "
+              "limiting memory usage for long animations. Zero writes all frames into the "
+              "exported file",
+              0,
+              1000);
   RNA_def_boolean(
       ot->srna, "export_hair", false, "Hair", "Export hair particle systems as USD curves");
   RNA_def_boolean(
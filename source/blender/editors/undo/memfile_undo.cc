@@ -83,6 +83,16 @@ static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : nullptr);
   us->step.data_size = us->data->undo_size;
 
+  /* Chunks of the previous steps may have been compressed in the background since they were
+   * written, update their size so the memory limit of the undo stack takes it into account. */
+  LISTBASE_FOREACH (UndoStep *, us_iter, &ustack->steps) {
+    if (us_iter->type == BKE_UNDOSYS_TYPE_MEMFILE && us_iter != us_p) {
+      MemFileUndoData *data = ((MemFileUndoStep *)us_iter)->data;
+      data->undo_size = BLO_memfile_size_get(&data->memfile);
+      us_iter->data_size = data->undo_size;
+    }
+  }
+
   /* Store the fact that we should not re-use old data with that undo step, and reset the Main
    * flag. */
   us->step.use_old_bmain_data = !bmain->use_memfile_full_barrier;
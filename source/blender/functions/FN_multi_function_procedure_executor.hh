@@ -17,8 +17,16 @@ class ProcedureExecutor : public MultiFunction {
  private:
   Signature signature_;
   const Procedure &procedure_;
+  /** True when the procedure can be executed on smaller chunks of the mask one after another. */
+  bool supports_chunking_;
 
  public:
+  /**
+   * Maximum number of indices the procedure is executed on at once. This keeps intermediate
+   * buffers small enough to stay in the CPU cache while they are passed between instructions.
+   */
+  static constexpr int64_t chunk_size = 4096;
+
   ProcedureExecutor(const Procedure &procedure);
 
   void call(const IndexMask &mask, Params params, Context context) const override;
@@ -12,8 +12,13 @@ ProcedureExecutor::ProcedureExecutor(const Procedure &procedure) : procedure_(pr
 {
   SignatureBuilder builder("Procedure Executor", signature_);
 
+  supports_chunking_ = true;
   for (const ConstParameter &param : procedure.params()) {
     builder.add("Parameter", ParamType(param.type, param.variable->data_type()));
+    if (param.variable->data_type().is_vector()) {
+      /* Vector arrays can't be sliced. */
+      supports_chunking_ = false;
+    }
   }
 
   this->set_signature(&signature_);
@@ -148,8 +153,17 @@ class ValueAllocator : NonCopyable, NonMovable {
   Stack<void *> small_single_value_free_list_;
   Map<const CPPType *, Stack<void *>> single_value_free_lists_;
 
+  /**
+   * Span buffers are allocated with at least this many elements. This allows reusing them when
+   * the allocator is shared by multiple executions of the procedure on masks of different sizes.
+   */
+  int min_span_size_;
+
  public:
-  ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator) {}
+  ValueAllocator(LinearAllocator<> &linear_allocator, const int min_span_size = 0)
+      : linear_allocator_(linear_allocator), min_span_size_(min_span_size)
+  {
+  }
 
   VariableValue_GVArray *obtain_GVArray(const GVArray &varray)
   {
@@ -169,6 +183,7 @@ class ValueAllocator : NonCopyable, NonMovable {
   VariableValue_Span *obtain_Span(const CPPType &type, int size)
   {
     void *buffer = nullptr;
+    size = std::max(size, min_span_size_);
 
     const int64_t element_size = type.size();
     const int64_t alignment = type.alignment();
@@ -813,17 +828,17 @@ class VariableState : NonCopyable, NonMovable {
 /** Keeps track of the states of all variables during evaluation. */
 class VariableStates {
  private:
-  ValueAllocator value_allocator_;
+  ValueAllocator &value_allocator_;
   const Procedure &procedure_;
   /** The state of every variable, indexed by #Variable::index_in_procedure(). */
   Array<VariableState> variable_states_;
   const IndexMask &full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator,
+  VariableStates(ValueAllocator &value_allocator,
                  const Procedure &procedure,
                  const IndexMask &full_mask)
-      : value_allocator_(linear_allocator),
+      : value_allocator_(value_allocator),
         procedure_(procedure),
         variable_states_(procedure.variables().size()),
         full_mask_(full_mask)
@@ -1157,19 +1172,18 @@ class InstructionScheduler {
   }
 };
 
-void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+static void execute_procedure(const ProcedureExecutor &fn,
+                              const Procedure &procedure,
+                              const IndexMask &full_mask,
+                              Params params,
+                              Context context,
+                              ValueAllocator &value_allocator)
 {
-  BLI_assert(procedure_.validate());
-
-  AlignedBuffer<512, 64> local_buffer;
-  LinearAllocator<> linear_allocator;
-  linear_allocator.provide_buffer(local_buffer);
-
-  VariableStates variable_states{linear_allocator, procedure_, full_mask};
-  variable_states.add_initial_variable_states(*this, procedure_, params);
+  VariableStates variable_states{value_allocator, procedure, full_mask};
+  variable_states.add_initial_variable_states(fn, procedure, params);
 
   InstructionScheduler scheduler;
-  scheduler.add_referenced_indices(*procedure_.entry(), full_mask);
+  scheduler.add_referenced_indices(*procedure.entry(), full_mask);
 
   /* Loop until all indices got to a return instruction. */
   while (!scheduler.is_done()) {
@@ -1218,9 +1232,9 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
     }
   }
 
-  for (const int param_index : this->param_indices()) {
-    const ParamType param_type = this->param_type(param_index);
-    const Variable *variable = procedure_.params()[param_index].variable;
+  for (const int param_index : fn.param_indices()) {
+    const ParamType param_type = fn.param_type(param_index);
+    const Variable *variable = procedure.params()[param_index].variable;
     VariableState &variable_state = variable_states.get_variable_state(*variable);
     switch (param_type.interface_type()) {
       case ParamType::Input: {
@@ -1241,10 +1255,80 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
   }
 }
 
+/**
+ * Slice the parameters so that they can be used with a mask that has been shifted by the start of
+ * the given range.
+ */
+static void add_sliced_params(const ProcedureExecutor &fn,
+                              Params &full_params,
+                              const IndexRange slice_range,
+                              ParamsBuilder &r_sliced_params)
+{
+  for (const int param_index : fn.param_indices()) {
+    switch (fn.param_type(param_index).category()) {
+      case ParamCategory::SingleInput: {
+        const GVArray &varray = full_params.readonly_single_input(param_index);
+        r_sliced_params.add_readonly_single_input(varray.slice(slice_range));
+        break;
+      }
+      case ParamCategory::SingleMutable: {
+        const GMutableSpan span = full_params.single_mutable(param_index);
+        r_sliced_params.add_single_mutable(span.slice(slice_range));
+        break;
+      }
+      case ParamCategory::SingleOutput: {
+        const GMutableSpan span = full_params.uninitialized_single_output(param_index);
+        r_sliced_params.add_uninitialized_single_output(span.slice(slice_range));
+        break;
+      }
+      case ParamCategory::VectorInput:
+      case ParamCategory::VectorMutable:
+      case ParamCategory::VectorOutput: {
+        BLI_assert_unreachable();
+        break;
+      }
+    }
+  }
+}
+
+void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+{
+  BLI_assert(procedure_.validate());
+
+  AlignedBuffer<512, 64> local_buffer;
+  LinearAllocator<> linear_allocator;
+  linear_allocator.provide_buffer(local_buffer);
+
+  if (!supports_chunking_ || full_mask.min_array_size() <= chunk_size) {
+    ValueAllocator value_allocator{linear_allocator};
+    execute_procedure(*this, procedure_, full_mask, params, context, value_allocator);
+    return;
+  }
+
+  /* Execute the entire procedure on one chunk of indices at a time, instead of executing every
+   * instruction on all indices. This way intermediate values stay in the CPU cache between
+   * instructions. All buffers have the chunk size, so they can be reused for every chunk. */
+  ValueAllocator value_allocator{linear_allocator, chunk_size};
+  int64_t mask_pos = 0;
+  while (mask_pos < full_mask.size()) {
+    const int64_t chunk_start = full_mask[mask_pos];
+    const IndexMask chunk_mask = full_mask.slice_content(chunk_start, chunk_size);
+    const IndexRange chunk_range{chunk_start, chunk_mask.last() - chunk_start + 1};
+    mask_pos += chunk_mask.size();
+
+    IndexMaskMemory memory;
+    const IndexMask shifted_mask = chunk_mask.shift(-chunk_start, memory);
+    ParamsBuilder sliced_params{*this, &shifted_mask};
+    add_sliced_params(*this, params, chunk_range, sliced_params);
+    execute_procedure(*this, procedure_, shifted_mask, sliced_params, context, value_allocator);
+  }
+}
+
 MultiFunction::ExecutionHints ProcedureExecutor::get_execution_hints() const
 {
   ExecutionHints hints;
-  hints.allocates_array = true;
+  /* When executing in chunks, the size of the allocated arrays does not depend on the mask. */
+  hints.allocates_array = !supports_chunking_;
   hints.min_grain_size = 10000;
   return hints;
 }
@@ -423,4 +423,81 @@ TEST(multi_function_procedure, OutputBufferReplaced)
   EXPECT_EQ(output[2], output_value);
 }
 
+TEST(multi_function_procedure, ChunkedExecution)
+{
+  /**
+   * procedure(int a, bool b, int &c, int *d) {
+   *   int e = a + c;
+   *   if (b) {
+   *     c += 100;
+   *   }
+   *   d = e + 10;
+   * }
+   */
+
+  auto add_fn = build::SI2_SO<int, int, int>("add", [](int a, int b) { return a + b; });
+  auto add_10_fn = build::SI1_SO<int, int>("add 10", [](int a) { return a + 10; });
+  auto add_100_fn = build::SM<int>("add 100", [](int &a) { a += 100; });
+
+  Procedure procedure;
+  ProcedureBuilder builder{procedure};
+
+  Variable *var_a = &builder.add_single_input_parameter<int>();
+  Variable *var_b = &builder.add_single_input_parameter<bool>();
+  Variable *var_c = &builder.add_single_mutable_parameter<int>();
+  auto [var_e] = builder.add_call<1>(add_fn, {var_a, var_c});
+  builder.add_destruct(*var_a);
+  ProcedureBuilder::Branch branch = builder.add_branch(*var_b);
+  branch.branch_true.add_call(add_100_fn, {var_c});
+  builder.set_cursor_after_branch(branch);
+  builder.add_destruct(*var_b);
+  auto [var_d] = builder.add_call<1>(add_10_fn, {var_e});
+  builder.add_destruct(*var_e);
+  builder.add_return();
+  builder.add_output_parameter(*var_d);
+
+  EXPECT_TRUE(procedure.validate());
+
+  ProcedureExecutor procedure_fn{procedure};
+
+  /* Use enough indices to be split into multiple chunks, including a gap larger than a chunk. */
+  const int size = ProcedureExecutor::chunk_size * 5 + 123;
+  Array<int> inputs_a(size);
+  Array<bool> inputs_b(size);
+  Array<int> values_c(size);
+  Array<int> results(size, -1);
+  for (const int i : IndexRange(size)) {
+    inputs_a[i] = i;
+    inputs_b[i] = i % 3 == 0;
+    values_c[i] = i * 2;
+  }
+
+  IndexMaskMemory memory;
+  const int64_t chunk_size = ProcedureExecutor::chunk_size;
+  const IndexMask mask = IndexMask::from_predicate(
+      IndexRange(size), GrainSize(1024), memory, [&](const int64_t i) {
+        return i > 100 && (i < chunk_size || i > chunk_size * 3);
+      });
+  ParamsBuilder params{procedure_fn, &mask};
+
+  params.add_readonly_single_input(inputs_a.as_span());
+  params.add_readonly_single_input(inputs_b.as_span());
+  params.add_single_mutable(values_c.as_mutable_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+
+  ContextBuilder context;
+  procedure_fn.call(mask, params, context);
+
+  for (const int i : IndexRange(size)) {
+    if (mask.contains(i)) {
+      EXPECT_EQ(results[i], i * 3 + 10);
+      EXPECT_EQ(values_c[i], i * 2 + (i % 3 == 0 ? 100 : 0));
+    }
+    else {
+      EXPECT_EQ(results[i], -1);
+      EXPECT_EQ(values_c[i], i * 2);
+    }
+  }
+}
+
 }  // namespace blender::fn::multi_function::tests
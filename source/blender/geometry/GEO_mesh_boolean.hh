@@ -22,6 +22,20 @@ enum class Solver {
   MeshArr = 0,
   /** The original BMesh floating point solver. */
   Float = 1,
+  /**
+   * A faster exact solver that requires every operand to be a closed manifold mesh without
+   * self-intersections.
+   */
+  Manifold = 2,
+};
+
+/** Reason why #mesh_boolean did not give a result. */
+enum class BooleanError {
+  NoError = 0,
+  /** An operand is not a closed manifold mesh, as required by #Solver::Manifold. */
+  NonManifold = 1,
+  /** The solver is not available in this build. */
+  SolverNotAvailable = 2,
 };
 
 enum class Operation {
@@ -71,6 +85,7 @@ struct BooleanOpParameters {
  * \param solver: which solver to use
  * \param r_intersecting_edges: Vector to store indices of edges on the resulting mesh in. These
  * 'new' edges are the result of the intersections.
+ * \param r_error: Optionally set to the reason why no result was created.
  */
 Mesh *mesh_boolean(Span<const Mesh *> meshes,
                    Span<float4x4> transforms,
@@ -78,6 +93,7 @@ Mesh *mesh_boolean(Span<const Mesh *> meshes,
                    Span<Array<short>> material_remaps,
                    BooleanOpParameters op_params,
                    Solver solver,
-                   Vector<int> *r_intersecting_edges);
+                   Vector<int> *r_intersecting_edges,
+                   BooleanError *r_error = nullptr);
 
 }  // namespace blender::geometry::boolean
@@ -2,8 +2,11 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
 #include <iostream>
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_lib_id.hh"
@@ -11,15 +14,30 @@
 
 #include "BLI_alloca.h"
 #include "BLI_array.hh"
+#include "BLI_array_utils.hh"
+#include "BLI_bounds.hh"
+#include "BLI_delaunay_2d.hh"
+#include "BLI_disjoint_set.hh"
+#include "BLI_hash.hh"
+#include "BLI_kdopbvh.hh"
+#include "BLI_kdtree.h"
+#include "BLI_map.hh"
+#include "BLI_math_boolean.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_vector.h"
 #include "BLI_mesh_boolean.hh"
 #include "BLI_mesh_intersect.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_ordered_edge.hh"
+#include "BLI_set.hh"
+#include "BLI_sort.hh"
 #include "BLI_span.hh"
 #include "BLI_string.h"
+#include "BLI_struct_equality_utils.hh"
 #include "BLI_task.hh"
+#include "BLI_vector_set.hh"
 #include "BLI_virtual_array.hh"
 
 #include "DNA_node_types.h"
@@ -1143,15 +1161,1852 @@ static Mesh *mesh_boolean_float(Span<const Mesh *> meshes,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Manifold Boolean
+ *
+ * A solver for closed manifold operands without self-intersections. Instead of multi-precision
+ * arithmetic it uses exact orientation predicates on double coordinates for all topological
+ * decisions. Intersection points get a symbolic identity (the edge and triangle or the two edges
+ * they come from), so all triangle pairs agree on them. Triangle pairs of different operands are
+ * intersected in parallel, the cut faces are split with a 2D constrained triangulation, and
+ * every patch of faces bounded by intersection edges is classified as a whole with the
+ * generalized winding number of the other operands.
+ * \{ */
+
+namespace manifold {
+
+/**
+ * Tree over the triangles of an operand to compute its generalized winding number in logarithmic
+ * time, following "Fast Winding Numbers for Soups and Clouds" by Barill et al. The triangles of a
+ * node that is far away from the point are approximated by a dipole at the center of the node.
+ */
+struct WindingNumberTree {
+  struct Node {
+    /** Area weighted center of the triangles. */
+    double3 center;
+    /** Sum of the area weighted normals of the triangles. */
+    double3 normal;
+    /** Distance from the center to the farthest vertex. */
+    double radius;
+    /** Indices of the child nodes, or -1 for leaves. */
+    int2 children;
+    /** Range of #tris in the node. */
+    IndexRange tris_range;
+  };
+  /** The root node is the first one. */
+  Vector<Node> nodes;
+  /** Triangles of the operand, ordered so that every node contains a contiguous range. */
+  Array<int> tris;
+};
+
+/** All operands concatenated into one polygon soup in the target space. */
+struct BoolInput {
+  /** Positions of the vertices of all operands. */
+  Array<double3> positions;
+  /** Offsets of the faces of all operands into #corner_verts. */
+  Array<int> face_offsets;
+  Array<int> corner_verts;
+  /** Index of the operand of every face. */
+  Array<int> face_shapes;
+  /** Triangulation of the faces. The triangles of every face are stored contiguously. */
+  Array<int3> tris;
+  Array<int> tri_faces;
+  Array<int> face_tri_offsets;
+  /** Bit `i` is set when the edge between triangle vertices `i` and `i + 1` is a face edge. */
+  Array<uint8_t> tri_face_edges;
+  /** Range of triangles of every operand. */
+  Array<IndexRange> shape_tris;
+  Array<Bounds<double3>> shape_bounds;
+  /** 1 for operands whose faces point outwards in the target space, -1 for mirrored ones. */
+  Array<int> shape_orientation;
+  Array<WindingNumberTree> shape_winding_trees;
+
+  OffsetIndices<int> faces() const
+  {
+    return face_offsets.as_span();
+  }
+  OffsetIndices<int> face_tris() const
+  {
+    return face_tri_offsets.as_span();
+  }
+  int shapes_num() const
+  {
+    return shape_tris.size();
+  }
+};
+
+/** Faces of the result, with their mapping back to the input. */
+struct BoolResult {
+  Array<double3> positions;
+  /** Input vertex of every result vertex or -1 for vertices created by the intersection. */
+  Array<int> vert_orig;
+  Array<int> face_offsets;
+  Array<int> corner_verts;
+  /** Input face that every result face is a part of. */
+  Array<int> face_orig;
+  /** Input corner with the same vertex, or -1 when corner data has to be interpolated. */
+  Array<int> corner_orig;
+  /** Input corner of the input edge that contains the edge starting at the corner, or -1. */
+  Array<int> corner_edge_orig;
+  /** Whether the edge starting at the corner is an intersection edge. */
+  Array<bool> corner_is_cut;
+};
+
+enum class PointKind : int8_t {
+  /** An input vertex. */
+  Vert,
+  /** The point where an edge crosses the inside of a triangle. */
+  EdgeTri,
+  /** The point where two edges cross. */
+  EdgeEdge,
+};
+
+/**
+ * Symbolic identity of a point on an intersection segment. Every triangle pair computes the same
+ * key, and therefore the exact same position, for a point that it shares with other pairs.
+ */
+struct PointKey {
+  PointKind kind;
+  int a = -1;
+  int b = -1;
+  int c = -1;
+  int d = -1;
+
+  static PointKey vert(const int vert)
+  {
+    return {PointKind::Vert, vert};
+  }
+
+  static PointKey edge_tri(const int v0, const int v1, const int tri)
+  {
+    return {PointKind::EdgeTri, std::min(v0, v1), std::max(v0, v1), tri};
+  }
+
+  static PointKey edge_edge(const int a0, const int a1, const int b0, const int b1)
+  {
+    std::pair<int, int> edge_a(std::min(a0, a1), std::max(a0, a1));
+    std::pair<int, int> edge_b(std::min(b0, b1), std::max(b0, b1));
+    if (edge_b < edge_a) {
+      std::swap(edge_a, edge_b);
+    }
+    return {PointKind::EdgeEdge, edge_a.first, edge_a.second, edge_b.first, edge_b.second};
+  }
+
+  uint64_t hash() const
+  {
+    return get_default_hash(get_default_hash(int(kind), a), b, c, d);
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_5(PointKey, kind, a, b, c, d)
+};
+
+/** A piece of an intersection curve that has to be inserted into an input face. */
+struct Segment {
+  int face;
+  PointKey a;
+  PointKey b;
+};
+
+/**
+ * Index of the coordinate that is dropped to project onto a plane with the given normal. The
+ * remaining coordinates are used in cyclic order, which keeps the orientation of polygons when
+ * the normal points along the positive axis.
+ */
+static int dominant_axis(const double3 &normal)
+{
+  const double3 abs_normal = math::abs(normal);
+  if (abs_normal.x >= abs_normal.y && abs_normal.x >= abs_normal.z) {
+    return 0;
+  }
+  return abs_normal.y >= abs_normal.z ? 1 : 2;
+}
+
+static double2 project_2d(const double3 &co, const int axis)
+{
+  switch (axis) {
+    case 0:
+      return {co.y, co.z};
+    case 1:
+      return {co.z, co.x};
+    default:
+      return {co.x, co.y};
+  }
+}
+
+static double cross_2d(const double2 &a, const double2 &b)
+{
+  return a.x * b.y - a.y * b.x;
+}
+
+static double3 tri_normal(const Span<double3> positions, const int3 &tri)
+{
+  return math::cross(positions[tri[1]] - positions[tri[0]],
+                     positions[tri[2]] - positions[tri[0]]);
+}
+
+/** Newell's method, which also works for non-planar and concave polygons. */
+static double3 polygon_normal(const Span<double3> positions, const Span<int> verts)
+{
+  double3 normal(0.0);
+  for (const int i : verts.index_range()) {
+    const double3 &a = positions[verts[i]];
+    const double3 &b = positions[verts[(i + 1) % verts.size()]];
+    normal.x += (a.y - b.y) * (a.z + b.z);
+    normal.y += (a.z - b.z) * (a.x + b.x);
+    normal.z += (a.x - b.x) * (a.y + b.y);
+  }
+  return normal;
+}
+
+/** Whether the point is inside or on the boundary of a non-degenerate 2D triangle. */
+static bool point_in_tri_2d(const double2 &p, const double2 &a, const double2 &b, const double2 &c)
+{
+  const int s0 = orient2d(a, b, p);
+  const int s1 = orient2d(b, c, p);
+  const int s2 = orient2d(c, a, p);
+  const bool has_negative = s0 < 0 || s1 < 0 || s2 < 0;
+  const bool has_positive = s0 > 0 || s1 > 0 || s2 > 0;
+  return !(has_negative && has_positive);
+}
+
+static double3 point_position(const BoolInput &input, const PointKey &key)
+{
+  const Span<double3> positions = input.positions;
+  switch (key.kind) {
+    case PointKind::Vert:
+      return positions[key.a];
+    case PointKind::EdgeTri: {
+      const double3 &p = positions[key.a];
+      const double3 &q = positions[key.b];
+      const int3 &tri = input.tris[key.c];
+      const double3 normal = tri_normal(positions, tri);
+      const double denominator = math::dot(normal, q - p);
+      if (denominator == 0.0) {
+        return p;
+      }
+      const double t = math::dot(normal, positions[tri[0]] - p) / denominator;
+      return p + (q - p) * std::clamp(t, 0.0, 1.0);
+    }
+    case PointKind::EdgeEdge: {
+      /* Closest point on the first edge to the line of the second edge. */
+      const double3 &p = positions[key.a];
+      const double3 dir_a = positions[key.b] - p;
+      const double3 dir_b = positions[key.d] - positions[key.c];
+      const double3 offset = p - positions[key.c];
+      const double aa = math::dot(dir_a, dir_a);
+      const double ab = math::dot(dir_a, dir_b);
+      const double bb = math::dot(dir_b, dir_b);
+      const double denominator = aa * bb - ab * ab;
+      if (denominator == 0.0) {
+        return p;
+      }
+      const double t = (ab * math::dot(dir_b, offset) - bb * math::dot(dir_a, offset)) /
+                       denominator;
+      return p + dir_a * std::clamp(t, 0.0, 1.0);
+    }
+  }
+  BLI_assert_unreachable();
+  return double3(0.0);
+}
+
+/**
+ * Add the points where the edge from `v0` to `v1` crosses the boundary of triangle `tri` in the
+ * same plane, with their parameter along the edge scaled by its squared length.
+ */
+static void add_coplanar_edge_crossings(const BoolInput &input,
+                                        const int v0,
+                                        const int v1,
+                                        const int3 &tri,
+                                        const int axis,
+                                        Vector<std::pair<double, PointKey>, 8> &points)
+{
+  const Span<double3> positions = input.positions;
+  const double2 p0 = project_2d(positions[v0], axis);
+  const double2 p1 = project_2d(positions[v1], axis);
+  const double2 dir = p1 - p0;
+  const double length_sq = math::dot(dir, dir);
+  for (const int m : IndexRange(3)) {
+    const double2 q0 = project_2d(positions[tri[m]], axis);
+    const double2 q1 = project_2d(positions[tri[(m + 1) % 3]], axis);
+    const int s0 = orient2d(q0, q1, p0);
+    const int s1 = orient2d(q0, q1, p1);
+    const int t0 = orient2d(p0, p1, q0);
+    if (s0 * s1 < 0 && t0 * orient2d(p0, p1, q1) < 0) {
+      const double2 q_dir = q1 - q0;
+      const double t = cross_2d(q0 - p0, q_dir) / cross_2d(dir, q_dir);
+      points.append({t * length_sq, PointKey::edge_edge(v0, v1, tri[m], tri[(m + 1) % 3])});
+    }
+    else if (t0 == 0) {
+      const double t = math::dot(q0 - p0, dir);
+      if (t > 0.0 && t < length_sq) {
+        points.append({t, PointKey::vert(tri[m])});
+      }
+    }
+  }
+}
+
+/**
+ * Add the points where the boundary of triangle `tri` meets the triangle `other`, which lies in
+ * a different plane. `sides` contains the side of the plane of `other` of every vertex of `tri`.
+ */
+static void add_tri_crossings(const BoolInput &input,
+                              const int3 &tri,
+                              const int sides[3],
+                              const int other_index,
+                              Vector<PointKey, 8> &points)
+{
+  const Span<double3> positions = input.positions;
+  const int3 &other = input.tris[other_index];
+  for (const int i : IndexRange(3)) {
+    const int v0 = tri[i];
+    const int v1 = tri[(i + 1) % 3];
+    if (sides[i] == 0) {
+      const int axis = dominant_axis(tri_normal(positions, other));
+      if (point_in_tri_2d(project_2d(positions[v0], axis),
+                          project_2d(positions[other[0]], axis),
+                          project_2d(positions[other[1]], axis),
+                          project_2d(positions[other[2]], axis)))
+      {
+        points.append_non_duplicates(PointKey::vert(v0));
+      }
+      if (sides[(i + 1) % 3] == 0) {
+        /* The edge lies in the plane of the other triangle. */
+        Vector<std::pair<double, PointKey>, 8> crossings;
+        add_coplanar_edge_crossings(input, v0, v1, other, axis, crossings);
+        for (const std::pair<double, PointKey> &crossing : crossings) {
+          points.append_non_duplicates(crossing.second);
+        }
+      }
+      continue;
+    }
+    if (sides[i] * sides[(i + 1) % 3] >= 0) {
+      continue;
+    }
+    /* The edge crosses the plane. The side of the edge's line relative to the edges of the other
+     * triangle tells whether it crosses inside of it, or exactly through one of its edges or
+     * vertices. */
+    bool has_positive = false;
+    bool has_negative = false;
+    int zero_edges[3];
+    int zero_edges_num = 0;
+    for (const int k : IndexRange(3)) {
+      const int side = orient3d(
+          positions[v0], positions[v1], positions[other[k]], positions[other[(k + 1) % 3]]);
+      has_positive |= side > 0;
+      has_negative |= side < 0;
+      if (side == 0) {
+        zero_edges[zero_edges_num++] = k;
+      }
+    }
+    if (has_positive && has_negative) {
+      continue;
+    }
+    if (zero_edges_num == 0) {
+      points.append_non_duplicates(PointKey::edge_tri(v0, v1, other_index));
+    }
+    else if (zero_edges_num == 1) {
+      const int k = zero_edges[0];
+      points.append_non_duplicates(
+          PointKey::edge_edge(v0, v1, other[k], other[(k + 1) % 3]));
+    }
+    else {
+      /* Two adjacent edges of the other triangle meet at their shared vertex. */
+      const bool first_and_last = zero_edges[0] == 0 && zero_edges[1] == 2;
+      points.append_non_duplicates(PointKey::vert(other[first_and_last ? 0 : zero_edges[1]]));
+    }
+  }
+}
+
+/**
+ * Add the parts of the face edges of triangle `tri_b` that are inside of triangle `tri_a` as
+ * segments of the face of `tri_a`. Both triangles are in the same plane.
+ */
+static void add_coplanar_cuts(const BoolInput &input,
+                              const int tri_a,
+                              const int tri_b,
+                              const int axis,
+                              Vector<Segment> &r_segments)
+{
+  const Span<double3> positions = input.positions;
+  const int3 &a = input.tris[tri_a];
+  const int3 &b = input.tris[tri_b];
+  const std::array<double2, 3> a_2d = {project_2d(positions[a[0]], axis),
+                                       project_2d(positions[a[1]], axis),
+                                       project_2d(positions[a[2]], axis)};
+  for (const int k : IndexRange(3)) {
+    if (!(input.tri_face_edges[tri_b] & (1 << k))) {
+      /* Edges inside of the face of the other triangle are not cuts. */
+      continue;
+    }
+    const int v0 = b[k];
+    const int v1 = b[(k + 1) % 3];
+    const double2 p0 = project_2d(positions[v0], axis);
+    const double2 p1 = project_2d(positions[v1], axis);
+    const double2 dir = p1 - p0;
+    const double length_sq = math::dot(dir, dir);
+    if (length_sq == 0.0) {
+      continue;
+    }
+    /* Points of the edge that are inside of the triangle, with their parameter along it. */
+    Vector<std::pair<double, PointKey>, 8> points;
+    if (point_in_tri_2d(p0, a_2d[0], a_2d[1], a_2d[2])) {
+      points.append({0.0, PointKey::vert(v0)});
+    }
+    if (point_in_tri_2d(p1, a_2d[0], a_2d[1], a_2d[2])) {
+      points.append({length_sq, PointKey::vert(v1)});
+    }
+    add_coplanar_edge_crossings(input, v0, v1, a, axis, points);
+    if (points.size() < 2) {
+      continue;
+    }
+    const auto [min, max] = std::minmax_element(
+        points.begin(), points.end(), [](const auto &x, const auto &y) {
+          return x.first < y.first;
+        });
+    if (min->first < max->first && min->second != max->second) {
+      r_segments.append({input.tri_faces[tri_a], min->second, max->second});
+    }
+  }
+}
+
+static bool is_degenerate(const BoolInput &input, const int tri)
+{
+  return math::is_zero(tri_normal(input.positions, input.tris[tri]));
+}
+
+/** Add the intersection of two triangles of different operands as segments of their faces. */
+static void intersect_tri_pair(const BoolInput &input,
+                               const int tri_a,
+                               const int tri_b,
+                               Vector<Segment> &r_segments)
+{
+  const Span<double3> positions = input.positions;
+  const int3 &a = input.tris[tri_a];
+  const int3 &b = input.tris[tri_b];
+  const auto all_on_one_side = [](const int sides[3]) {
+    return (sides[0] > 0 && sides[1] > 0 && sides[2] > 0) ||
+           (sides[0] < 0 && sides[1] < 0 && sides[2] < 0);
+  };
+
+  int sides_a[3];
+  for (const int i : IndexRange(3)) {
+    sides_a[i] = orient3d(positions[b[0]], positions[b[1]], positions[b[2]], positions[a[i]]);
+  }
+  if (all_on_one_side(sides_a)) {
+    return;
+  }
+  int sides_b[3];
+  for (const int i : IndexRange(3)) {
+    sides_b[i] = orient3d(positions[a[0]], positions[a[1]], positions[a[2]], positions[b[i]]);
+  }
+  if (all_on_one_side(sides_b)) {
+    return;
+  }
+  if (is_degenerate(input, tri_a) || is_degenerate(input, tri_b)) {
+    return;
+  }
+
+  if (sides_a[0] == 0 && sides_a[1] == 0 && sides_a[2] == 0) {
+    const int axis = dominant_axis(tri_normal(positions, a));
+    add_coplanar_cuts(input, tri_a, tri_b, axis, r_segments);
+    add_coplanar_cuts(input, tri_b, tri_a, axis, r_segments);
+    return;
+  }
+
+  /* The intersection is a segment on the line where the planes meet. Its end points are where the
+   * boundary of one triangle meets the other triangle. */
+  Vector<PointKey, 8> points;
+  add_tri_crossings(input, a, sides_a, tri_b, points);
+  add_tri_crossings(input, b, sides_b, tri_a, points);
+  if (points.size() < 2) {
+    return;
+  }
+  PointKey p0 = points[0];
+  PointKey p1 = points[1];
+  if (points.size() > 2) {
+    /* Degenerate configurations can find more than the two end points. */
+    double max_distance = -1.0;
+    for (const int i : points.index_range()) {
+      for (const int j : points.index_range().drop_front(i + 1)) {
+        const double distance = math::distance_squared(point_position(input, points[i]),
+                                                       point_position(input, points[j]));
+        if (distance > max_distance) {
+          max_distance = distance;
+          p0 = points[i];
+          p1 = points[j];
+        }
+      }
+    }
+  }
+  if (point_position(input, p0) == point_position(input, p1)) {
+    return;
+  }
+  r_segments.append({input.tri_faces[tri_a], p0, p1});
+  r_segments.append({input.tri_faces[tri_b], p0, p1});
+}
+
+/** Find all intersection segments between triangles of different operands. */
+static Vector<Segment> intersect_operands(const BoolInput &input, const float epsilon)
+{
+  const Span<double3> positions = input.positions;
+  if (input.tris.is_empty()) {
+    return {};
+  }
+  BVHTree *tree = BLI_bvhtree_new(input.tris.size(), epsilon, 4, 6);
+  for (const int i : input.tris.index_range()) {
+    const int3 &tri = input.tris[i];
+    const float3 cos[3] = {float3(positions[tri[0]]),
+                           float3(positions[tri[1]]),
+                           float3(positions[tri[2]])};
+    BLI_bvhtree_insert(tree, i, &cos[0].x, 3);
+  }
+  BLI_bvhtree_balance(tree);
+
+  uint overlap_num = 0;
+  BVHTreeOverlap *overlap = BLI_bvhtree_overlap_self(
+      tree,
+      &overlap_num,
+      [](void *userdata, const int index_a, const int index_b, const int /*thread*/) {
+        const BoolInput &input = *static_cast<const BoolInput *>(userdata);
+        return input.face_shapes[input.tri_faces[index_a]] !=
+               input.face_shapes[input.tri_faces[index_b]];
+      },
+      const_cast<BoolInput *>(&input));
+  BLI_bvhtree_free(tree);
+
+  /* Sort the pairs to make the result independent of the threaded tree traversal. */
+  Array<int2> pairs(overlap_num);
+  for (const int i : pairs.index_range()) {
+    pairs[i] = int2(std::min(overlap[i].indexA, overlap[i].indexB),
+                    std::max(overlap[i].indexA, overlap[i].indexB));
+  }
+  MEM_SAFE_FREE(overlap);
+  parallel_sort(pairs.begin(), pairs.end(), [](const int2 &a, const int2 &b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+
+  const int chunk_size = 1024;
+  Array<Vector<Segment>> chunk_segments(divide_ceil_u(pairs.size(), chunk_size));
+  threading::parallel_for(chunk_segments.index_range(), 1, [&](const IndexRange range) {
+    for (const int chunk : range) {
+      const IndexRange chunk_pairs = IndexRange::from_begin_end(
+          chunk * chunk_size, std::min<int64_t>((chunk + 1) * chunk_size, pairs.size()));
+      for (const int i : chunk_pairs) {
+        intersect_tri_pair(input, pairs[i].x, pairs[i].y, chunk_segments[chunk]);
+      }
+    }
+  });
+
+  Vector<Segment> segments;
+  for (const Vector<Segment> &chunk : chunk_segments) {
+    segments.extend(chunk);
+  }
+  return segments;
+}
+
+/** The pieces of an input face after inserting its intersection segments. */
+struct FaceSplit {
+  /** Positions of vertices created by the triangulation where segments cross. */
+  Vector<double3> new_positions;
+  /** Vertices of the pieces. Negative values index #new_positions as `-1 - index`. */
+  Vector<int> piece_offsets;
+  Vector<int> piece_verts;
+  Vector<int2> cut_edges;
+};
+
+/** Find the 3D position of a point in the projected face using its triangulation. */
+static double3 lift_to_face(const BoolInput &input,
+                            const int face,
+                            const FunctionRef<double2(const double3 &)> to_2d,
+                            const double2 &point)
+{
+  const Span<double3> positions = input.positions;
+  double3 best_position = positions[input.corner_verts[input.faces()[face].first()]];
+  double best_weight = -std::numeric_limits<double>::max();
+  for (const int tri_i : input.face_tris()[face]) {
+    const int3 &tri = input.tris[tri_i];
+    const double2 a = to_2d(positions[tri[0]]);
+    const double2 b = to_2d(positions[tri[1]]);
+    const double2 c = to_2d(positions[tri[2]]);
+    const double area = cross_2d(b - a, c - a);
+    if (area == 0.0) {
+      continue;
+    }
+    const double wa = cross_2d(b - point, c - point) / area;
+    const double wb = cross_2d(c - point, a - point) / area;
+    const double wc = 1.0 - wa - wb;
+    const double min_weight = std::min({wa, wb, wc});
+    if (min_weight > best_weight) {
+      best_weight = min_weight;
+      best_position = positions[tri[0]] * wa + positions[tri[1]] * wb + positions[tri[2]] * wc;
+    }
+  }
+  return best_position;
+}
+
+/**
+ * Split a face along the intersection segments in it. Vertices after the input vertices are the
+ * intersection points with the keys in `new_points`.
+ */
+static void split_face(const BoolInput &input,
+                       const int face,
+                       const Span<int2> segments,
+                       const Span<double3> positions,
+                       const Span<PointKey> new_points,
+                       FaceSplit &r_split)
+{
+  const Span<int> face_verts = input.corner_verts.as_span().slice(input.faces()[face]);
+  const double3 normal = polygon_normal(input.positions, face_verts);
+  const int axis = dominant_axis(normal);
+  const bool swap_2d = normal[axis] < 0.0;
+  const auto to_2d = [&](const double3 &co) {
+    const double2 co_2d = project_2d(co, axis);
+    return swap_2d ? double2(co_2d.y, co_2d.x) : co_2d;
+  };
+
+  VectorSet<int> verts;
+  verts.add_multiple(face_verts);
+  Vector<std::pair<int, int>> edges;
+  for (const int2 &segment : segments) {
+    if (segment[0] != segment[1]) {
+      edges.append({verts.index_of_or_add(segment[0]), verts.index_of_or_add(segment[1])});
+    }
+  }
+
+  /* Intersection points on the edges of the face are inserted into its boundary explicitly,
+   * because their rounded positions are generally not exactly on the edges. */
+  const int input_verts_num = input.positions.size();
+  struct EdgePoint {
+    int corner;
+    double factor;
+    int vert;
+  };
+  Vector<EdgePoint> edge_points;
+  const auto add_edge_point = [&](const int vert, const int v0, const int v1) {
+    for (const int corner : face_verts.index_range()) {
+      const int next = (corner + 1) % face_verts.size();
+      if ((face_verts[corner] == v0 && face_verts[next] == v1) ||
+          (face_verts[corner] == v1 && face_verts[next] == v0))
+      {
+        const double3 &start = positions[face_verts[corner]];
+        const double factor = math::dot(positions[vert] - start,
+                                        positions[face_verts[next]] - start);
+        edge_points.append({corner, factor, int(verts.index_of(vert))});
+        return;
+      }
+    }
+  };
+  for (const int i : verts.index_range().drop_front(face_verts.size())) {
+    if (verts[i] < input_verts_num) {
+      continue;
+    }
+    const PointKey &key = new_points[verts[i] - input_verts_num];
+    add_edge_point(verts[i], key.a, key.b);
+    if (key.kind == PointKind::EdgeEdge) {
+      add_edge_point(verts[i], key.c, key.d);
+    }
+  }
+  std::sort(edge_points.begin(), edge_points.end(), [](const EdgePoint &a, const EdgePoint &b) {
+    return a.corner < b.corner || (a.corner == b.corner && a.factor < b.factor);
+  });
+
+  meshintersect::CDT_input<double> cdt_input;
+  cdt_input.vert.reinitialize(verts.size());
+  for (const int i : verts.index_range()) {
+    cdt_input.vert[i] = to_2d(positions[verts[i]]);
+  }
+  cdt_input.edge = edges.as_span();
+  cdt_input.face.reinitialize(1);
+  Vector<int> &boundary = cdt_input.face[0];
+  int edge_point = 0;
+  for (const int corner : face_verts.index_range()) {
+    boundary.append(corner);
+    for (; edge_point < edge_points.size() && edge_points[edge_point].corner == corner;
+         edge_point++)
+    {
+      boundary.append(edge_points[edge_point].vert);
+    }
+  }
+  const meshintersect::CDT_result<double> cdt = meshintersect::delaunay_2d_calc(
+      cdt_input, CDT_CONSTRAINTS_VALID_BMESH);
+
+  Array<int> cdt_verts(cdt.vert.size());
+  for (const int i : cdt.vert.index_range()) {
+    if (cdt.vert_orig[i].is_empty()) {
+      r_split.new_positions.append(lift_to_face(input, face, to_2d, cdt.vert[i]));
+      cdt_verts[i] = -r_split.new_positions.size();
+    }
+    else {
+      cdt_verts[i] = verts[cdt.vert_orig[i].first()];
+    }
+  }
+
+  r_split.piece_offsets.append(0);
+  for (const int i : cdt.face.index_range()) {
+    if (cdt.face_orig[i].is_empty()) {
+      continue;
+    }
+    for (const int vert : cdt.face[i]) {
+      r_split.piece_verts.append(cdt_verts[vert]);
+    }
+    r_split.piece_offsets.append(r_split.piece_verts.size());
+  }
+
+  for (const int i : cdt.edge.index_range()) {
+    const bool is_segment = std::any_of(
+        cdt.edge_orig[i].begin(), cdt.edge_orig[i].end(), [&](const int orig) {
+          return orig < cdt.face_edge_offset;
+        });
+    if (is_segment) {
+      r_split.cut_edges.append(int2(cdt_verts[cdt.edge[i].first], cdt_verts[cdt.edge[i].second]));
+    }
+  }
+}
+
+/** A point inside of the polygon, away from its edges if possible. */
+static double3 polygon_inner_point(const Span<double3> positions,
+                                   const Span<int> verts,
+                                   const double3 &normal)
+{
+  const int axis = dominant_axis(normal);
+  const int orientation = normal[axis] > 0.0 ? 1 : -1;
+  const int verts_num = verts.size();
+  Array<double2, 16> verts_2d(verts_num);
+  for (const int i : verts.index_range()) {
+    verts_2d[i] = project_2d(positions[verts[i]], axis);
+  }
+  /* Use the center of the largest ear of the polygon, which also works for concave polygons.
+   * Intersection points are not exactly on the polygon edges, so there can be tiny ears. */
+  double best_area = 0.0;
+  double3 best_center;
+  for (const int i : verts.index_range()) {
+    const int prev = (i + verts_num - 1) % verts_num;
+    const int next = (i + 1) % verts_num;
+    if (orient2d(verts_2d[prev], verts_2d[i], verts_2d[next]) != orientation) {
+      continue;
+    }
+    bool is_ear = true;
+    for (const int j : verts.index_range()) {
+      if (ELEM(j, prev, i, next)) {
+        continue;
+      }
+      if (point_in_tri_2d(verts_2d[j], verts_2d[prev], verts_2d[i], verts_2d[next])) {
+        is_ear = false;
+        break;
+      }
+    }
+    const double area = std::abs(
+        cross_2d(verts_2d[i] - verts_2d[prev], verts_2d[next] - verts_2d[prev]));
+    if (is_ear && area > best_area) {
+      best_area = area;
+      best_center = (positions[verts[prev]] + positions[verts[i]] + positions[verts[next]]) / 3.0;
+    }
+  }
+  if (best_area > 0.0) {
+    return best_center;
+  }
+  double3 center(0.0);
+  for (const int vert : verts) {
+    center += positions[vert];
+  }
+  return center / double(verts_num);
+}
+
+/**
+ * The solid angle of the triangle seen from the origin. It is more than a hemisphere only close to
+ * the triangle, then `r_on_surface` is set for points closer than `tolerance` to its plane.
+ */
+static double tri_solid_angle(const double3 &a,
+                              const double3 &b,
+                              const double3 &c,
+                              const double tolerance,
+                              bool &r_on_surface)
+{
+  const double la = math::length(a);
+  const double lb = math::length(b);
+  const double lc = math::length(c);
+  const double numerator = math::dot(a, math::cross(b, c));
+  const double denominator = la * lb * lc + math::dot(a, b) * lc + math::dot(b, c) * la +
+                             math::dot(c, a) * lb;
+  if (denominator <= 0.0 && !r_on_surface) {
+    const double area_2 = math::length(math::cross(b - a, c - a));
+    r_on_surface = std::abs(numerator) <= tolerance * area_2;
+  }
+  return 2.0 * std::atan2(numerator, denominator);
+}
+
+static constexpr int winding_tree_leaf_size = 8;
+
+static int winding_tree_build_node(const BoolInput &input,
+                                   WindingNumberTree &tree,
+                                   const IndexRange tris_range)
+{
+  const Span<double3> positions = input.positions;
+  MutableSpan<int> tris = tree.tris.as_mutable_span().slice(tris_range);
+
+  double3 normal(0.0);
+  double3 weighted_center(0.0);
+  double area = 0.0;
+  double3 centroid_sum(0.0);
+  Bounds<double3> centroid_bounds{double3(std::numeric_limits<double>::max()),
+                                  double3(std::numeric_limits<double>::lowest())};
+  for (const int tri_i : tris) {
+    const int3 &tri = input.tris[tri_i];
+    const double3 &a = positions[tri[0]];
+    const double3 &b = positions[tri[1]];
+    const double3 &c = positions[tri[2]];
+    const double3 tri_normal = math::cross(b - a, c - a) * 0.5;
+    const double tri_area = math::length(tri_normal);
+    const double3 centroid = (a + b + c) / 3.0;
+    normal += tri_normal;
+    weighted_center += centroid * tri_area;
+    area += tri_area;
+    centroid_sum += centroid;
+    centroid_bounds.min = math::min(centroid_bounds.min, centroid);
+    centroid_bounds.max = math::max(centroid_bounds.max, centroid);
+  }
+
+  WindingNumberTree::Node node;
+  node.center = area > 0.0 ? weighted_center / area : centroid_sum / double(tris.size());
+  node.normal = normal;
+  node.radius = 0.0;
+  for (const int tri_i : tris) {
+    for (const int k : IndexRange(3)) {
+      const double3 &position = positions[input.tris[tri_i][k]];
+      node.radius = std::max(node.radius, math::distance(position, node.center));
+    }
+  }
+  node.children = int2(-1);
+  node.tris_range = tris_range;
+
+  const int node_index = tree.nodes.append_and_get_index(node);
+  if (tris.size() <= winding_tree_leaf_size) {
+    return node_index;
+  }
+
+  /* Split at the median centroid along the largest extent of the centroids. */
+  const int axis = dominant_axis(centroid_bounds.max - centroid_bounds.min);
+  const auto centroid = [&](const int tri_i) {
+    const int3 &tri = input.tris[tri_i];
+    return positions[tri[0]][axis] + positions[tri[1]][axis] + positions[tri[2]][axis];
+  };
+  const int mid = tris.size() / 2;
+  std::nth_element(tris.begin(), tris.begin() + mid, tris.end(), [&](const int a, const int b) {
+    return centroid(a) < centroid(b);
+  });
+
+  const int left = winding_tree_build_node(input, tree, tris_range.take_front(mid));
+  const int right = winding_tree_build_node(input, tree, tris_range.drop_front(mid));
+  tree.nodes[node_index].children = int2(left, right);
+  return node_index;
+}
+
+static WindingNumberTree build_winding_tree(const BoolInput &input, const int shape)
+{
+  const IndexRange shape_tris = input.shape_tris[shape];
+  WindingNumberTree tree;
+  tree.tris.reinitialize(shape_tris.size());
+  array_utils::fill_index_range<int>(tree.tris, shape_tris.start());
+  if (!shape_tris.is_empty()) {
+    tree.nodes.reserve(shape_tris.size() / winding_tree_leaf_size * 2 + 1);
+    winding_tree_build_node(input, tree, tree.tris.index_range());
+  }
+  return tree;
+}
+
+/**
+ * The generalized winding number of the operand around the point, which is close to 1 inside of
+ * the closed operand and close to 0 outside. It is not well defined for points on the surface,
+ * which is reported with `r_on_surface` for points closer than `tolerance` to a triangle.
+ */
+static double winding_number(const BoolInput &input,
+                             const int shape,
+                             const double3 &point,
+                             const double tolerance,
+                             bool &r_on_surface)
+{
+  /* Nodes further away than this factor times their radius are approximated. */
+  constexpr double accuracy = 2.0;
+
+  const Span<double3> positions = input.positions;
+  const WindingNumberTree &tree = input.shape_winding_trees[shape];
+  r_on_surface = false;
+  double solid_angle = 0.0;
+
+  Vector<int, 64> stack;
+  if (!tree.nodes.is_empty()) {
+    stack.append(0);
+  }
+  while (!stack.is_empty()) {
+    const WindingNumberTree::Node &node = tree.nodes[stack.pop_last()];
+    const double3 offset = node.center - point;
+    const double distance = math::length(offset);
+    /* The point is far from all triangles of the node, so it is never on their surface. */
+    if (distance > accuracy * node.radius && distance - node.radius > tolerance) {
+      solid_angle += math::dot(offset, node.normal) / (distance * distance * distance);
+      continue;
+    }
+    if (node.children[0] != -1) {
+      stack.append(node.children[0]);
+      stack.append(node.children[1]);
+      continue;
+    }
+    for (const int tri_i : tree.tris.as_span().slice(node.tris_range)) {
+      const int3 &tri = input.tris[tri_i];
+      solid_angle += tri_solid_angle(positions[tri[0]] - point,
+                                     positions[tri[1]] - point,
+                                     positions[tri[2]] - point,
+                                     tolerance,
+                                     r_on_surface);
+    }
+  }
+  return input.shape_orientation[shape] * solid_angle / (4.0 * M_PI);
+}
+
+/** Whether the result of the operation contains the points just inside and outside a patch. */
+struct PatchSides {
+  bool inside;
+  bool outside;
+};
+
+/**
+ * Decide whether a patch of faces of operand `shape` is part of the result boundary, from the
+ * sides of the patch that are in the result. For patches that lie on the surface of another
+ * operand, the points just inside and outside of the operand are tested instead of the patch
+ * itself. Of coinciding patches only the one of the first operand is kept. Returns 1 to keep the
+ * patch, -1 to keep it with flipped orientation, and 0 to remove it.
+ */
+static int classify_patch(const BoolInput &input,
+                          const Operation operation,
+                          const int shape,
+                          const double3 &point,
+                          const double3 &normal,
+                          const double tolerance)
+{
+  const double offset = tolerance * 10.0;
+  const double3 inner_point = point - normal * offset;
+  const double3 outer_point = point + normal * offset;
+
+  /* Membership of the points in the union of the operands other than the first, or in all of
+   * them for the intersection. */
+  PatchSides any_other{false, false};
+  PatchSides all{true, true};
+  PatchSides first{false, false};
+  bool coincides_with_previous = false;
+  for (const int other : IndexRange(input.shapes_num())) {
+    PatchSides sides{true, false};
+    if (other != shape) {
+      const Bounds<double3> &bounds = input.shape_bounds[other];
+      if (math::reduce_min(point - bounds.min + offset) < 0.0 ||
+          math::reduce_min(bounds.max - point + offset) < 0.0)
+      {
+        sides = {false, false};
+      }
+      else {
+        bool on_surface;
+        const bool is_inside = winding_number(input, other, point, tolerance, on_surface) > 0.5;
+        sides = {is_inside, is_inside};
+        if (on_surface) {
+          /* The patch lies on the surface of the other operand. */
+          sides = {winding_number(input, other, inner_point, 0.0, on_surface) > 0.5,
+                   winding_number(input, other, outer_point, 0.0, on_surface) > 0.5};
+        }
+      }
+      if (other < shape && sides.inside != sides.outside) {
+        coincides_with_previous = true;
+      }
+    }
+    if (other == 0) {
+      first = sides;
+    }
+    else {
+      any_other.inside |= sides.inside;
+      any_other.outside |= sides.outside;
+    }
+    all.inside &= sides.inside;
+    all.outside &= sides.outside;
+
+    if (operation == Operation::Intersect && !all.inside && !all.outside) {
+      return 0;
+    }
+    if (operation == Operation::Union && (first.outside || any_other.outside)) {
+      return 0;
+    }
+  }
+
+  PatchSides result;
+  switch (operation) {
+    case Operation::Intersect:
+      result = all;
+      break;
+    case Operation::Union:
+      result = {first.inside || any_other.inside, first.outside || any_other.outside};
+      break;
+    case Operation::Difference:
+      result = {first.inside && !any_other.inside, first.outside && !any_other.outside};
+      break;
+  }
+  if (result.inside == result.outside || coincides_with_previous) {
+    return 0;
+  }
+  return result.inside ? 1 : -1;
+}
+
+static BoolResult boolean(const BoolInput &input, const Operation operation)
+{
+  const OffsetIndices<int> faces = input.faces();
+  const Span<int> corner_verts = input.corner_verts;
+  const int input_verts_num = input.positions.size();
+
+  Bounds<double3> bounds = input.shape_bounds.first();
+  for (const Bounds<double3> &shape_bounds : input.shape_bounds) {
+    bounds = bounds::merge(bounds, shape_bounds);
+  }
+  const double extent = std::max(math::reduce_max(bounds.max - bounds.min), 1e-6);
+  const float merge_distance = float(extent * 1e-7);
+
+  /* Intersect all triangle pairs and give the intersection points vertex indices. New points are
+   * added after the input vertices. */
+  const Vector<Segment> segments = intersect_operands(input, merge_distance);
+  VectorSet<PointKey> new_points;
+  Array<int2> segment_verts(segments.size());
+  const auto point_vert = [&](const PointKey &key) {
+    if (key.kind == PointKind::Vert) {
+      return key.a;
+    }
+    return input_verts_num + int(new_points.index_of_or_add(key));
+  };
+  for (const int i : segments.index_range()) {
+    segment_verts[i] = int2(point_vert(segments[i].a), point_vert(segments[i].b));
+  }
+  Vector<double3> positions(input_verts_num + new_points.size());
+  positions.as_mutable_span().take_front(input_verts_num).copy_from(input.positions);
+  threading::parallel_for(new_points.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      positions[input_verts_num + i] = point_position(input, new_points[i]);
+    }
+  });
+
+  /* Group the segments by face. */
+  Array<int> face_segment_offsets(faces.size() + 1, 0);
+  for (const Segment &segment : segments) {
+    face_segment_offsets[segment.face]++;
+  }
+  const OffsetIndices face_segments = offset_indices::accumulate_counts_to_offsets(
+      face_segment_offsets);
+  Array<int2> sorted_segment_verts(segments.size());
+  {
+    Array<int> fill(faces.size(), 0);
+    for (const int i : segments.index_range()) {
+      const int face = segments[i].face;
+      sorted_segment_verts[face_segments[face][fill[face]++]] = segment_verts[i];
+    }
+  }
+  Vector<int> cut_faces;
+  for (const int face : faces.index_range()) {
+    if (!face_segments[face].is_empty()) {
+      cut_faces.append(face);
+    }
+  }
+
+  /* Split the cut faces into pieces along the segments. */
+  Array<FaceSplit> splits(cut_faces.size());
+  threading::parallel_for(cut_faces.index_range(), 8, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int face = cut_faces[i];
+      split_face(input,
+                 face,
+                 sorted_segment_verts.as_span().slice(face_segments[face]),
+                 positions,
+                 new_points.as_span(),
+                 splits[i]);
+    }
+  });
+  Array<int> split_vert_offsets(cut_faces.size() + 1);
+  for (const int i : splits.index_range()) {
+    split_vert_offsets[i] = splits[i].new_positions.size();
+  }
+  const OffsetIndices split_verts = offset_indices::accumulate_counts_to_offsets(
+      split_vert_offsets, positions.size());
+  for (const FaceSplit &split : splits) {
+    positions.extend(split.new_positions);
+  }
+  const auto split_vert = [&](const int split_i, const int vert) {
+    return vert >= 0 ? vert : split_verts[split_i].first() - 1 - vert;
+  };
+
+  /* Weld points that are different symbolically but have (almost) the same position, which
+   * happens in degenerate configurations and where segments cross inside of faces. Input
+   * vertices come first and are preferred as the remaining vertex. */
+  Array<int> vert_map(positions.size());
+  array_utils::fill_index_range<int>(vert_map);
+  {
+    Vector<int> weld_verts;
+    Array<bool> is_weld_vert(positions.size(), false);
+    for (const int i : splits.index_range()) {
+      for (const int vert : splits[i].piece_verts) {
+        is_weld_vert[split_vert(i, vert)] = true;
+      }
+    }
+    for (const int vert : positions.index_range()) {
+      if (is_weld_vert[vert]) {
+        weld_verts.append(vert);
+      }
+    }
+    KDTree_3d *tree = BLI_kdtree_3d_new(weld_verts.size());
+    for (const int i : weld_verts.index_range()) {
+      BLI_kdtree_3d_insert(tree, i, float3(positions[weld_verts[i]]));
+    }
+    BLI_kdtree_3d_balance(tree);
+    Array<int> duplicates(weld_verts.size(), -1);
+    BLI_kdtree_3d_calc_duplicates_fast(tree, merge_distance, true, duplicates.data());
+    BLI_kdtree_3d_free(tree);
+    for (const int i : weld_verts.index_range()) {
+      if (duplicates[i] != -1) {
+        vert_map[weld_verts[i]] = weld_verts[duplicates[i]];
+      }
+    }
+  }
+
+  /* Gather all faces that may be part of the result. Faces without intersections are used as
+   * they are, cut faces are replaced by their pieces. */
+  Vector<int> candidate_offsets;
+  Vector<int> candidate_verts;
+  Vector<int> candidate_faces;
+  Vector<bool> candidate_is_piece;
+  Set<OrderedEdge> cut_edges;
+  {
+    int split_i = 0;
+    for (const int face : faces.index_range()) {
+      if (split_i < cut_faces.size() && cut_faces[split_i] == face) {
+        const FaceSplit &split = splits[split_i];
+        const OffsetIndices<int> pieces = split.piece_offsets.as_span();
+        for (const int piece : pieces.index_range()) {
+          const int start = candidate_verts.size();
+          for (const int i : pieces[piece]) {
+            const int vert = vert_map[split_vert(split_i, split.piece_verts[i])];
+            if (candidate_verts.size() == start || candidate_verts.last() != vert) {
+              candidate_verts.append(vert);
+            }
+          }
+          while (candidate_verts.size() > start + 1 &&
+                 candidate_verts.last() == candidate_verts[start])
+          {
+            candidate_verts.remove_last();
+          }
+          if (candidate_verts.size() - start < 3) {
+            candidate_verts.resize(start);
+            continue;
+          }
+          candidate_offsets.append(start);
+          candidate_faces.append(face);
+          candidate_is_piece.append(true);
+        }
+        for (const int2 &edge : split.cut_edges) {
+          const int v0 = vert_map[split_vert(split_i, edge[0])];
+          const int v1 = vert_map[split_vert(split_i, edge[1])];
+          if (v0 != v1) {
+            cut_edges.add(OrderedEdge(v0, v1));
+          }
+        }
+        split_i++;
+        continue;
+      }
+      candidate_offsets.append(candidate_verts.size());
+      for (const int vert : corner_verts.slice(faces[face])) {
+        candidate_verts.append(vert_map[vert]);
+      }
+      candidate_faces.append(face);
+      candidate_is_piece.append(false);
+    }
+    candidate_offsets.append(candidate_verts.size());
+  }
+  const OffsetIndices<int> candidates = candidate_offsets.as_span();
+
+  /* Join faces of the same operand into patches when they share an edge that is not cut. */
+  DisjointSet<int> patch_sets(candidates.size());
+  {
+    Map<OrderedEdge, int> edge_faces;
+    edge_faces.reserve(candidate_verts.size());
+    for (const int i : candidates.index_range()) {
+      const Span<int> verts = candidate_verts.as_span().slice(candidates[i]);
+      const int shape = input.face_shapes[candidate_faces[i]];
+      for (const int corner : verts.index_range()) {
+        const OrderedEdge edge(verts[corner], verts[(corner + 1) % verts.size()]);
+        if (cut_edges.contains(edge)) {
+          continue;
+        }
+        const int other = edge_faces.lookup_or_add(edge, i);
+        if (other != i && input.face_shapes[candidate_faces[other]] == shape) {
+          patch_sets.join(i, other);
+        }
+      }
+    }
+  }
+  Array<int> candidate_patches(candidates.size());
+  VectorSet<int> patch_roots;
+  for (const int i : candidates.index_range()) {
+    candidate_patches[i] = patch_roots.index_of_or_add(patch_sets.find_root(i));
+  }
+
+  /* Classify every patch with the point of its largest face. */
+  Array<double3> candidate_normals(candidates.size());
+  threading::parallel_for(candidates.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      candidate_normals[i] = polygon_normal(positions,
+                                            candidate_verts.as_span().slice(candidates[i]));
+    }
+  });
+  Array<int> patch_faces(patch_roots.size(), -1);
+  for (const int i : candidates.index_range()) {
+    int &patch_face = patch_faces[candidate_patches[i]];
+    if (patch_face == -1 || math::length_squared(candidate_normals[i]) >
+                                math::length_squared(candidate_normals[patch_face]))
+    {
+      patch_face = i;
+    }
+  }
+  Array<int> patch_actions(patch_roots.size());
+  threading::parallel_for(patch_faces.index_range(), 1, [&](const IndexRange range) {
+    for (const int patch : range) {
+      const int i = patch_faces[patch];
+      const int shape = input.face_shapes[candidate_faces[i]];
+      const double3 &normal = candidate_normals[i];
+      const double area = math::length(normal) * 0.5;
+      if (area == 0.0) {
+        patch_actions[patch] = 0;
+        continue;
+      }
+      const double3 point = polygon_inner_point(
+          positions, candidate_verts.as_span().slice(candidates[i]), normal);
+      patch_actions[patch] = classify_patch(input,
+                                            operation,
+                                            shape,
+                                            point,
+                                            normal / (2.0 * area) * input.shape_orientation[shape],
+                                            merge_distance);
+    }
+  });
+
+  Vector<int> result_faces;
+  for (const int i : candidates.index_range()) {
+    if (patch_actions[candidate_patches[i]] != 0) {
+      result_faces.append(i);
+    }
+  }
+
+  /* Dissolve new vertices in the middle of straight chains of two edges. They are created where
+   * an intersection crosses the triangulation of a face, and may only exist on one side of an edge
+   * that lies on the boundary of a face of another operand. */
+  Array<int2> vert_neighbors(positions.size() - input_verts_num, int2(-1));
+  Array<bool> dissolve(positions.size() - input_verts_num, true);
+  const auto add_neighbor = [&](const int vert, const int neighbor) {
+    int2 &neighbors = vert_neighbors[vert - input_verts_num];
+    if (ELEM(neighbor, neighbors[0], neighbors[1])) {
+      return;
+    }
+    if (neighbors[0] == -1) {
+      neighbors[0] = neighbor;
+    }
+    else if (neighbors[1] == -1) {
+      neighbors[1] = neighbor;
+    }
+    else {
+      dissolve[vert - input_verts_num] = false;
+    }
+  };
+  for (const int i : result_faces) {
+    const Span<int> verts = candidate_verts.as_span().slice(candidates[i]);
+    for (const int j : verts.index_range()) {
+      if (verts[j] >= input_verts_num) {
+        add_neighbor(verts[j], verts[(j + 1) % verts.size()]);
+        add_neighbor(verts[j], verts[(j + verts.size() - 1) % verts.size()]);
+      }
+    }
+  }
+  threading::parallel_for(dissolve.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int2 &neighbors = vert_neighbors[i];
+      if (!dissolve[i] || neighbors[1] == -1) {
+        dissolve[i] = false;
+        continue;
+      }
+      const double3 &a = positions[neighbors[0]];
+      const double3 dir = positions[neighbors[1]] - a;
+      const double3 offset = positions[input_verts_num + i] - a;
+      dissolve[i] = math::length(math::cross(dir, offset)) <= merge_distance * math::length(dir);
+    }
+  });
+  const auto is_dissolved = [&](const int vert) {
+    return vert >= input_verts_num && dissolve[vert - input_verts_num];
+  };
+  for (const int i : result_faces) {
+    const Span<int> verts = candidate_verts.as_span().slice(candidates[i]);
+    if (std::count_if(verts.begin(), verts.end(), is_dissolved) < verts.size() - 2) {
+      continue;
+    }
+    /* Keep the face valid, which can only be a problem for degenerate faces. */
+    for (const int vert : verts) {
+      if (is_dissolved(vert)) {
+        dissolve[vert - input_verts_num] = false;
+      }
+    }
+  }
+
+  /* Build the result with compacted vertex indices. */
+  BoolResult result;
+  Array<int> result_vert_indices(positions.size(), -1);
+  result.face_offsets.reinitialize(result_faces.size() + 1);
+  for (const int result_face : result_faces.index_range()) {
+    const Span<int> verts = candidate_verts.as_span().slice(candidates[result_faces[result_face]]);
+    int size = 0;
+    for (const int vert : verts) {
+      if (!is_dissolved(vert)) {
+        result_vert_indices[vert] = 0;
+        size++;
+      }
+    }
+    result.face_offsets[result_face] = size;
+  }
+  const OffsetIndices result_face_offsets = offset_indices::accumulate_counts_to_offsets(
+      result.face_offsets);
+  int result_verts_num = 0;
+  for (int &index : result_vert_indices) {
+    if (index == 0) {
+      index = result_verts_num++;
+    }
+  }
+  result.positions.reinitialize(result_verts_num);
+  result.vert_orig.reinitialize(result_verts_num);
+  for (const int vert : positions.index_range()) {
+    const int index = result_vert_indices[vert];
+    if (index != -1) {
+      result.positions[index] = positions[vert];
+      result.vert_orig[index] = vert < input_verts_num ? vert : -1;
+    }
+  }
+
+  const int result_corners_num = result_face_offsets.total_size();
+  result.face_orig.reinitialize(result_faces.size());
+  result.corner_verts.reinitialize(result_corners_num);
+  result.corner_orig.reinitialize(result_corners_num);
+  result.corner_edge_orig.reinitialize(result_corners_num);
+  result.corner_is_cut.reinitialize(result_corners_num);
+  threading::parallel_for(result_faces.index_range(), 512, [&](const IndexRange range) {
+    Vector<int> verts;
+    for (const int result_face : range) {
+      const int i = result_faces[result_face];
+      const int face = candidate_faces[i];
+      const int shape = input.face_shapes[face];
+      const IndexRange orig_corners = faces[face];
+      const IndexRange corners = result_face_offsets[result_face];
+      result.face_orig[result_face] = face;
+
+      verts.clear();
+      verts.extend(candidate_verts.as_span().slice(candidates[i]));
+      if (patch_actions[candidate_patches[i]] * input.shape_orientation[shape] < 0) {
+        std::reverse(verts.begin(), verts.end());
+      }
+      /* Start at a vertex that is not dissolved. */
+      const int start = std::find_if_not(verts.begin(), verts.end(), is_dissolved) -
+                        verts.begin();
+      std::rotate(verts.begin(), verts.begin() + start, verts.end());
+
+      const auto find_orig_corner = [&](const int vert) {
+        for (const int corner : orig_corners) {
+          if (corner_verts[corner] == vert) {
+            return corner;
+          }
+        }
+        return -1;
+      };
+      int corner = corners.start();
+      for (const int j : verts.index_range()) {
+        const int vert = verts[j];
+        if (is_dissolved(vert)) {
+          continue;
+        }
+        int next_j = (j + 1) % verts.size();
+        while (is_dissolved(verts[next_j])) {
+          next_j = (next_j + 1) % verts.size();
+        }
+        const int next_vert = verts[next_j];
+        result.corner_verts[corner] = result_vert_indices[vert];
+        result.corner_is_cut[corner] = cut_edges.contains(
+            OrderedEdge(vert, verts[(j + 1) % verts.size()]));
+        result.corner_orig[corner] = -1;
+        result.corner_edge_orig[corner] = -1;
+        corner++;
+        if (vert >= input_verts_num) {
+          continue;
+        }
+        const int orig_corner = find_orig_corner(vert);
+        result.corner_orig[corner - 1] = orig_corner;
+        if (orig_corner == -1 || next_vert >= input_verts_num) {
+          continue;
+        }
+        const int orig_next = orig_corner == orig_corners.last() ? orig_corners.first() :
+                                                                   orig_corner + 1;
+        const int orig_prev = orig_corner == orig_corners.first() ? orig_corners.last() :
+                                                                    orig_corner - 1;
+        if (corner_verts[orig_next] == next_vert) {
+          result.corner_edge_orig[corner - 1] = orig_corner;
+        }
+        else if (corner_verts[orig_prev] == next_vert) {
+          result.corner_edge_orig[corner - 1] = orig_prev;
+        }
+      }
+    }
+  });
+  return result;
+}
+
+/** Whether every edge of the mesh is used by exactly two faces, once in each direction. */
+static bool is_closed_manifold(const Mesh &mesh)
+{
+  const Span<int2> edges = mesh.edges();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int> corner_edges = mesh.corner_edges();
+  Array<int> forward_num(edges.size(), 0);
+  Array<int> backward_num(edges.size(), 0);
+  for (const int corner : corner_edges.index_range()) {
+    const int edge = corner_edges[corner];
+    if (corner_verts[corner] == edges[edge][0]) {
+      forward_num[edge]++;
+    }
+    else {
+      backward_num[edge]++;
+    }
+  }
+  return threading::parallel_reduce(
+      edges.index_range(),
+      4096,
+      true,
+      [&](const IndexRange range, const bool is_manifold) {
+        if (!is_manifold) {
+          return false;
+        }
+        for (const int edge : range) {
+          if (forward_num[edge] != 1 || backward_num[edge] != 1) {
+            return false;
+          }
+        }
+        return true;
+      },
+      std::logical_and<>());
+}
+
+static BoolInput meshes_to_bool_input(Span<const Mesh *> meshes,
+                                      Span<float4x4> transforms,
+                                      const float4x4 &target_transform)
+{
+  const int meshes_num = meshes.size();
+  bool ok;
+  float4x4 inv_target_mat = math::invert(target_transform, ok);
+  if (!ok) {
+    BLI_assert_unreachable();
+    inv_target_mat = float4x4::identity();
+  }
+
+  Array<int> vert_offsets_data(meshes_num + 1);
+  Array<int> face_offsets_data(meshes_num + 1);
+  Array<int> corner_offsets_data(meshes_num + 1);
+  Array<int> tri_offsets_data(meshes_num + 1);
+  for (const int i : meshes.index_range()) {
+    vert_offsets_data[i] = meshes[i]->verts_num;
+    face_offsets_data[i] = meshes[i]->faces_num;
+    corner_offsets_data[i] = meshes[i]->corners_num;
+    tri_offsets_data[i] = poly_to_tri_count(meshes[i]->faces_num, meshes[i]->corners_num);
+  }
+  const OffsetIndices vert_offsets = offset_indices::accumulate_counts_to_offsets(
+      vert_offsets_data);
+  const OffsetIndices face_offsets = offset_indices::accumulate_counts_to_offsets(
+      face_offsets_data);
+  const OffsetIndices corner_offsets = offset_indices::accumulate_counts_to_offsets(
+      corner_offsets_data);
+  const OffsetIndices tri_offsets = offset_indices::accumulate_counts_to_offsets(
+      tri_offsets_data);
+
+  BoolInput input;
+  input.positions.reinitialize(vert_offsets.total_size());
+  input.face_offsets.reinitialize(face_offsets.total_size() + 1);
+  input.face_tri_offsets.reinitialize(face_offsets.total_size() + 1);
+  input.corner_verts.reinitialize(corner_offsets.total_size());
+  input.face_shapes.reinitialize(face_offsets.total_size());
+  input.tris.reinitialize(tri_offsets.total_size());
+  input.tri_faces.reinitialize(tri_offsets.total_size());
+  input.tri_face_edges.reinitialize(tri_offsets.total_size());
+  input.shape_tris.reinitialize(meshes_num);
+  input.shape_bounds.reinitialize(meshes_num);
+  input.shape_orientation.reinitialize(meshes_num);
+
+  threading::parallel_for(meshes.index_range(), 1, [&](const IndexRange range) {
+    for (const int mesh_i : range) {
+      const Mesh &mesh = *meshes[mesh_i];
+      const float4x4 to_target = transforms.is_empty() ? inv_target_mat :
+                                                         inv_target_mat * transforms[mesh_i];
+      const double4x4 to_target_double(to_target);
+      const int vert_start = vert_offsets[mesh_i].start();
+      const int face_start = face_offsets[mesh_i].start();
+      const int corner_start = corner_offsets[mesh_i].start();
+      const int tri_start = tri_offsets[mesh_i].start();
+
+      const Span<float3> src_positions = mesh.vert_positions();
+      MutableSpan<double3> positions = input.positions.as_mutable_span().slice(
+          vert_offsets[mesh_i]);
+      threading::parallel_for(src_positions.index_range(), 2048, [&](const IndexRange range) {
+        for (const int i : range) {
+          positions[i] = math::transform_point(to_target_double, double3(src_positions[i]));
+        }
+      });
+      if (const std::optional<Bounds<double3>> bounds = bounds::min_max(positions.as_span())) {
+        input.shape_bounds[mesh_i] = *bounds;
+      }
+      else {
+        input.shape_bounds[mesh_i] = {double3(std::numeric_limits<double>::max()),
+                                      double3(std::numeric_limits<double>::lowest())};
+      }
+      input.shape_orientation[mesh_i] = math::is_negative(to_target) ? -1 : 1;
+      input.shape_tris[mesh_i] = tri_offsets[mesh_i];
+
+      const OffsetIndices faces = mesh.faces();
+      const Span<int> src_corner_verts = mesh.corner_verts();
+      threading::parallel_for(faces.index_range(), 2048, [&](const IndexRange range) {
+        for (const int i : range) {
+          input.face_offsets[face_start + i] = corner_start + faces[i].start();
+          input.face_tri_offsets[face_start + i] = tri_start +
+                                                   bke::mesh::face_triangles_range(faces, i)
+                                                       .start();
+          input.face_shapes[face_start + i] = mesh_i;
+        }
+      });
+      threading::parallel_for(src_corner_verts.index_range(), 4096, [&](const IndexRange range) {
+        for (const int i : range) {
+          input.corner_verts[corner_start + i] = vert_start + src_corner_verts[i];
+        }
+      });
+
+      const Span<int3> corner_tris = mesh.corner_tris();
+      const Span<int> tri_faces = mesh.corner_tri_faces();
+      threading::parallel_for(corner_tris.index_range(), 2048, [&](const IndexRange range) {
+        for (const int i : range) {
+          const int3 &tri = corner_tris[i];
+          const IndexRange face = faces[tri_faces[i]];
+          input.tris[tri_start + i] = int3(vert_start + src_corner_verts[tri[0]],
+                                           vert_start + src_corner_verts[tri[1]],
+                                           vert_start + src_corner_verts[tri[2]]);
+          input.tri_faces[tri_start + i] = face_start + tri_faces[i];
+          uint8_t face_edges = 0;
+          for (const int k : IndexRange(3)) {
+            const int corner = tri[k];
+            const int next = tri[(k + 1) % 3];
+            if (next == bke::mesh::face_corner_next(face, corner) ||
+                corner == bke::mesh::face_corner_next(face, next))
+            {
+              face_edges |= 1 << k;
+            }
+          }
+          input.tri_face_edges[tri_start + i] = face_edges;
+        }
+      });
+    }
+  });
+  input.face_offsets.last() = corner_offsets.total_size();
+  input.face_tri_offsets.last() = tri_offsets.total_size();
+
+  input.shape_winding_trees.reinitialize(meshes_num);
+  threading::parallel_for(meshes.index_range(), 1, [&](const IndexRange range) {
+    for (const int mesh_i : range) {
+      input.shape_winding_trees[mesh_i] = build_winding_tree(input, mesh_i);
+    }
+  });
+  return input;
+}
+
+/** Pairs of layer indices of a source mesh and the result that store the same attribute. */
+static Vector<int2> matching_layers(const CustomData &source,
+                                    const CustomData &target,
+                                    const Span<StringRef> skip_names)
+{
+  Vector<int2> layers;
+  for (const int i : IndexRange(source.totlayer)) {
+    const CustomDataLayer &layer = source.layers[i];
+    if (skip_names.contains(layer.name)) {
+      continue;
+    }
+    const int target_i = CustomData_get_named_layer_index(
+        &target, eCustomDataType(layer.type), layer.name);
+    if (target_i != -1) {
+      layers.append({i, target_i});
+    }
+  }
+  return layers;
+}
+
+static void copy_layers(const CustomData &source,
+                        CustomData &target,
+                        const Span<int2> layers,
+                        const int src_index,
+                        const int dst_index)
+{
+  for (const int2 &layer : layers) {
+    CustomData_copy_data_layer(&source, &target, layer[0], layer[1], src_index, dst_index, 1);
+  }
+}
+
+static Mesh *bool_result_to_mesh(const BoolResult &result,
+                                 const BoolInput &input,
+                                 Span<const Mesh *> meshes,
+                                 Span<Array<short>> material_remaps,
+                                 Vector<int> *r_intersecting_edges)
+{
+  const int meshes_num = meshes.size();
+  Array<int> vert_starts(meshes_num + 1);
+  Array<int> face_starts(meshes_num + 1);
+  Array<int> corner_starts(meshes_num + 1);
+  vert_starts[0] = face_starts[0] = corner_starts[0] = 0;
+  for (const int i : meshes.index_range()) {
+    vert_starts[i + 1] = vert_starts[i] + meshes[i]->verts_num;
+    face_starts[i + 1] = face_starts[i] + meshes[i]->faces_num;
+    corner_starts[i + 1] = corner_starts[i] + meshes[i]->corners_num;
+  }
+  /* Index of the mesh that an element index of the concatenated input belongs to. */
+  const auto mesh_of = [](const Span<int> starts, const int index) {
+    return int(std::upper_bound(starts.begin(), starts.end(), index) - starts.begin()) - 1;
+  };
+
+  const int verts_num = result.positions.size();
+  const int faces_num = result.face_orig.size();
+  const int corners_num = result.corner_verts.size();
+  Mesh *mesh = BKE_mesh_new_nomain_from_template(meshes[0], verts_num, 0, faces_num, corners_num);
+  for (const Mesh *src_mesh : meshes.drop_front(1)) {
+    CustomData_merge_layout(
+        &src_mesh->vert_data, &mesh->vert_data, CD_MASK_MESH.vmask, CD_SET_DEFAULT, verts_num);
+    CustomData_merge_layout(&src_mesh->corner_data,
+                            &mesh->corner_data,
+                            CD_MASK_MESH.lmask,
+                            CD_SET_DEFAULT,
+                            corners_num);
+    CustomData_merge_layout(
+        &src_mesh->face_data, &mesh->face_data, CD_MASK_MESH.pmask, CD_SET_DEFAULT, faces_num);
+  }
+
+  mesh->face_offsets_for_write().copy_from(result.face_offsets);
+  mesh->corner_verts_for_write().copy_from(result.corner_verts);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      positions[i] = float3(result.positions[i]);
+    }
+  });
+
+  Array<Vector<int2>> vert_layers(meshes_num);
+  Array<Vector<int2>> face_layers(meshes_num);
+  Array<Vector<int2>> corner_layers(meshes_num);
+  Array<VArraySpan<int>> material_indices(meshes_num);
+  for (const int i : meshes.index_range()) {
+    vert_layers[i] = matching_layers(meshes[i]->vert_data, mesh->vert_data, {"position"});
+    face_layers[i] = matching_layers(meshes[i]->face_data, mesh->face_data, {});
+    corner_layers[i] = matching_layers(
+        meshes[i]->corner_data, mesh->corner_data, {".corner_vert", ".corner_edge"});
+    material_indices[i] = *meshes[i]->attributes().lookup_or_default<int>(
+        "material_index", bke::AttrDomain::Face, 0);
+  }
+
+  threading::parallel_for(IndexRange(verts_num), 2048, [&](const IndexRange range) {
+    for (const int vert : range) {
+      const int orig = result.vert_orig[vert];
+      if (orig == -1) {
+        continue;
+      }
+      const int mesh_i = mesh_of(vert_starts, orig);
+      copy_layers(meshes[mesh_i]->vert_data,
+                  mesh->vert_data,
+                  vert_layers[mesh_i],
+                  orig - vert_starts[mesh_i],
+                  vert);
+    }
+  });
+
+  bke::SpanAttributeWriter<int> dst_material_indices =
+      mesh->attributes_for_write().lookup_or_add_for_write_only_span<int>("material_index",
+                                                                          bke::AttrDomain::Face);
+  const OffsetIndices<int> dst_faces = mesh->faces();
+  const OffsetIndices<int> src_faces = input.faces();
+  threading::parallel_for(IndexRange(faces_num), 512, [&](const IndexRange range) {
+    Vector<float> weights;
+    Vector<float2> orig_cos_2d;
+    Vector<const void *> src_blocks;
+    for (const int face : range) {
+      const int orig = result.face_orig[face];
+      const int mesh_i = mesh_of(face_starts, orig);
+      const Mesh &src_mesh = *meshes[mesh_i];
+      const int src_face = orig - face_starts[mesh_i];
+      copy_layers(src_mesh.face_data, mesh->face_data, face_layers[mesh_i], src_face, face);
+
+      const int src_material = material_indices[mesh_i][src_face];
+      const Span<short> material_remap = material_remaps.is_empty() ?
+                                             Span<short>() :
+                                             material_remaps[mesh_i].as_span();
+      if (material_remap.index_range().contains(src_material) &&
+          material_remap[src_material] >= 0)
+      {
+        dst_material_indices.span[face] = material_remap[src_material];
+      }
+      else {
+        dst_material_indices.span[face] = src_material;
+      }
+
+      /* Copy the data of corners at input vertices and interpolate the others in the input face,
+       * projected to 2D in the target space. */
+      const IndexRange orig_corners = src_faces[orig];
+      float axis_mat[3][3];
+      bool has_axis_mat = false;
+      for (const int corner : dst_faces[face]) {
+        const int orig_corner = result.corner_orig[corner];
+        if (orig_corner != -1) {
+          copy_layers(src_mesh.corner_data,
+                      mesh->corner_data,
+                      corner_layers[mesh_i],
+                      orig_corner - corner_starts[mesh_i],
+                      corner);
+          continue;
+        }
+        if (!has_axis_mat) {
+          const Span<int> orig_verts = input.corner_verts.as_span().slice(orig_corners);
+          const float3 normal(polygon_normal(input.positions, orig_verts));
+          axis_dominant_v3_to_m3(axis_mat, normal);
+          orig_cos_2d.resize(orig_verts.size());
+          for (const int i : orig_verts.index_range()) {
+            mul_v2_m3v3(orig_cos_2d[i], axis_mat, float3(input.positions[orig_verts[i]]));
+          }
+          weights.resize(orig_verts.size());
+          src_blocks.resize(orig_verts.size());
+          has_axis_mat = true;
+        }
+        float2 co;
+        mul_v2_m3v3(co, axis_mat, positions[result.corner_verts[corner]]);
+        interp_weights_poly_v2(weights.data(),
+                               reinterpret_cast<float(*)[2]>(orig_cos_2d.data()),
+                               orig_cos_2d.size(),
+                               co);
+        for (const int2 &layer : corner_layers[mesh_i]) {
+          if (!CustomData_layer_has_interp(&src_mesh.corner_data, layer[0])) {
+            continue;
+          }
+          const CustomDataLayer &src_layer = src_mesh.corner_data.layers[layer[0]];
+          const int size = CustomData_sizeof(eCustomDataType(src_layer.type));
+          for (const int i : orig_corners.index_range()) {
+            src_blocks[i] = POINTER_OFFSET(
+                src_layer.data, size * (orig_corners[i] - corner_starts[mesh_i]));
+          }
+          CustomData_bmesh_interp_n(&mesh->corner_data,
+                                    src_blocks.data(),
+                                    weights.data(),
+                                    nullptr,
+                                    orig_corners.size(),
+                                    POINTER_OFFSET(mesh->corner_data.layers[layer[1]].data,
+                                                   size * corner),
+                                    layer[1]);
+        }
+      }
+    }
+  });
+  dst_material_indices.finish();
+
+  bke::mesh_calc_edges(*mesh, false, false);
+  for (const Mesh *src_mesh : meshes) {
+    CustomData_merge_layout(&src_mesh->edge_data,
+                            &mesh->edge_data,
+                            CD_MASK_MESH.emask,
+                            CD_SET_DEFAULT,
+                            mesh->edges_num);
+  }
+  Array<Vector<int2>> edge_layers(meshes_num);
+  for (const int i : meshes.index_range()) {
+    edge_layers[i] = matching_layers(meshes[i]->edge_data, mesh->edge_data, {".edge_verts"});
+  }
+  const Span<int> corner_edges = mesh->corner_edges();
+  for (const int corner : IndexRange(corners_num)) {
+    const int orig_corner = result.corner_edge_orig[corner];
+    if (orig_corner == -1) {
+      continue;
+    }
+    const int mesh_i = mesh_of(corner_starts, orig_corner);
+    const Mesh &src_mesh = *meshes[mesh_i];
+    copy_layers(src_mesh.edge_data,
+                mesh->edge_data,
+                edge_layers[mesh_i],
+                src_mesh.corner_edges()[orig_corner - corner_starts[mesh_i]],
+                corner_edges[corner]);
+  }
+
+  if (r_intersecting_edges != nullptr) {
+    Array<bool> is_intersecting(mesh->edges_num, false);
+    for (const int corner : IndexRange(corners_num)) {
+      if (result.corner_is_cut[corner]) {
+        is_intersecting[corner_edges[corner]] = true;
+      }
+    }
+    for (const int edge : is_intersecting.index_range()) {
+      if (is_intersecting[edge]) {
+        r_intersecting_edges->append(edge);
+      }
+    }
+  }
+
+  return mesh;
+}
+
+}  // namespace manifold
+
+static Mesh *mesh_boolean_manifold(Span<const Mesh *> meshes,
+                                   Span<float4x4> transforms,
+                                   const float4x4 &target_transform,
+                                   Span<Array<short>> material_remaps,
+                                   const Operation operation,
+                                   Vector<int> *r_intersecting_edges,
+                                   BooleanError *r_error)
+{
+  BLI_assert(transforms.is_empty() || meshes.size() == transforms.size());
+  BLI_assert(material_remaps.is_empty() || material_remaps.size() == meshes.size());
+  if (meshes.is_empty()) {
+    return nullptr;
+  }
+  if (meshes.size() == 1) {
+    /* Like the float solver, there is no self union. */
+    return BKE_mesh_copy_for_eval(*meshes[0]);
+  }
+  for (const Mesh *mesh : meshes) {
+    if (!manifold::is_closed_manifold(*mesh)) {
+      if (r_error) {
+        *r_error = BooleanError::NonManifold;
+      }
+      return nullptr;
+    }
+  }
+
+  const manifold::BoolInput input = manifold::meshes_to_bool_input(
+      meshes, transforms, target_transform);
+  const manifold::BoolResult result = manifold::boolean(input, operation);
+  return manifold::bool_result_to_mesh(
+      result, input, meshes, material_remaps, r_intersecting_edges);
+}
+
+/** \} */
+
 Mesh *mesh_boolean(Span<const Mesh *> meshes,
                    Span<float4x4> transforms,
                    const float4x4 &target_transform,
                    Span<Array<short>> material_remaps,
                    BooleanOpParameters op_params,
                    Solver solver,
-                   Vector<int> *r_intersecting_edges)
+                   Vector<int> *r_intersecting_edges,
+                   BooleanError *r_error)
 {
-
+  if (r_error) {
+    *r_error = BooleanError::NoError;
+  }
   switch (solver) {
     case Solver::Float:
       return mesh_boolean_float(meshes,
@@ -1171,8 +3026,19 @@ Mesh *mesh_boolean(Span<const Mesh *> meshes,
                                    operation_to_mesh_arr_mode(op_params.boolean_mode),
                                    r_intersecting_edges);
 #else
+      if (r_error) {
+        *r_error = BooleanError::SolverNotAvailable;
+      }
       return nullptr;
 #endif
+    case Solver::Manifold:
+      return mesh_boolean_manifold(meshes,
+                                   transforms,
+                                   target_transform,
+                                   material_remaps,
+                                   op_params.boolean_mode,
+                                   r_intersecting_edges,
+                                   r_error);
     default:
       BLI_assert_unreachable();
   }
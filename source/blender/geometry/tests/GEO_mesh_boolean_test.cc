@@ -0,0 +1,171 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "BLI_math_matrix.hh"
+
+#include "GEO_mesh_boolean.hh"
+#include "GEO_mesh_primitive_cuboid.hh"
+#include "GEO_mesh_primitive_grid.hh"
+
+#include "testing/testing.h"
+
+namespace blender::geometry::boolean::tests {
+
+class MeshBooleanManifoldTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+  void TearDown() override
+  {
+    for (Mesh *mesh : meshes_) {
+      BKE_id_free(nullptr, mesh);
+    }
+  }
+
+  /** A unit cube centered at the origin, freed at the end of the test. */
+  const Mesh *cube()
+  {
+    meshes_.append(create_cuboid_mesh(float3(1.0f), 2, 2, 2));
+    return meshes_.last();
+  }
+
+  Mesh *run(const Mesh *mesh_a,
+            const Mesh *mesh_b,
+            const float4x4 &transform_b,
+            const Operation operation,
+            Vector<int> *r_intersecting_edges = nullptr)
+  {
+    const Array<const Mesh *> meshes = {mesh_a, mesh_b};
+    const Array<float4x4> transforms = {float4x4::identity(), transform_b};
+    BooleanOpParameters params;
+    params.boolean_mode = operation;
+    BooleanError error = BooleanError::NoError;
+    Mesh *result = mesh_boolean(meshes,
+                                transforms,
+                                float4x4::identity(),
+                                {},
+                                params,
+                                Solver::Manifold,
+                                r_intersecting_edges,
+                                &error);
+    EXPECT_EQ(error, BooleanError::NoError);
+    if (result) {
+      meshes_.append(result);
+    }
+    return result;
+  }
+
+ private:
+  Vector<Mesh *> meshes_;
+};
+
+/** Signed volume enclosed by the faces, negative if the faces point inwards. */
+static double mesh_volume(const Mesh &mesh)
+{
+  const Span<float3> positions = mesh.vert_positions();
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  double volume = 0.0;
+  for (const int face : faces.index_range()) {
+    const Span<int> face_verts = corner_verts.slice(faces[face]);
+    const double3 v0 = double3(positions[face_verts[0]]);
+    for (const int i : face_verts.index_range().drop_front(1).drop_back(1)) {
+      const double3 v1 = double3(positions[face_verts[i]]);
+      const double3 v2 = double3(positions[face_verts[i + 1]]);
+      volume += math::dot(v0, math::cross(v1, v2)) / 6.0;
+    }
+  }
+  return volume;
+}
+
+/** Whether every edge of the result is used by exactly two faces. */
+static bool mesh_is_closed(const Mesh &mesh)
+{
+  Array<int> edge_faces_num(mesh.edges_num, 0);
+  for (const int edge : mesh.corner_edges()) {
+    edge_faces_num[edge]++;
+  }
+  return std::all_of(edge_faces_num.begin(), edge_faces_num.end(), [](const int num) {
+    return num == 2;
+  });
+}
+
+static void expect_solid(const Mesh *mesh, const double volume)
+{
+  ASSERT_NE(mesh, nullptr);
+  EXPECT_NEAR(mesh_volume(*mesh), volume, 1e-5);
+  EXPECT_TRUE(mesh_is_closed(*mesh));
+}
+
+TEST_F(MeshBooleanManifoldTest, OffsetCubes)
+{
+  const float4x4 offset = math::from_location<float4x4>(float3(0.5f));
+  Vector<int> intersecting_edges;
+  expect_solid(run(cube(), cube(), offset, Operation::Union, &intersecting_edges), 1.875);
+  EXPECT_FALSE(intersecting_edges.is_empty());
+  expect_solid(run(cube(), cube(), offset, Operation::Intersect), 0.125);
+  expect_solid(run(cube(), cube(), offset, Operation::Difference), 0.875);
+}
+
+TEST_F(MeshBooleanManifoldTest, CoplanarFaces)
+{
+  /* Four of the faces of the second cube are coplanar with faces of the first. */
+  const float4x4 offset = math::from_location<float4x4>(float3(0.5f, 0.0f, 0.0f));
+  expect_solid(run(cube(), cube(), offset, Operation::Union), 1.5);
+  expect_solid(run(cube(), cube(), offset, Operation::Intersect), 0.5);
+  expect_solid(run(cube(), cube(), offset, Operation::Difference), 0.5);
+}
+
+TEST_F(MeshBooleanManifoldTest, SharedFace)
+{
+  /* The cubes only touch at one face. */
+  const float4x4 offset = math::from_location<float4x4>(float3(1.0f, 0.0f, 0.0f));
+  expect_solid(run(cube(), cube(), offset, Operation::Union), 2.0);
+  expect_solid(run(cube(), cube(), offset, Operation::Intersect), 0.0);
+  expect_solid(run(cube(), cube(), offset, Operation::Difference), 1.0);
+}
+
+TEST_F(MeshBooleanManifoldTest, IdenticalCubes)
+{
+  const float4x4 identity = float4x4::identity();
+  expect_solid(run(cube(), cube(), identity, Operation::Union), 1.0);
+  expect_solid(run(cube(), cube(), identity, Operation::Intersect), 1.0);
+  expect_solid(run(cube(), cube(), identity, Operation::Difference), 0.0);
+}
+
+TEST_F(MeshBooleanManifoldTest, MirroredTransform)
+{
+  /* A negative scale flips the winding of the second operand's faces, which has to be
+   * accounted for to keep the result pointing outwards. */
+  const float4x4 mirror = math::from_loc_scale<float4x4>(float3(0.5f),
+                                                         float3(-1.0f, 1.0f, 1.0f));
+  expect_solid(run(cube(), cube(), mirror, Operation::Union), 1.875);
+  expect_solid(run(cube(), cube(), mirror, Operation::Intersect), 0.125);
+  expect_solid(run(cube(), cube(), mirror, Operation::Difference), 0.875);
+}
+
+TEST_F(MeshBooleanManifoldTest, NonManifoldOperand)
+{
+  Mesh *grid = create_grid_mesh(3, 3, 1.0f, 1.0f, std::nullopt);
+  const Array<const Mesh *> meshes = {cube(), grid};
+  BooleanOpParameters params;
+  params.boolean_mode = Operation::Union;
+  BooleanError error = BooleanError::NoError;
+  const Mesh *result = mesh_boolean(
+      meshes, {}, float4x4::identity(), {}, params, Solver::Manifold, nullptr, &error);
+  EXPECT_EQ(result, nullptr);
+  EXPECT_EQ(error, BooleanError::NonManifold);
+  BKE_id_free(nullptr, grid);
+}
+
+}  // namespace blender::geometry::boolean::tests
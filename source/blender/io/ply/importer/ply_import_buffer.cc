@@ -5,6 +5,7 @@
 #include "ply_import_buffer.hh"
 
 #include "BLI_fileops.h"
+#include "BLI_mmap.h"
 
 #include <algorithm>
 #include <cstdio>
@@ -26,6 +27,9 @@ PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
 
 PlyReadBuffer::~PlyReadBuffer()
 {
+  if (mmap_file_ != nullptr) {
+    BLI_mmap_free(mmap_file_);
+  }
   if (file_ != nullptr) {
     fclose(file_);
   }
@@ -34,6 +38,46 @@ PlyReadBuffer::~PlyReadBuffer()
 void PlyReadBuffer::after_header(bool is_binary)
 {
   is_binary_ = is_binary;
+  if (!is_binary_ || file_ == nullptr) {
+    return;
+  }
+  /* Part of the binary data may already be in the buffer, find where it starts in the file. */
+  const int64_t file_pos = BLI_ftell(file_);
+  const int64_t offset = file_pos - int64_t(buf_used_ - pos_);
+  if (offset < 0) {
+    return;
+  }
+  mmap_file_ = BLI_mmap_open(fileno(file_));
+  if (mmap_file_ != nullptr && size_t(offset) > BLI_mmap_get_length(mmap_file_)) {
+    BLI_mmap_free(mmap_file_);
+    mmap_file_ = nullptr;
+  }
+  if (mmap_file_ == nullptr) {
+    /* Mapping the file moves the file descriptor to its end, continue buffered reading from
+     * where it was. */
+    BLI_fseek(file_, file_pos, SEEK_SET);
+    return;
+  }
+  mapped_pos_ = size_t(offset);
+}
+
+size_t PlyReadBuffer::mapped_size() const
+{
+  BLI_assert(mmap_file_ != nullptr);
+  return BLI_mmap_get_length(mmap_file_) - mapped_pos_;
+}
+
+bool PlyReadBuffer::read_mapped_bytes(size_t offset, MutableSpan<uint8_t> dst) const
+{
+  BLI_assert(mmap_file_ != nullptr);
+  return BLI_mmap_read(mmap_file_, dst.data(), mapped_pos_ + offset, dst.size());
+}
+
+void PlyReadBuffer::skip_mapped_bytes(size_t size)
+{
+  BLI_assert(mmap_file_ != nullptr);
+  BLI_assert(mapped_pos_ + size <= BLI_mmap_get_length(mmap_file_));
+  mapped_pos_ += size;
 }
 
 Span<char> PlyReadBuffer::read_line()
@@ -63,6 +107,13 @@ Span<char> PlyReadBuffer::read_line()
 
 bool PlyReadBuffer::read_bytes(void *dst, size_t size)
 {
+  if (mmap_file_ != nullptr) {
+    if (!BLI_mmap_read(mmap_file_, dst, mapped_pos_, size)) {
+      return false;
+    }
+    mapped_pos_ += size;
+    return true;
+  }
   while (size > 0) {
     if (pos_ + size > buf_used_) {
       if (!refill_buffer()) {
@@ -13,6 +13,8 @@
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+struct BLI_mmap_file;
+
 namespace blender::io::ply {
 
 /**
@@ -24,9 +26,36 @@ class PlyReadBuffer {
   PlyReadBuffer(const char *file_path, size_t read_buffer_size = 64 * 1024);
   ~PlyReadBuffer();
 
-  /** After header is parsed, indicate whether the rest of reading will be ascii or binary. */
+  /**
+   * After header is parsed, indicate whether the rest of reading will be ascii or binary.
+   * Binary files are memory mapped when possible.
+   */
   void after_header(bool is_binary);
 
+  /** Whether the rest of the binary data can be accessed with #read_mapped_bytes. */
+  bool is_mapped() const
+  {
+    return mmap_file_ != nullptr;
+  }
+
+  /**
+   * The number of bytes of binary data that were not read yet. Only valid when #is_mapped.
+   */
+  size_t mapped_size() const;
+
+  /**
+   * Copy binary data that was not read yet, starting at an offset from the current position,
+   * without marking it as read. Unlike accessing the mapped memory directly, this handles I/O
+   * errors and files that are truncated while being read. Can be called from multiple threads.
+   * Only valid when #is_mapped. Returns false if the data can not be read.
+   */
+  bool read_mapped_bytes(size_t offset, MutableSpan<uint8_t> dst) const;
+
+  /**
+   * Mark a number of bytes of #mapped_size as read.
+   */
+  void skip_mapped_bytes(size_t size);
+
   /**
    * Gets the next line from the file as a Span. The line does not include any newline characters.
    */
@@ -42,6 +71,9 @@ class PlyReadBuffer {
   bool refill_buffer();
 
   FILE *file_ = nullptr;
+  BLI_mmap_file *mmap_file_ = nullptr;
+  /** Offset in the memory mapped file of the data that was not read yet. */
+  size_t mapped_pos_ = 0;
   Array<char> buffer_;
   int pos_ = 0;
   int buf_used_ = 0;
@@ -10,11 +10,14 @@
 #include "ply_data.hh"
 #include "ply_import_buffer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_endian_switch.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "fast_float.h"
 
+#include <atomic>
 #include <charconv>
 
 #include "CLG_log.h"
@@ -193,6 +196,21 @@ template<typename T> static T get_binary_value(PlyDataTypes type, const uint8_t
   return val;
 }
 
+/**
+ * Read a binary value that may not be aligned, switching its endianness if needed.
+ */
+template<typename T>
+static T read_binary_value(PlyDataTypes type, const uint8_t *ptr, const bool big_endian)
+{
+  uint8_t value[8];
+  memcpy(value, ptr, data_type_size[type]);
+  if (big_endian) {
+    endian_switch(value, data_type_size[type]);
+  }
+  const uint8_t *value_ptr = value;
+  return get_binary_value<T>(type, value_ptr);
+}
+
 static const char *parse_row_binary(PlyReadBuffer &file,
                                     const PlyHeader &header,
                                     const PlyElement &element,
@@ -270,15 +288,15 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     data->vertex_custom_attr.append(attr);
   }
 
-  data->vertices.reserve(element.count);
+  data->vertices.resize(element.count);
   if (has_color) {
-    data->vertex_colors.reserve(element.count);
+    data->vertex_colors.resize(element.count);
   }
   if (has_normal) {
-    data->vertex_normals.reserve(element.count);
+    data->vertex_normals.resize(element.count);
   }
   if (has_uv) {
-    data->uv_coordinates.reserve(element.count);
+    data->uv_coordinates.resize(element.count);
   }
 
   float4 color_norm = {1, 1, 1, 1};
@@ -291,31 +309,13 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     color_norm.w = data_type_normalizer[element.properties[alpha_index].type];
   }
 
-  Vector<float> value_vec(element.properties.size());
-  Vector<uint8_t> scratch;
-  if (header.type != PlyFormatType::ASCII) {
-    scratch.resize(element.stride);
-  }
-
-  for (int i = 0; i < element.count; i++) {
-
-    const char *error = nullptr;
-    if (header.type == PlyFormatType::ASCII) {
-      error = parse_row_ascii(file, value_vec);
-    }
-    else {
-      error = parse_row_binary(file, header, element, scratch, value_vec);
-    }
-    if (error != nullptr) {
-      return error;
-    }
-
+  auto set_vertex = [&](const int i, const Span<float> value_vec) {
     /* Vertex coord */
     float3 vertex3;
     vertex3.x = value_vec[vertex_index.x];
     vertex3.y = value_vec[vertex_index.y];
     vertex3.z = value_vec[vertex_index.z];
-    data->vertices.append(vertex3);
+    data->vertices[i] = vertex3;
 
     /* Vertex color */
     if (has_color) {
@@ -329,7 +329,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       else {
         colors4.w = 1.0f;
       }
-      data->vertex_colors.append(colors4);
+      data->vertex_colors[i] = colors4;
     }
 
     /* If normals */
@@ -338,7 +338,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       normals3.x = value_vec[normal_index.x];
       normals3.y = value_vec[normal_index.y];
       normals3.z = value_vec[normal_index.z];
-      data->vertex_normals.append(normals3);
+      data->vertex_normals[i] = normals3;
     }
 
     /* If uv */
@@ -346,7 +346,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float2 uvmap;
       uvmap.x = value_vec[uv_index.x];
       uvmap.y = value_vec[uv_index.y];
-      data->uv_coordinates.append(uvmap);
+      data->uv_coordinates[i] = uvmap;
     }
 
     /* Custom attributes */
@@ -354,6 +354,91 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float value = value_vec[custom_attr_indices[ci]];
       data->vertex_custom_attr[ci].data[i] = value;
     }
+  };
+
+  if (header.type != PlyFormatType::ASCII && element.stride != 0 && file.is_mapped()) {
+    /* Decode rows in parallel, each task copying its rows from the memory mapped file. */
+    const int64_t element_size = int64_t(element.count) * element.stride;
+    if (file.mapped_size() < element_size) {
+      return "Could not read row of binary property";
+    }
+    Array<int> prop_offsets(element.properties.size());
+    int offset = 0;
+    for (const int64_t prop_idx : element.properties.index_range()) {
+      prop_offsets[prop_idx] = offset;
+      offset += data_type_size[element.properties[prop_idx].type];
+    }
+    const bool big_endian = header.type == PlyFormatType::BINARY_BE;
+    /* When all properties have the same size, which is the common case of only float or only
+     * double properties, the endianness of whole batches of rows is switched at once in a loop
+     * that compilers vectorize, rather than one value at a time. */
+    int uniform_type_size = data_type_size[element.properties.first().type];
+    for (const PlyProperty &prop : element.properties) {
+      if (data_type_size[prop.type] != uniform_type_size) {
+        uniform_type_size = 0;
+        break;
+      }
+    }
+    const bool switch_rows = big_endian && uniform_type_size > 1;
+
+    std::atomic<bool> read_error = false;
+    threading::parallel_for(IndexRange(element.count), 8192, [&](const IndexRange range) {
+      /* Copy the rows in batches to bound the memory used by each task. */
+      const int64_t batch_size = 8192;
+      Array<uint8_t> rows(std::min(range.size(), batch_size) * element.stride, NoInitialization());
+      Vector<float> value_vec(element.properties.size());
+      for (int64_t batch_start = range.start(); batch_start < range.one_after_last();
+           batch_start += batch_size)
+      {
+        const IndexRange batch(batch_start,
+                               std::min(batch_size, range.one_after_last() - batch_start));
+        const MutableSpan<uint8_t> batch_rows = rows.as_mutable_span().take_front(
+            batch.size() * element.stride);
+        if (!file.read_mapped_bytes(batch.start() * element.stride, batch_rows)) {
+          read_error = true;
+          return;
+        }
+        if (switch_rows) {
+          endian_switch_array(
+              batch_rows.data(), uniform_type_size, int(batch_rows.size() / uniform_type_size));
+        }
+        for (const int64_t i : batch) {
+          const uint8_t *row = batch_rows.data() + (i - batch.start()) * element.stride;
+          for (const int64_t prop_idx : element.properties.index_range()) {
+            value_vec[prop_idx] = read_binary_value<float>(element.properties[prop_idx].type,
+                                                           row + prop_offsets[prop_idx],
+                                                           big_endian && !switch_rows);
+          }
+          set_vertex(int(i), value_vec);
+        }
+      }
+    });
+    if (read_error) {
+      return "Could not read row of binary property";
+    }
+    file.skip_mapped_bytes(element_size);
+    return nullptr;
+  }
+
+  Vector<float> value_vec(element.properties.size());
+  Vector<uint8_t> scratch;
+  if (header.type != PlyFormatType::ASCII) {
+    scratch.resize(element.stride);
+  }
+
+  for (int i = 0; i < element.count; i++) {
+
+    const char *error = nullptr;
+    if (header.type == PlyFormatType::ASCII) {
+      error = parse_row_ascii(file, value_vec);
+    }
+    else {
+      error = parse_row_binary(file, header, element, scratch, value_vec);
+    }
+    if (error != nullptr) {
+      return error;
+    }
+    set_vertex(i, value_vec);
   }
   return nullptr;
 }
@@ -389,6 +474,157 @@ static void skip_property(PlyReadBuffer &file,
   }
 }
 
+/**
+ * Load the faces of a binary file from its memory mapped data. Finding where each face starts
+ * requires reading the sizes of all the lists in order, but the vertex indices which make up most
+ * of the data are then decoded in parallel. The data is copied from the mapping one window at a
+ * time, since the size of the face data is not known in advance, and the faces found in a window
+ * are decoded before moving to the next one.
+ */
+static const char *load_face_element_mapped(PlyReadBuffer &file,
+                                            const PlyHeader &header,
+                                            const PlyElement &element,
+                                            const int prop_index,
+                                            PlyData *data)
+{
+  const bool big_endian = header.type == PlyFormatType::BINARY_BE;
+  const PlyProperty &prop = element.properties[prop_index];
+  const int index_size = data_type_size[prop.type];
+
+  /* Large enough for the longest list of vertex indices (255 doubles) and small enough to keep
+   * the copied data in cache. */
+  const int64_t max_window_size = 4 * 1024 * 1024;
+  const int64_t data_size = int64_t(file.mapped_size());
+  Array<uint8_t> window(std::min(data_size, max_window_size), NoInitialization());
+  int64_t window_start = 0;
+  int64_t window_end = 0;
+
+  /* Offset in the window of the vertex indices of each face added since the last decoding. */
+  Vector<int64_t> face_data_offsets;
+
+  auto decode_faces = [&]() {
+    if (face_data_offsets.is_empty()) {
+      return;
+    }
+    /* Faces may already have been added by other elements. */
+    const Span<uint32_t> face_sizes = data->face_sizes.as_span().take_back(
+        face_data_offsets.size());
+    Array<int64_t> face_starts(face_data_offsets.size() + 1);
+    face_starts[0] = data->face_vertices.size();
+    for (const int64_t i : face_data_offsets.index_range()) {
+      face_starts[i + 1] = face_starts[i] + face_sizes[i];
+    }
+    data->face_vertices.resize(face_starts.last());
+
+    threading::parallel_for(face_data_offsets.index_range(), 8192, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        const uint8_t *ptr = window.data() + face_data_offsets[i];
+        uint32_t *dst = data->face_vertices.data() + face_starts[i];
+        const int count = int(face_sizes[i]);
+        if (ELEM(prop.type, PlyDataTypes::INT, PlyDataTypes::UINT)) {
+          /* Most common case, copy the whole list at once and switch its endianness in a loop
+           * that compilers vectorize. */
+          memcpy(dst, ptr, sizeof(uint32_t) * count);
+          if (big_endian) {
+            BLI_endian_switch_uint32_array(dst, count);
+          }
+        }
+        else {
+          for (int j = 0; j < count; j++) {
+            dst[j] = read_binary_value<uint32_t>(prop.type, ptr + j * index_size, big_endian);
+          }
+        }
+      }
+    });
+    face_data_offsets.clear();
+  };
+
+  /* Make sure the window contains a range of the face data, decoding the faces in the window
+   * before replacing it with the data starting at the range. */
+  auto load_window = [&](const int64_t start, const int64_t size) {
+    if (start >= window_start && start + size <= window_end) {
+      return true;
+    }
+    if (start + size > data_size) {
+      return false;
+    }
+    decode_faces();
+    window_start = start;
+    window_end = std::min(start + window.size(), data_size);
+    return file.read_mapped_bytes(
+        size_t(window_start), window.as_mutable_span().take_front(window_end - window_start));
+  };
+
+  int64_t pos = 0;
+  auto read_count = [&](const PlyProperty &list_prop, uint32_t &r_count) {
+    const int count_size = data_type_size[list_prop.count_type];
+    if (!load_window(pos, count_size)) {
+      return false;
+    }
+    r_count = read_binary_value<uint32_t>(
+        list_prop.count_type, window.data() + (pos - window_start), big_endian);
+    pos += count_size;
+    return true;
+  };
+  auto skip = [&](const PlyProperty &skip_prop) {
+    uint32_t count = 1;
+    if (skip_prop.count_type != PlyDataTypes::NONE && !read_count(skip_prop, count)) {
+      return false;
+    }
+    pos += int64_t(count) * data_type_size[skip_prop.type];
+    return pos <= data_size;
+  };
+
+  data->face_sizes.reserve(data->face_sizes.size() + element.count);
+  face_data_offsets.reserve(std::min<int64_t>(element.count, window.size() / 3));
+
+  for (int i = 0; i < element.count; i++) {
+    /* Skip any properties before vertex indices. */
+    for (int j = 0; j < prop_index; j++) {
+      if (!skip(element.properties[j])) {
+        return "Could not read row of binary property";
+      }
+    }
+
+    /* Read vertex indices list. */
+    uint32_t count;
+    if (!read_count(prop, count)) {
+      return "Could not read row of binary property";
+    }
+    if (count < 1 || count > 255) {
+      return "Invalid face size, must be between 1 and 255";
+    }
+    const int64_t list_size = int64_t(count) * index_size;
+    /* Previous python based importer was accepting faces with fewer
+     * than 3 vertices, and silently dropping them. */
+    if (count < 3) {
+      CLOG_WARN(&LOG, "PLY Importer: ignoring face %i (%u vertices)", i, count);
+    }
+    else {
+      if (!load_window(pos, list_size)) {
+        return "Could not read row of binary property";
+      }
+      face_data_offsets.append(pos - window_start);
+      data->face_sizes.append(count);
+    }
+    pos += list_size;
+    if (pos > data_size) {
+      return "Could not read row of binary property";
+    }
+
+    /* Skip any properties after vertex indices. */
+    for (int j = prop_index + 1; j < element.properties.size(); j++) {
+      if (!skip(element.properties[j])) {
+        return "Could not read row of binary property";
+      }
+    }
+  }
+  decode_faces();
+
+  file.skip_mapped_bytes(size_t(pos));
+  return nullptr;
+}
+
 static const char *load_face_element(PlyReadBuffer &file,
                                      const PlyHeader &header,
                                      const PlyElement &element,
@@ -409,6 +645,10 @@ static const char *load_face_element(PlyReadBuffer &file,
     return "Face element vertex indices property must be a list";
   }
 
+  if (header.type != PlyFormatType::ASCII && file.is_mapped()) {
+    return load_face_element_mapped(file, header, element, prop_index, data);
+  }
+
   data->face_vertices.reserve(element.count * 3);
   data->face_sizes.reserve(element.count);
 
@@ -60,6 +60,13 @@ TEST(ply_import, BufferRefillTest)
   EXPECT_EQ(12, data_b->edges.size());
   EXPECT_EQ_ARRAY(exp_edges, data_a->edges.data(), 12);
   EXPECT_EQ_ARRAY(exp_edges, data_b->edges.data(), 12);
+
+  /* Binary vertices are decoded from the memory mapped file, they should match the ascii ones. */
+  EXPECT_EQ(8, data_a->vertices.size());
+  EXPECT_EQ(8, data_b->vertices.size());
+  for (const int64_t i : data_a->vertices.index_range()) {
+    EXPECT_V3_NEAR(data_a->vertices[i], data_b->vertices[i], 1e-6f);
+  }
 }
 
 //@TODO: now we put vertex color attribute first, maybe put position first?
@@ -6,12 +6,14 @@
  * \ingroup stl
  */
 
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 
 #include "BKE_mesh.hh"
 
 #include "BLI_array.hh"
+#include "BLI_mmap.h"
 
 #include "DNA_mesh_types.h"
 
@@ -20,8 +22,44 @@
 #include "stl_import_binary_reader.hh"
 #include "stl_import_mesh.hh"
 
+#include "CLG_log.h"
+static CLG_LogRef LOG = {"io.stl"};
+
 namespace blender::io::stl {
 
+/** Below this, the overhead of the parallel import is larger than what it saves. */
+#define STL_PARALLEL_IMPORT_TRIS_MIN 65536
+
+/**
+ * Create the mesh from the memory mapped file, welding vertices on multiple threads.
+ * Returns null when the file can't be mapped or read.
+ */
+static Mesh *read_stl_binary_mapped(FILE *file,
+                                    const uint32_t num_tris,
+                                    const bool use_custom_normals)
+{
+  BLI_assert(num_tris <= INT_MAX / 3);
+  BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(file));
+  if (mmap_file == nullptr) {
+    return nullptr;
+  }
+  const size_t tris_offset = BINARY_HEADER_SIZE + sizeof(uint32_t);
+  if (BLI_mmap_get_length(mmap_file) < tris_offset + size_t(num_tris) * BINARY_STRIDE) {
+    BLI_mmap_free(mmap_file);
+    return nullptr;
+  }
+  /* Copy the triangles rather than using the mapped memory directly, which would not detect I/O
+   * errors or the file being truncated while it is read. */
+  Array<PackedTriangle> tris(num_tris, NoInitialization());
+  const bool read_ok = BLI_mmap_read(
+      mmap_file, tris.data(), tris_offset, size_t(num_tris) * BINARY_STRIDE);
+  BLI_mmap_free(mmap_file);
+  if (!read_ok) {
+    return nullptr;
+  }
+  return stl_mesh_from_triangles(tris, use_custom_normals);
+}
+
 Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
 {
   const int chunk_size = 1024;
@@ -36,6 +74,20 @@ Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
     return BKE_mesh_new_nomain(0, 0, 0, 0);
   }
 
+  /* The corners of the mesh are indexed with int, both when importing in parallel and not. */
+  if (num_tris > INT_MAX / 3) {
+    CLOG_ERROR(&LOG, "STL Importer: too many triangles (%u)", num_tris);
+    return nullptr;
+  }
+
+  if (num_tris >= STL_PARALLEL_IMPORT_TRIS_MIN) {
+    if (Mesh *mesh = read_stl_binary_mapped(file, num_tris, use_custom_normals)) {
+      return mesh;
+    }
+    /* Mapping the file moved the file descriptor to its end. */
+    fseek(file, BINARY_HEADER_SIZE + sizeof(uint32_t), SEEK_SET);
+  }
+
   Array<PackedTriangle> tris_buf(chunk_size);
   STLMeshHelper stl_mesh(num_tris, use_custom_normals);
   size_t num_read_tris;
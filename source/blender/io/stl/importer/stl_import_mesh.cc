@@ -8,8 +8,11 @@
 
 #include "BKE_mesh.hh"
 
+#include "BLI_array.hh"
 #include "BLI_array_utils.hh"
+#include "BLI_concurrent_map.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -54,28 +57,176 @@ bool STLMeshHelper::add_triangle(const PackedTriangle &data)
   return true;
 }
 
-Mesh *STLMeshHelper::to_mesh()
+static void report_removed_triangles(const int degenerate_tris_num, const int duplicate_tris_num)
 {
-  if (degenerate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num_);
+  if (degenerate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num);
+  }
+  if (duplicate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num);
   }
-  if (duplicate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num_);
+}
+
+static void mesh_finalize(Mesh &mesh,
+                          const bool use_custom_normals,
+                          MutableSpan<float3> loop_normals)
+{
+  bke::mesh_smooth_set(mesh, false);
+
+  /* NOTE: edges must be calculated first before setting custom normals. */
+  bke::mesh_calc_edges(mesh, false, false);
+
+  if (use_custom_normals && loop_normals.size() == mesh.corners_num) {
+    bke::mesh_set_custom_normals(mesh, loop_normals);
   }
+}
+
+Mesh *STLMeshHelper::to_mesh()
+{
+  report_removed_triangles(degenerate_tris_num_, duplicate_tris_num_);
 
   Mesh *mesh = BKE_mesh_new_nomain(verts_.size(), 0, tris_.size(), tris_.size() * 3);
   mesh->vert_positions_for_write().copy_from(verts_);
   offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
   array_utils::copy(tris_.as_span().cast<int>(), mesh->corner_verts_for_write());
 
-  bke::mesh_smooth_set(*mesh, false);
+  mesh_finalize(*mesh, use_custom_normals_, loop_normals_);
 
-  /* NOTE: edges must be calculated first before setting custom normals. */
-  bke::mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
 
-  if (use_custom_normals_ && loop_normals_.size() == mesh->corners_num) {
-    bke::mesh_set_custom_normals(*mesh, loop_normals_);
+Mesh *stl_mesh_from_triangles(const Span<PackedTriangle> tris, const bool use_custom_normals)
+{
+  const int corners_num = int(tris.size() * 3);
+  auto corner_position = [&](const int corner) -> float3 {
+    return tris[corner / 3].vertices[corner % 3];
+  };
+
+  /* Find the first corner with the same position as each corner. Using the first one rather than
+   * any of them makes the vertex order match the order in which #STLMeshHelper adds them. */
+  using FirstIndexMap = ConcurrentMap<float3, int>;
+  FirstIndexMap first_corner_by_position;
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      FirstIndexMap::MutableAccessor accessor;
+      if (first_corner_by_position.add(accessor, corner_position(corner))) {
+        accessor->second = corner;
+      }
+      else {
+        accessor->second = std::min(accessor->second, corner);
+      }
+    }
+  });
+  Array<int> first_corners(corners_num);
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      FirstIndexMap::ConstAccessor accessor;
+      /* Positions with NaN components are not equal to anything, not even to themselves. */
+      first_corners[corner] = first_corner_by_position.lookup(accessor, corner_position(corner)) ?
+                                  accessor->second :
+                                  corner;
+    }
+  });
+
+  Array<int> corner_verts(corners_num);
+  int verts_num = 0;
+  for (const int corner : IndexRange(corners_num)) {
+    if (first_corners[corner] == corner) {
+      corner_verts[corner] = verts_num++;
+    }
+  }
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      if (first_corners[corner] != corner) {
+        corner_verts[corner] = corner_verts[first_corners[corner]];
+      }
+    }
+  });
+
+  /* Find the first occurrence of each triangle in the same way, ignoring the vertex order. */
+  auto tri_verts = [&](const int tri) {
+    return int3(corner_verts[tri * 3 + 0], corner_verts[tri * 3 + 1], corner_verts[tri * 3 + 2]);
+  };
+  auto is_degenerate = [](const int3 &verts) {
+    return verts[0] == verts[1] || verts[0] == verts[2] || verts[1] == verts[2];
+  };
+  auto sorted = [](int3 verts) {
+    std::sort(&verts[0], &verts[0] + 3);
+    return verts;
+  };
+  using FirstTriMap = ConcurrentMap<int3, int>;
+  FirstTriMap first_tri_by_verts;
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri : range) {
+      const int3 verts = tri_verts(tri);
+      if (is_degenerate(verts)) {
+        continue;
+      }
+      FirstTriMap::MutableAccessor accessor;
+      if (first_tri_by_verts.add(accessor, sorted(verts))) {
+        accessor->second = tri;
+      }
+      else {
+        accessor->second = std::min(accessor->second, tri);
+      }
+    }
+  });
+  Array<bool> keep_tris(tris.size());
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri : range) {
+      const int3 verts = tri_verts(tri);
+      if (is_degenerate(verts)) {
+        keep_tris[tri] = false;
+        continue;
+      }
+      FirstTriMap::ConstAccessor accessor;
+      first_tri_by_verts.lookup(accessor, sorted(verts));
+      keep_tris[tri] = accessor->second == tri;
+    }
+  });
+
+  Array<int> dst_tris(tris.size());
+  int tris_num = 0;
+  int degenerate_tris_num = 0;
+  for (const int tri : tris.index_range()) {
+    dst_tris[tri] = tris_num;
+    if (keep_tris[tri]) {
+      tris_num++;
+    }
+    else if (is_degenerate(tri_verts(tri))) {
+      degenerate_tris_num++;
+    }
   }
+  report_removed_triangles(degenerate_tris_num,
+                           int(tris.size()) - tris_num - degenerate_tris_num);
+
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num, 0, tris_num, tris_num * 3);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      if (first_corners[corner] == corner) {
+        positions[corner_verts[corner]] = corner_position(corner);
+      }
+    }
+  });
+  offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
+
+  MutableSpan<int> mesh_corner_verts = mesh->corner_verts_for_write();
+  Array<float3> loop_normals(use_custom_normals ? tris_num * 3 : 0);
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri : range) {
+      if (!keep_tris[tri]) {
+        continue;
+      }
+      const int dst_tri = dst_tris[tri];
+      mesh_corner_verts.slice(dst_tri * 3, 3).copy_from(corner_verts.as_span().slice(tri * 3, 3));
+      if (use_custom_normals) {
+        loop_normals.as_mutable_span().slice(dst_tri * 3, 3).fill(tris[tri].normal);
+      }
+    }
+  });
+
+  mesh_finalize(*mesh, use_custom_normals, loop_normals);
 
   return mesh;
 }
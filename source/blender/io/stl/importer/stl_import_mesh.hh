@@ -11,6 +11,7 @@
 #include <cstdint>
 
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 #include "stl_data.hh"
@@ -67,4 +68,11 @@ class STLMeshHelper {
   Mesh *to_mesh();
 };
 
+/**
+ * Create a mesh from all the triangles at once, merging duplicate vertices and triangles like
+ * #STLMeshHelper, but on multiple threads. The result is the same as adding the triangles to a
+ * #STLMeshHelper in order.
+ */
+Mesh *stl_mesh_from_triangles(Span<PackedTriangle> tris, bool use_custom_normals);
+
 }  // namespace blender::io::stl
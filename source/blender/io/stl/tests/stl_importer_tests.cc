@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_vector.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_mesh_types.h"
+
+#include "stl_data.hh"
+#include "stl_import_binary_reader.hh"
+#include "stl_import_mesh.hh"
+
+namespace blender::io::stl {
+
+class STLImportTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    BKE_tempdir_init(nullptr);
+  }
+
+  void TearDown() override
+  {
+    BKE_tempdir_session_purge();
+  }
+};
+
+/**
+ * Triangles of a grid of quads sharing their vertices, with duplicate triangles in a different
+ * vertex order and degenerate triangles mixed in.
+ */
+static Vector<PackedTriangle> grid_triangles(const int size)
+{
+  auto position = [&](const int x, const int y) {
+    return float3(float(x) * 0.1f, float(y) * 0.1f, float((x * y) % 7));
+  };
+  Vector<PackedTriangle> tris;
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const float3 normal(float(x), float(y), 1.0f);
+      tris.append({normal, {position(x, y), position(x + 1, y), position(x + 1, y + 1)}, 0});
+      tris.append({normal, {position(x, y), position(x + 1, y + 1), position(x, y + 1)}, 0});
+      if ((x + y) % 97 == 0) {
+        tris.append({normal, {position(x + 1, y), position(x + 1, y + 1), position(x, y)}, 0});
+      }
+      if ((x + y) % 89 == 0) {
+        tris.append({normal, {position(x, y), position(x, y), position(x, y + 1)}, 0});
+      }
+    }
+  }
+  return tris;
+}
+
+static Mesh *import_binary_stl(const std::string &filepath,
+                               const Span<PackedTriangle> tris,
+                               const bool use_custom_normals)
+{
+  FILE *file = BLI_fopen(filepath.c_str(), "wb");
+  EXPECT_NE(file, nullptr);
+  const char header[BINARY_HEADER_SIZE] = {};
+  const uint32_t tris_num = uint32_t(tris.size());
+  fwrite(header, BINARY_HEADER_SIZE, 1, file);
+  fwrite(&tris_num, sizeof(uint32_t), 1, file);
+  fwrite(tris.data(), BINARY_STRIDE, tris.size(), file);
+  fclose(file);
+
+  file = BLI_fopen(filepath.c_str(), "rb");
+  Mesh *mesh = read_stl_binary(file, use_custom_normals);
+  fclose(file);
+  return mesh;
+}
+
+TEST_F(STLImportTest, BinaryParallelMatchesSequential)
+{
+  /* Enough triangles to be imported in parallel from the memory mapped file. */
+  const Vector<PackedTriangle> tris = grid_triangles(190);
+  ASSERT_GE(tris.size(), 65536);
+
+  for (const bool use_custom_normals : {false, true}) {
+    const std::string filepath = std::string(BKE_tempdir_session()) + SEP_STR "grid.stl";
+    Mesh *mesh = import_binary_stl(filepath, tris, use_custom_normals);
+    ASSERT_NE(mesh, nullptr);
+
+    STLMeshHelper helper(int(tris.size()), use_custom_normals);
+    for (const PackedTriangle &tri : tris) {
+      helper.add_triangle(tri);
+    }
+    Mesh *expected = helper.to_mesh();
+
+    ASSERT_EQ(mesh->verts_num, expected->verts_num);
+    ASSERT_EQ(mesh->faces_num, expected->faces_num);
+    ASSERT_EQ(mesh->edges_num, expected->edges_num);
+    /* The vertices are in the same order, and so are the faces and their corners. */
+    EXPECT_EQ_ARRAY(expected->vert_positions().data(),
+                    mesh->vert_positions().data(),
+                    size_t(mesh->verts_num));
+    EXPECT_EQ_ARRAY(expected->face_offsets().data(),
+                    mesh->face_offsets().data(),
+                    size_t(mesh->faces_num + 1));
+    EXPECT_EQ_ARRAY(expected->corner_verts().data(),
+                    mesh->corner_verts().data(),
+                    size_t(mesh->corners_num));
+    EXPECT_EQ_ARRAY(expected->edges().data(), mesh->edges().data(), size_t(mesh->edges_num));
+    EXPECT_EQ_ARRAY(expected->corner_edges().data(),
+                    mesh->corner_edges().data(),
+                    size_t(mesh->corners_num));
+
+    BKE_id_free(nullptr, mesh);
+    BKE_id_free(nullptr, expected);
+  }
+}
+
+}  // namespace blender::io::stl
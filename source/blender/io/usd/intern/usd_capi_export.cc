@@ -15,6 +15,10 @@
 #include <pxr/base/tf/token.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/usd/clipsAPI.h>
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usdGeom/metrics.h>
@@ -194,6 +198,120 @@ static void ensure_root_prim(pxr::UsdStageRefPtr stage, const USDExportParams &p
   }
 }
 
+/**
+ * Time samples of an animation that are moved out of the root layer while exporting, see
+ * #USDExportParams::animation_chunk_size. Every chunk is saved as a value clip next to the
+ * exported file, and the root prims get the clip metadata to pick them up again.
+ */
+struct AnimationClips {
+  /** Exported file path without extension, used as prefix for the clip files. */
+  std::string base_path;
+  pxr::SdfLayerRefPtr manifest;
+  pxr::VtArray<pxr::SdfAssetPath> asset_paths;
+  pxr::VtVec2dArray active;
+};
+
+static std::string relative_asset_path(const std::string &file_path)
+{
+  return std::string("./") + BLI_path_basename(file_path.c_str());
+}
+
+/**
+ * Move all time samples authored in the root layer so far into a new value clip layer that is
+ * active from the given time on. The clip layer is saved and released right away, so that memory
+ * usage only depends on the number of frames per chunk.
+ */
+static bool animation_clip_flush(const pxr::UsdStageRefPtr &stage,
+                                 AnimationClips &clips,
+                                 const double start_time)
+{
+  const pxr::SdfLayerHandle root_layer = stage->GetRootLayer();
+  std::vector<pxr::SdfPath> sampled_paths;
+  root_layer->Traverse(pxr::SdfPath::AbsoluteRootPath(), [&](const pxr::SdfPath &path) {
+    if (path.IsPrimPropertyPath() && root_layer->GetNumTimeSamplesForPath(path) > 0) {
+      sampled_paths.push_back(path);
+    }
+  });
+  if (sampled_paths.empty()) {
+    return true;
+  }
+
+  if (!clips.manifest) {
+    clips.manifest = pxr::SdfLayer::CreateNew(clips.base_path + "_manifest.usda");
+    if (!clips.manifest) {
+      return false;
+    }
+  }
+  const std::string clip_path = fmt::format(
+      "{}_clip_{:04}.usdc", clips.base_path, clips.asset_paths.size() + 1);
+  pxr::SdfLayerRefPtr clip_layer = pxr::SdfLayer::CreateNew(clip_path);
+  if (!clip_layer) {
+    return false;
+  }
+
+  {
+    pxr::SdfChangeBlock change_block;
+    for (const pxr::SdfPath &path : sampled_paths) {
+      const pxr::SdfAttributeSpecHandle spec = root_layer->GetAttributeAtPath(path);
+      if (!spec) {
+        continue;
+      }
+      for (const pxr::SdfLayerHandle &layer : {pxr::SdfLayerHandle(clip_layer),
+                                               pxr::SdfLayerHandle(clips.manifest)})
+      {
+        pxr::SdfJustCreatePrimAttributeInLayer(
+            layer, path, spec->GetTypeName(), spec->GetVariability(), spec->IsCustom());
+      }
+      for (const double time : root_layer->ListTimeSamplesForPath(path)) {
+        pxr::VtValue value;
+        if (root_layer->QueryTimeSample(path, time, &value)) {
+          clip_layer->SetTimeSample(path, time, value);
+        }
+      }
+      root_layer->EraseField(path, pxr::SdfFieldKeys->TimeSamples);
+    }
+  }
+
+  if (!clip_layer->Save()) {
+    return false;
+  }
+  clips.asset_paths.push_back(pxr::SdfAssetPath(relative_asset_path(clip_path)));
+  clips.active.push_back(pxr::GfVec2d(start_time, double(clips.active.size())));
+  return true;
+}
+
+/** Author the value clip metadata on the root prims, to which all exported prims belong. */
+static void animation_clips_finish(const pxr::UsdStageRefPtr &stage,
+                                   const USDExportParams &params,
+                                   AnimationClips &clips)
+{
+  if (clips.asset_paths.empty()) {
+    return;
+  }
+  clips.manifest->Save();
+
+  std::vector<pxr::UsdPrim> root_prims;
+  if (params.root_prim_path[0] != '\0') {
+    root_prims.push_back(stage->GetPrimAtPath(pxr::SdfPath(params.root_prim_path)));
+  }
+  else {
+    for (const pxr::UsdPrim &prim : stage->GetPseudoRoot().GetAllChildren()) {
+      root_prims.push_back(prim);
+    }
+  }
+
+  const pxr::SdfAssetPath manifest_path(relative_asset_path(clips.manifest->GetRealPath()));
+  for (const pxr::UsdPrim &prim : root_prims) {
+    pxr::UsdClipsAPI clips_api(prim);
+    clips_api.SetClipAssetPaths(clips.asset_paths);
+    clips_api.SetClipPrimPath(prim.GetPath().GetString());
+    clips_api.SetClipActive(clips.active);
+    clips_api.SetClipManifestAssetPath(manifest_path);
+    /* With sparse value writing not every clip has samples for every attribute. */
+    clips_api.SetInterpolateMissingClipValues(true);
+  }
+}
+
 static void report_job_duration(const ExportJobData *data)
 {
   timeit::Nanoseconds duration = timeit::Clock::now() - data->start_time;
@@ -452,6 +570,16 @@ pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
   worker_status->progress = 0.11f;
   worker_status->do_update = true;
 
+  AnimationClips clips;
+  float chunk_start_frame = scene->r.sfra;
+  const bool use_clips = params.export_animation && params.animation_chunk_size > 0;
+  if (use_clips) {
+    char base_path[FILE_MAX];
+    STRNCPY(base_path, filepath);
+    BLI_path_extension_strip(base_path);
+    clips.base_path = base_path;
+  }
+
   if (params.export_animation) {
     /* Writing the animated frames is not 100% of the work, here it's assumed to be 75% of it. */
     float progress_per_frame = 0.75f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
@@ -461,6 +589,19 @@ pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
         break;
       }
 
+      if (use_clips && frame - chunk_start_frame >= params.animation_chunk_size) {
+        if (!animation_clip_flush(usd_stage, clips, chunk_start_frame)) {
+          BKE_reportf(worker_status->reports,
+                      RPT_ERROR,
+                      "USD Export: unable to write animation clip for %s",
+                      filepath);
+          break;
+        }
+        chunk_start_frame = frame;
+        /* Every clip has to contain the values at its start, not only the changed ones. */
+        iter.reset_sparse_value_writers();
+      }
+
       /* Update the scene for the next frame to render. */
       scene->r.cfra = int(frame);
       scene->r.subframe = frame - scene->r.cfra;
@@ -478,6 +619,16 @@ pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
     iter.iterate_and_write();
   }
 
+  if (use_clips) {
+    if (!clips.asset_paths.empty() && !animation_clip_flush(usd_stage, clips, chunk_start_frame)) {
+      BKE_reportf(worker_status->reports,
+                  RPT_ERROR,
+                  "USD Export: unable to write animation clip for %s",
+                  filepath);
+    }
+    animation_clips_finish(usd_stage, params, clips);
+  }
+
   worker_status->progress = 0.86f;
   worker_status->do_update = true;
 
@@ -24,6 +24,7 @@
 #include "BLI_math_matrix.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_timeit.hh"
 
 #include "BLT_translation.hh"
@@ -259,6 +260,24 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
   *data->do_update = true;
   *data->progress = 0.25f;
 
+  /* Convert the prim data in parallel first, adding it to #Main below has to happen serially. */
+  const Span<USDPrimReader *> readers = archive->readers();
+  threading::parallel_for(readers.index_range(), 1, [&](const IndexRange range) {
+    for (USDPrimReader *reader : readers.slice(range)) {
+      if (G.is_break) {
+        return;
+      }
+      if (reader) {
+        reader->prepare_object_data(0.0);
+      }
+    }
+  });
+
+  if (G.is_break) {
+    data->was_canceled = true;
+    return;
+  }
+
   /* Create blender objects. */
   for (USDPrimReader *reader : archive->readers()) {
     if (!reader) {
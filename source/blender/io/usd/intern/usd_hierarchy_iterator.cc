@@ -100,6 +100,13 @@ void USDHierarchyIterator::set_export_frame(float frame_nr)
   export_time_ = pxr::UsdTimeCode(frame_nr);
 }
 
+void USDHierarchyIterator::reset_sparse_value_writers()
+{
+  for (AbstractHierarchyWriter *writer : writers_.values()) {
+    static_cast<USDAbstractWriter *>(writer)->reset_sparse_value_writer();
+  }
+}
+
 USDExporterContext USDHierarchyIterator::create_usd_export_context(const HierarchyContext *context)
 {
   pxr::SdfPath path;
@@ -41,6 +41,9 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
 
   void set_export_frame(float frame_nr);
 
+  /** Make all writers write their full data on the next frame, see #USDExportParams. */
+  void reset_sparse_value_writers();
+
   std::string make_valid_name(const std::string &name) const override;
 
   void process_usd_skel() const;
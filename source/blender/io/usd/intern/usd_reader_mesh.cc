@@ -17,6 +17,7 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_material.hh"
 #include "BKE_mesh.hh"
@@ -167,6 +168,13 @@ static void assign_materials(Main *bmain,
 
 }  // namespace utils
 
+USDMeshReader::~USDMeshReader()
+{
+  if (prepared_mesh_) {
+    BKE_id_free(nullptr, prepared_mesh_);
+  }
+}
+
 void USDMeshReader::create_object(Main *bmain, const double /*motionSampleTime*/)
 {
   Mesh *mesh = BKE_mesh_add(bmain, name_.c_str());
@@ -179,13 +187,17 @@ void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
 {
   Mesh *mesh = (Mesh *)object_->data;
 
-  is_initial_load_ = true;
-  const USDMeshReadParams params = create_mesh_read_params(motionSampleTime,
-                                                           import_params_.mesh_read_flag);
+  Mesh *read_mesh = prepared_mesh_;
+  prepared_mesh_ = nullptr;
+  if (read_mesh == nullptr) {
+    is_initial_load_ = true;
+    const USDMeshReadParams params = create_mesh_read_params(motionSampleTime,
+                                                             import_params_.mesh_read_flag);
 
-  Mesh *read_mesh = this->read_mesh(mesh, params, nullptr);
+    read_mesh = this->read_mesh(mesh, params, nullptr);
 
-  is_initial_load_ = false;
+    is_initial_load_ = false;
+  }
   if (read_mesh != mesh) {
     BKE_mesh_nomain_to_mesh(read_mesh, mesh, object_);
   }
@@ -223,6 +235,24 @@ void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
   USDXformReader::read_object_data(bmain, motionSampleTime);
 }
 
+void USDMeshReader::prepare_object_data(const double motionSampleTime)
+{
+  /* The mesh in #Main doesn't exist yet, read into a new empty mesh instead. It only serves as
+   * template, which is equivalent since the mesh created by #create_object is empty too. */
+  Mesh *template_mesh = BKE_mesh_new_nomain(0, 0, 0, 0);
+
+  is_initial_load_ = true;
+  const USDMeshReadParams params = create_mesh_read_params(motionSampleTime,
+                                                           import_params_.mesh_read_flag);
+
+  prepared_mesh_ = this->read_mesh(template_mesh, params, nullptr);
+
+  is_initial_load_ = false;
+  if (prepared_mesh_ != template_mesh) {
+    BKE_id_free(nullptr, template_mesh);
+  }
+}
+
 bool USDMeshReader::topology_changed(const Mesh *existing_mesh, const double motionSampleTime)
 {
   /* TODO(makowalski): Is it the best strategy to cache the mesh
@@ -39,6 +39,9 @@ class USDMeshReader : public USDGeomReader {
    * implemented.  Note this will break if faces or positions vary. */
   bool is_initial_load_ = false;
 
+  /** Mesh read by #prepare_object_data, consumed by #read_object_data. */
+  Mesh *prepared_mesh_ = nullptr;
+
  public:
   USDMeshReader(const pxr::UsdPrim &prim,
                 const USDImportParams &import_params,
@@ -47,6 +50,8 @@ class USDMeshReader : public USDGeomReader {
   {
   }
 
+  ~USDMeshReader() override;
+
   bool valid() const override
   {
     return bool(mesh_prim_);
@@ -54,6 +59,7 @@ class USDMeshReader : public USDGeomReader {
 
   void create_object(Main *bmain, double motionSampleTime) override;
   void read_object_data(Main *bmain, double motionSampleTime) override;
+  void prepare_object_data(double motionSampleTime) override;
 
   void read_geometry(bke::GeometrySet &geometry_set,
                      USDMeshReadParams params,
@@ -97,6 +97,13 @@ class USDPrimReader {
   virtual void create_object(Main *bmain, double motionSampleTime) = 0;
   virtual void read_object_data(Main * /*bmain*/, double /*motionSampleTime*/){};
 
+  /**
+   * Convert prim data that doesn't depend on other Blender data ahead of #create_object, so that
+   * #read_object_data only has to add it to #Main. This is called for many readers in parallel,
+   * so implementations must not access #Main or other shared Blender data.
+   */
+  virtual void prepare_object_data(double /*motionSampleTime*/) {}
+
   Object *object() const;
   void object(Object *ob);
 
@@ -156,6 +156,11 @@ std::string USDAbstractWriter::get_export_file_path() const
   return usd_export_context_.export_file_path;
 }
 
+void USDAbstractWriter::reset_sparse_value_writer()
+{
+  usd_value_writer_ = pxr::UsdUtilsSparseValueWriter();
+}
+
 pxr::UsdTimeCode USDAbstractWriter::get_export_time_code() const
 {
   if (is_animated_) {
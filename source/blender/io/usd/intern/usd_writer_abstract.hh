@@ -56,6 +56,12 @@ class USDAbstractWriter : public AbstractHierarchyWriter {
 
   const pxr::SdfPath &usd_path() const;
 
+  /**
+   * Forget the values written so far, so that the next frame writes all values again instead of
+   * only the ones that changed. Used when the following time samples go into a new layer.
+   */
+  void reset_sparse_value_writer();
+
   /** Get the wmJobWorkerStatus-provided `reports` list pointer, to use with the BKE_report API. */
   ReportList *reports() const
   {
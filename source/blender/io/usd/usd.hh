@@ -126,6 +126,11 @@ enum eUSDSceneUnits {
 
 struct USDExportParams {
   bool export_animation = false;
+  /**
+   * When non-zero, the time samples of an animation are moved to a separate value clip layer
+   * every this many frames, so that memory usage doesn't grow with the length of the animation.
+   */
+  int animation_chunk_size = 0;
   bool selected_objects_only = false;
   bool visible_objects_only = true;
 
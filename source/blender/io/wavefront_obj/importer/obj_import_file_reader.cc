@@ -14,6 +14,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "IO_string_utils.hh"
@@ -31,6 +32,11 @@ namespace blender::io::obj {
 
 using std::string;
 
+/**
+ * Number of chunks each read buffer is split into, to parse them on multiple threads.
+ */
+#define OBJ_PARSE_CHUNKS_PER_BUFFER 256
+
 /**
  * Based on the properties of the given Geometry instance, create a new Geometry instance
  * or return the previous one.
@@ -74,12 +80,62 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+/**
+ * A face corner as written in the file, before its indices are resolved
+ * (see #geom_add_polygon).
+ */
+struct ChunkFaceCorner {
+  FaceCorner corner;
+  bool got_uv = false;
+  bool got_normal = false;
+};
+
+/**
+ * An element of a chunk that has to be handled in order when merging chunks.
+ */
+struct ChunkElement {
+  /** Line to parse when merging, empty for faces. */
+  StringRef line;
+  /** Range of the face corners of a face in #ObjChunk::face_corners. */
+  int corner_start = 0;
+  int corner_count = 0;
+  /** Number of vertices, UVs and normals of the chunk before this element. */
+  int vertices_num = 0;
+  int uv_vertices_num = 0;
+  int vert_normals_num = 0;
+};
+
+/**
+ * Data parsed from a range of lines of the OBJ file. Vertex data and faces, which make up
+ * nearly all of large files, don't depend on any parsing state and are parsed in parallel.
+ * Everything else is parsed when merging the chunks in order (see #OBJParser::parse).
+ */
+struct ObjChunk {
+  StringRef text;
+  Vector<float3> vertices;
+  /** Colors and weights by index in #vertices. */
+  Vector<std::pair<int, float3>> vertex_colors;
+  Vector<std::pair<int, float>> vertex_weights;
+  Vector<float2> uv_vertices;
+  Vector<float3> vert_normals;
+  Vector<ChunkFaceCorner> face_corners;
+  Vector<ChunkElement> elements;
+  size_t lines_num = 0;
+
+  void add_element(ChunkElement element)
+  {
+    element.vertices_num = int(vertices.size());
+    element.uv_vertices_num = int(uv_vertices.size());
+    element.vert_normals_num = int(vert_normals.size());
+    elements.append(element);
+  }
+};
+
+static void geom_add_vertex(const char *p, const char *end, ObjChunk &r_chunk)
 {
-  r_global_vertices.flush_mrgb_block();
   float3 vert;
   p = parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
+  r_chunk.vertices.append(vert);
   /* OBJ extension: `xyzrgb` vertex colors, when the vertex position
    * is followed by 3 more RGB color components. See
    * http://paulbourke.net/dataformats/obj/colour.html */
@@ -89,11 +145,11 @@ static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_gl
     if (srgb.x >= 0 && srgb.y >= 0 && srgb.z >= 0) {
       float3 linear;
       srgb_to_linearrgb_v3_v3(linear, srgb);
-      r_global_vertices.set_vertex_color(r_global_vertices.vertices.size() - 1, linear);
+      r_chunk.vertex_colors.append({int(r_chunk.vertices.size() - 1), linear});
     }
     else if (srgb.x > 0) {
       /* Treats value in srgb.x as weight. */
-      r_global_vertices.set_vertex_weight(r_global_vertices.vertices.size() - 1, srgb.x);
+      r_chunk.vertex_weights.append({int(r_chunk.vertices.size() - 1), srgb.x});
     }
   }
   UNUSED_VARS(p);
@@ -126,9 +182,7 @@ static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices
   }
 }
 
-static void geom_add_vertex_normal(const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
+static void geom_add_vertex_normal(const char *p, const char *end, ObjChunk &r_chunk)
 {
   float3 normal;
   parse_floats(p, end, 0.0f, normal, 3);
@@ -136,14 +190,14 @@ static void geom_add_vertex_normal(const char *p,
    * making them ever-so-slightly non unit length. Make sure they are
    * normalized. */
   normalize_v3(normal);
-  r_global_vertices.vert_normals.append(normal);
+  r_chunk.vert_normals.append(normal);
 }
 
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void geom_add_uv_vertex(const char *p, const char *end, ObjChunk &r_chunk)
 {
   float2 uv;
   parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
+  r_chunk.uv_vertices.append(uv);
 }
 
 /**
@@ -209,30 +263,18 @@ static void geom_add_polyline(Geometry *geom,
   }
 }
 
-static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
-                             const GlobalVertices &global_vertices,
-                             const int material_index,
-                             const int group_index,
-                             const bool shaded_smooth)
+/**
+ * Parse the corners of a face, keeping the indices as they are written in the file.
+ */
+static void chunk_add_polygon(const char *p, const char *end, ObjChunk &r_chunk)
 {
-  FaceElem curr_face;
-  curr_face.shaded_smooth = shaded_smooth;
-  curr_face.material_index = material_index;
-  if (group_index >= 0) {
-    curr_face.vertex_group_index = group_index;
-    geom->has_vertex_groups_ = true;
-  }
+  ChunkElement face;
+  face.corner_start = int(r_chunk.face_corners.size());
 
-  const int orig_corners_size = geom->face_corners_.size();
-  curr_face.start_index_ = orig_corners_size;
-
-  bool face_valid = true;
   p = drop_whitespace(p, end);
-  while (p < end && face_valid) {
-    FaceCorner corner;
-    bool got_uv = false, got_normal = false;
+  while (p < end) {
+    ChunkFaceCorner chunk_corner;
+    FaceCorner &corner = chunk_corner.corner;
     /* Parse vertex index. */
     p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
 
@@ -241,21 +283,63 @@ static void geom_add_polygon(Geometry *geom,
       break;
     }
 
-    face_valid &= corner.vert_index != INT32_MAX;
     if (p < end && *p == '/') {
       /* Parse UV index. */
       ++p;
       if (p < end && *p != '/') {
         p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
-        got_uv = corner.uv_vert_index != INT32_MAX;
+        chunk_corner.got_uv = corner.uv_vert_index != INT32_MAX;
       }
       /* Parse normal index. */
       if (p < end && *p == '/') {
         ++p;
         p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
-        got_normal = corner.vertex_normal_index != INT32_MAX;
+        chunk_corner.got_normal = corner.vertex_normal_index != INT32_MAX;
       }
     }
+    r_chunk.face_corners.append(chunk_corner);
+    face.corner_count++;
+
+    if (corner.vert_index == INT32_MAX) {
+      /* The face is invalid, no need to parse further. */
+      break;
+    }
+
+    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
+    p = drop_non_whitespace(p, end);
+    /* Skip whitespace to get to the next face corner. */
+    p = drop_whitespace(p, end);
+  }
+
+  r_chunk.add_element(face);
+}
+
+/**
+ * Add a face parsed by #chunk_add_polygon, \a global_vertices containing all the vertex data that
+ * came before it in the file.
+ */
+static void geom_add_polygon(Geometry *geom,
+                             const Span<ChunkFaceCorner> chunk_corners,
+                             const GlobalVertices &global_vertices,
+                             const int material_index,
+                             const int group_index,
+                             const bool shaded_smooth)
+{
+  FaceElem curr_face;
+  curr_face.shaded_smooth = shaded_smooth;
+  curr_face.material_index = material_index;
+  if (group_index >= 0) {
+    curr_face.vertex_group_index = group_index;
+    geom->has_vertex_groups_ = true;
+  }
+
+  const int orig_corners_size = geom->face_corners_.size();
+  curr_face.start_index_ = orig_corners_size;
+
+  bool face_valid = true;
+  for (const ChunkFaceCorner &chunk_corner : chunk_corners) {
+    FaceCorner corner = chunk_corner.corner;
+    face_valid &= corner.vert_index != INT32_MAX;
     /* Always keep stored indices non-negative and zero-based. */
     corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
     if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
@@ -269,7 +353,7 @@ static void geom_add_polygon(Geometry *geom,
       geom->track_vertex_index(corner.vert_index);
     }
     /* Ignore UV index, if the geometry does not have any UVs (#103212). */
-    if (got_uv && !global_vertices.uv_vertices.is_empty()) {
+    if (chunk_corner.got_uv && !global_vertices.uv_vertices.is_empty()) {
       corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
       if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
         CLOG_WARN(&LOG,
@@ -282,7 +366,7 @@ static void geom_add_polygon(Geometry *geom,
     /* Ignore corner normal index, if the geometry does not have any normals.
      * Some obj files out there do have face definitions that refer to normal indices,
      * without any normals being present (#98782). */
-    if (got_normal && !global_vertices.vert_normals.is_empty()) {
+    if (chunk_corner.got_normal && !global_vertices.vert_normals.is_empty()) {
       corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
                                         global_vertices.vert_normals.size() :
                                         -1;
@@ -299,10 +383,9 @@ static void geom_add_polygon(Geometry *geom,
     geom->face_corners_.append(corner);
     curr_face.corner_count_++;
 
-    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
-    p = drop_non_whitespace(p, end);
-    /* Skip whitespace to get to the next face corner. */
-    p = drop_whitespace(p, end);
+    if (!face_valid) {
+      break;
+    }
   }
 
   if (face_valid) {
@@ -484,6 +567,122 @@ static void use_all_vertices_if_no_faces(Geometry *geom,
   }
 }
 
+/**
+ * Parse the vertex data and faces of a chunk, and gather the other lines to parse them in order
+ * when merging.
+ */
+static void parse_chunk(ObjChunk &r_chunk)
+{
+  StringRef buffer_str = r_chunk.text;
+  while (!buffer_str.is_empty()) {
+    StringRef line = read_next_line(buffer_str);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    ++r_chunk.lines_num;
+    if (p == end) {
+      continue;
+    }
+    /* Most common things that start with 'v': vertices, normals, UVs. */
+    if (*p == 'v') {
+      if (parse_keyword(p, end, "v")) {
+        geom_add_vertex(p, end, r_chunk);
+      }
+      else if (parse_keyword(p, end, "vn")) {
+        geom_add_vertex_normal(p, end, r_chunk);
+      }
+      else if (parse_keyword(p, end, "vt")) {
+        geom_add_uv_vertex(p, end, r_chunk);
+      }
+    }
+    /* Faces. */
+    else if (parse_keyword(p, end, "f")) {
+      chunk_add_polygon(p, end, r_chunk);
+    }
+    /* Comments, except for extensions. */
+    else if (*p == '#' && !StringRef(p, end).startswith("#MRGB")) {
+      /* Nothing to do. */
+    }
+    else {
+      ChunkElement element;
+      element.line = StringRef(p, end);
+      r_chunk.add_element(element);
+    }
+  }
+}
+
+/**
+ * Split the text into chunks of roughly equal size, at line boundaries.
+ */
+static Vector<ObjChunk> split_chunks(const StringRef text, const int64_t chunks_num)
+{
+  Vector<ObjChunk> chunks;
+  const int64_t chunk_size = std::max<int64_t>(text.size() / chunks_num, 1);
+  int64_t start = 0;
+  while (start < text.size()) {
+    int64_t end = text.find('\n', std::min(start + chunk_size, text.size()) - 1);
+    end = (end == StringRef::not_found) ? text.size() : end + 1;
+    chunks.append_as();
+    chunks.last().text = text.substr(start, end - start);
+    start = end;
+  }
+  return chunks;
+}
+
+/**
+ * Amount of vertex data of a chunk that was already appended to the global vertices.
+ */
+struct ChunkMergeState {
+  int vertices_num = 0;
+  int uv_vertices_num = 0;
+  int vert_normals_num = 0;
+  int vertex_colors_num = 0;
+  int vertex_weights_num = 0;
+};
+
+/**
+ * Append the vertex data of the chunk to the global vertices, up to the given counts.
+ */
+static void merge_chunk_vertices(const ObjChunk &chunk,
+                                 const int vertices_num,
+                                 const int uv_vertices_num,
+                                 const int vert_normals_num,
+                                 ChunkMergeState &r_merged,
+                                 GlobalVertices &r_global_vertices)
+{
+  if (r_merged.vertices_num < vertices_num) {
+    r_global_vertices.flush_mrgb_block();
+    const int64_t offset = r_global_vertices.vertices.size() - r_merged.vertices_num;
+    r_global_vertices.vertices.extend(chunk.vertices.as_span().slice(
+        r_merged.vertices_num, vertices_num - r_merged.vertices_num));
+
+    int &colors_num = r_merged.vertex_colors_num;
+    while (colors_num < chunk.vertex_colors.size() &&
+           chunk.vertex_colors[colors_num].first < vertices_num)
+    {
+      const std::pair<int, float3> &color = chunk.vertex_colors[colors_num++];
+      r_global_vertices.set_vertex_color(offset + color.first, color.second);
+    }
+    int &weights_num = r_merged.vertex_weights_num;
+    while (weights_num < chunk.vertex_weights.size() &&
+           chunk.vertex_weights[weights_num].first < vertices_num)
+    {
+      const std::pair<int, float> &weight = chunk.vertex_weights[weights_num++];
+      r_global_vertices.set_vertex_weight(offset + weight.first, weight.second);
+    }
+    r_merged.vertices_num = vertices_num;
+  }
+  if (r_merged.uv_vertices_num < uv_vertices_num) {
+    r_global_vertices.uv_vertices.extend(chunk.uv_vertices.as_span().slice(
+        r_merged.uv_vertices_num, uv_vertices_num - r_merged.uv_vertices_num));
+    r_merged.uv_vertices_num = uv_vertices_num;
+  }
+  if (r_merged.vert_normals_num < vert_normals_num) {
+    r_global_vertices.vert_normals.extend(chunk.vert_normals.as_span().slice(
+        r_merged.vert_normals_num, vert_normals_num - r_merged.vert_normals_num));
+    r_merged.vert_normals_num = vert_normals_num;
+  }
+}
+
 void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                       GlobalVertices &r_global_vertices)
 {
@@ -506,6 +705,108 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   string state_material_name;
   int state_material_index = -1;
 
+  /* Parse the lines that depend on the state, in the order of the file. */
+  auto parse_line = [&](const char *p, const char *end) {
+    /* Faces. */
+    if (parse_keyword(p, end, "l")) {
+      geom_add_polyline(curr_geom, p, end, r_global_vertices);
+    }
+    /* Objects. */
+    else if (parse_keyword(p, end, "o")) {
+      if (import_params_.use_split_objects) {
+        geom_new_object(p,
+                        end,
+                        state_shaded_smooth,
+                        state_group_name,
+                        state_material_index,
+                        curr_geom,
+                        r_all_geometries);
+      }
+    }
+    /* Groups. */
+    else if (parse_keyword(p, end, "g")) {
+      if (import_params_.use_split_groups) {
+        geom_new_object(p,
+                        end,
+                        state_shaded_smooth,
+                        state_group_name,
+                        state_material_index,
+                        curr_geom,
+                        r_all_geometries);
+      }
+      else {
+        geom_update_group(StringRef(p, end).trim(), state_group_name);
+        int new_index = curr_geom->group_indices_.size();
+        state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
+        if (new_index == state_group_index) {
+          curr_geom->group_order_.append(state_group_name);
+        }
+      }
+    }
+    /* Smoothing groups. */
+    else if (parse_keyword(p, end, "s")) {
+      geom_update_smooth_group(p, end, state_shaded_smooth);
+    }
+    /* Materials and their libraries. */
+    else if (parse_keyword(p, end, "usemtl")) {
+      state_material_name = StringRef(p, end).trim();
+      int new_mat_index = curr_geom->material_indices_.size();
+      state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
+                                                                        new_mat_index);
+      if (new_mat_index == state_material_index) {
+        curr_geom->material_order_.append(state_material_name);
+      }
+    }
+    else if (parse_keyword(p, end, "mtllib")) {
+      add_mtl_library(StringRef(p, end).trim());
+    }
+    else if (parse_keyword(p, end, "#MRGB")) {
+      geom_add_mrgb_colors(p, end, r_global_vertices);
+    }
+    /* Comments. */
+    else if (*p == '#') {
+      /* Nothing to do. */
+    }
+    /* Curve related things. */
+    else if (parse_keyword(p, end, "cstype")) {
+      curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
+    }
+    else if (parse_keyword(p, end, "deg")) {
+      geom_set_curve_degree(curr_geom, p, end);
+    }
+    else if (parse_keyword(p, end, "curv")) {
+      geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+    }
+    else if (parse_keyword(p, end, "parm")) {
+      geom_add_curve_parameters(curr_geom, p, end);
+    }
+    else if (StringRef(p, end).startswith("end")) {
+      /* End of curve definition, nothing else to do. */
+    }
+    else {
+      CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", std::string(p, end).c_str());
+    }
+  };
+
+  auto add_face = [&](const Span<ChunkFaceCorner> corners) {
+    /* If we don't have a material index assigned yet, get one.
+     * It means "usemtl" state came from the previous object. */
+    if (state_material_index == -1 && !state_material_name.empty() &&
+        curr_geom->material_indices_.is_empty())
+    {
+      curr_geom->material_indices_.add_new(state_material_name, 0);
+      curr_geom->material_order_.append(state_material_name);
+      state_material_index = 0;
+    }
+
+    geom_add_polygon(curr_geom,
+                     corners,
+                     r_global_vertices,
+                     state_material_index,
+                     state_group_index,
+                     state_shaded_smooth);
+  };
+
   /* Read the input file in chunks. We need up to twice the possible chunk size,
    * to possibly store remainder of the previous input line that got broken mid-chunk. */
   Array<char> buffer(read_buffer_size_ * 2);
@@ -555,128 +856,39 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
     }
     ++last_nl;
 
-    /* Parse the buffer (until last newline) that we have so far,
-     * line by line. */
+    /* Parse the buffer (until last newline) that we have so far: first the vertex data and faces
+     * of multiple chunks in parallel, then everything in order. */
     StringRef buffer_str{buffer.data(), int64_t(last_nl)};
-    while (!buffer_str.is_empty()) {
-      StringRef line = read_next_line(buffer_str);
-      const char *p = line.begin(), *end = line.end();
-      p = drop_whitespace(p, end);
-      ++line_number;
-      if (p == end) {
-        continue;
-      }
-      /* Most common things that start with 'v': vertices, normals, UVs. */
-      if (*p == 'v') {
-        if (parse_keyword(p, end, "v")) {
-          geom_add_vertex(p, end, r_global_vertices);
-        }
-        else if (parse_keyword(p, end, "vn")) {
-          geom_add_vertex_normal(p, end, r_global_vertices);
-        }
-        else if (parse_keyword(p, end, "vt")) {
-          geom_add_uv_vertex(p, end, r_global_vertices);
-        }
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "f")) {
-        /* If we don't have a material index assigned yet, get one.
-         * It means "usemtl" state came from the previous object. */
-        if (state_material_index == -1 && !state_material_name.empty() &&
-            curr_geom->material_indices_.is_empty())
-        {
-          curr_geom->material_indices_.add_new(state_material_name, 0);
-          curr_geom->material_order_.append(state_material_name);
-          state_material_index = 0;
-        }
-
-        geom_add_polygon(curr_geom,
-                         p,
-                         end,
-                         r_global_vertices,
-                         state_material_index,
-                         state_group_index,
-                         state_shaded_smooth);
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "l")) {
-        geom_add_polyline(curr_geom, p, end, r_global_vertices);
-      }
-      /* Objects. */
-      else if (parse_keyword(p, end, "o")) {
-        if (import_params_.use_split_objects) {
-          geom_new_object(p,
-                          end,
-                          state_shaded_smooth,
-                          state_group_name,
-                          state_material_index,
-                          curr_geom,
-                          r_all_geometries);
-        }
+    Vector<ObjChunk> chunks = split_chunks(buffer_str, OBJ_PARSE_CHUNKS_PER_BUFFER);
+    threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        parse_chunk(chunks[i]);
       }
-      /* Groups. */
-      else if (parse_keyword(p, end, "g")) {
-        if (import_params_.use_split_groups) {
-          geom_new_object(p,
-                          end,
-                          state_shaded_smooth,
-                          state_group_name,
-                          state_material_index,
-                          curr_geom,
-                          r_all_geometries);
+    });
+
+    for (const ObjChunk &chunk : chunks) {
+      ChunkMergeState merged;
+      for (const ChunkElement &element : chunk.elements) {
+        merge_chunk_vertices(chunk,
+                             element.vertices_num,
+                             element.uv_vertices_num,
+                             element.vert_normals_num,
+                             merged,
+                             r_global_vertices);
+        if (element.line.is_empty()) {
+          add_face(chunk.face_corners.as_span().slice(element.corner_start, element.corner_count));
         }
         else {
-          geom_update_group(StringRef(p, end).trim(), state_group_name);
-          int new_index = curr_geom->group_indices_.size();
-          state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-          if (new_index == state_group_index) {
-            curr_geom->group_order_.append(state_group_name);
-          }
-        }
-      }
-      /* Smoothing groups. */
-      else if (parse_keyword(p, end, "s")) {
-        geom_update_smooth_group(p, end, state_shaded_smooth);
-      }
-      /* Materials and their libraries. */
-      else if (parse_keyword(p, end, "usemtl")) {
-        state_material_name = StringRef(p, end).trim();
-        int new_mat_index = curr_geom->material_indices_.size();
-        state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                          new_mat_index);
-        if (new_mat_index == state_material_index) {
-          curr_geom->material_order_.append(state_material_name);
+          parse_line(element.line.begin(), element.line.end());
         }
       }
-      else if (parse_keyword(p, end, "mtllib")) {
-        add_mtl_library(StringRef(p, end).trim());
-      }
-      else if (parse_keyword(p, end, "#MRGB")) {
-        geom_add_mrgb_colors(p, end, r_global_vertices);
-      }
-      /* Comments. */
-      else if (*p == '#') {
-        /* Nothing to do. */
-      }
-      /* Curve related things. */
-      else if (parse_keyword(p, end, "cstype")) {
-        curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
-      }
-      else if (parse_keyword(p, end, "deg")) {
-        geom_set_curve_degree(curr_geom, p, end);
-      }
-      else if (parse_keyword(p, end, "curv")) {
-        geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
-      }
-      else if (parse_keyword(p, end, "parm")) {
-        geom_add_curve_parameters(curr_geom, p, end);
-      }
-      else if (StringRef(p, end).startswith("end")) {
-        /* End of curve definition, nothing else to do. */
-      }
-      else {
-        CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", std::string(p, end).c_str());
-      }
+      merge_chunk_vertices(chunk,
+                           int(chunk.vertices.size()),
+                           int(chunk.uv_vertices.size()),
+                           int(chunk.vert_normals.size()),
+                           merged,
+                           r_global_vertices);
+      line_number += chunk.lines_num;
     }
 
     /* We might have a line that was cut in the middle by the previous buffer;
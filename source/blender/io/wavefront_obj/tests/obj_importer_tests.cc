@@ -6,6 +6,11 @@
 
 #include "testing/testing.h"
 
+#include "BKE_appdir.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_path_utils.hh"
 #include "BLI_string.h"
 
 #include "CLG_log.h"
@@ -15,7 +20,7 @@
 namespace blender::io::obj {
 
 /* Extensive tests for OBJ importing are in `io_obj_import_test.py`.
- * The tests here are only for testing OBJ reader buffer refill behavior,
+ * The tests here are only for testing OBJ reader buffer refill and chunked parsing behavior,
  * by using a very small buffer size on purpose. */
 
 TEST(obj_import, BufferRefillTest)
@@ -45,4 +50,102 @@ TEST(obj_import, BufferRefillTest)
   CLG_exit();
 }
 
+/* Vertex data interleaved with faces using relative indices, and state changes between faces,
+ * which all depend on the order in which the chunks of the file are merged. */
+static const char *chunks_test_obj =
+    "o First\n"
+    "v 0 0 0\n"
+    "v 1 0 0\n"
+    "v 1 1 0\n"
+    "v 0 1 0\n"
+    "vt 0 0\n"
+    "vt 1 0\n"
+    "vt 1 1\n"
+    "vn 0 0 1\n"
+    "s 1\n"
+    "f 1/1/1 2/2/1 3/3/1\n"
+    "f -4/-3/-1 -2/-1/-1 -1/-1/-1\n"
+    "o Second\n"
+    "v 0 0 1\n"
+    "v 1 0 1\n"
+    "v 1 1 1\n"
+    "s off\n"
+    "f -3 -2 -1\n"
+    "usemtl Material\n"
+    "f 5 7 4\n"
+    "l 5 6\n";
+
+static void parse_obj_text(const char *text,
+                           const size_t read_buffer_size,
+                           Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                           GlobalVertices &r_global_vertices)
+{
+  char obj_path[FILE_MAX];
+  BLI_path_join(obj_path, sizeof(obj_path), BKE_tempdir_base(), "obj_chunks_test.obj");
+  FILE *file = BLI_fopen(obj_path, "wb");
+  ASSERT_NE(file, nullptr);
+  fputs(text, file);
+  fclose(file);
+
+  OBJImportParams params;
+  STRNCPY(params.filepath, obj_path);
+  OBJParser obj_parser{params, read_buffer_size};
+  obj_parser.parse(r_all_geometries, r_global_vertices);
+  BLI_delete(obj_path, false, false);
+}
+
+static void expect_face(const Geometry &geometry,
+                        const int face_index,
+                        const Span<int3> corners,
+                        const bool shaded_smooth,
+                        const int material_index)
+{
+  const FaceElem &face = geometry.face_elements_[face_index];
+  EXPECT_EQ(face.shaded_smooth, shaded_smooth);
+  EXPECT_EQ(face.material_index, material_index);
+  ASSERT_EQ(face.corner_count_, corners.size());
+  for (const int i : corners.index_range()) {
+    const FaceCorner &corner = geometry.face_corners_[face.start_index_ + i];
+    EXPECT_EQ(int3(corner.vert_index, corner.uv_vert_index, corner.vertex_normal_index),
+              corners[i]);
+  }
+}
+
+TEST(obj_import, ChunkedParsingTest)
+{
+  CLG_init();
+  BKE_tempdir_init(nullptr);
+
+  /* The file is small enough for every line to be parsed in its own chunk. The small buffer is
+   * refilled many times, the large one contains the whole file. */
+  for (const size_t read_buffer_size : {size_t(64), size_t(64 * 1024)}) {
+    SCOPED_TRACE(read_buffer_size);
+    Vector<std::unique_ptr<Geometry>> all_geometries;
+    GlobalVertices global_vertices;
+    parse_obj_text(chunks_test_obj, read_buffer_size, all_geometries, global_vertices);
+
+    EXPECT_EQ(global_vertices.vertices.size(), 7);
+    EXPECT_EQ(global_vertices.uv_vertices.size(), 3);
+    EXPECT_EQ(global_vertices.vert_normals.size(), 1);
+    EXPECT_EQ(global_vertices.vertices[4], float3(0.0f, 0.0f, 1.0f));
+
+    ASSERT_EQ(all_geometries.size(), 2);
+    const Geometry &first = *all_geometries[0];
+    EXPECT_EQ(first.geometry_name_, "First");
+    ASSERT_EQ(first.face_elements_.size(), 2);
+    expect_face(first, 0, {int3(0, 0, 0), int3(1, 1, 0), int3(2, 2, 0)}, true, -1);
+    expect_face(first, 1, {int3(0, 0, 0), int3(2, 2, 0), int3(3, 2, 0)}, true, -1);
+
+    const Geometry &second = *all_geometries[1];
+    EXPECT_EQ(second.geometry_name_, "Second");
+    ASSERT_EQ(second.face_elements_.size(), 2);
+    expect_face(second, 0, {int3(4, -1, -1), int3(5, -1, -1), int3(6, -1, -1)}, false, -1);
+    expect_face(second, 1, {int3(4, -1, -1), int3(6, -1, -1), int3(3, -1, -1)}, false, 0);
+    ASSERT_EQ(second.edges_.size(), 1);
+    EXPECT_EQ(second.edges_[0], int2(4, 5));
+  }
+
+  CLG_exit();
+}
+
 }  // namespace blender::io::obj
@@ -108,7 +108,10 @@ typedef struct CacheFile {
   /** Index of the currently selected layer in the UI, starts at 1. */
   int active_layer;
 
-  char _pad2[3];
+  /** Number of frames the Cycles Procedural keeps in memory while streaming the next ones, zero
+   * to load the entire animation. */
+  short prefetch_window;
+  char _pad2[1];
 
   char velocity_unit;
   /* Name of the velocity property in the archive. */
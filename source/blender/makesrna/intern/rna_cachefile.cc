@@ -308,6 +308,16 @@ static void rna_def_cachefile(BlenderRNA *brna)
       "fit within the limit, rendering is aborted");
   RNA_def_property_update(prop, 0, "rna_CacheFile_update");
 
+  prop = RNA_def_property(srna, "prefetch_window", PROP_INT, PROP_UNSIGNED);
+  RNA_def_property_range(prop, 0, SHRT_MAX);
+  RNA_def_property_ui_range(prop, 0, 1000, 1, -1);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Window",
+                           "Number of frames the Cycles Procedural keeps in memory, while the "
+                           "next frames are read in the background during rendering. When zero, "
+                           "the entire animation is loaded at once");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
   /* ----------------- Axis Conversion ----------------- */
 
   prop = RNA_def_property(srna, "forward_axis", PROP_ENUM, PROP_NONE);
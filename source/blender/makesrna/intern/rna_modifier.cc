@@ -3522,6 +3522,11 @@ static void rna_def_modifier_boolean(BlenderRNA *brna)
        0,
        "Exact",
        "Advanced solver for the best result"},
+      {eBooleanModifierSolver_Manifold,
+       "MANIFOLD",
+       0,
+       "Manifold",
+       "Fast solver for overlapping geometry, requires closed manifold inputs"},
       {0, nullptr, 0, nullptr, nullptr},
   };
 
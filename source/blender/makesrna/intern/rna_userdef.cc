@@ -6201,6 +6201,14 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "use_volume_delay_load", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", USER_VOLUME_DELAY_LOAD);
+  RNA_def_property_ui_text(prop,
+                           "Delay Load Volume Files",
+                           "Memory map OpenVDB files and only read the voxel data that is "
+                           "accessed. Faster for large files on local disks, but can be slow on "
+                           "network drives");
+
   /* Sequencer disk cache */
 
   prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
@@ -7574,6 +7582,15 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "use_sculpt_texture_paint", 1);
   RNA_def_property_ui_text(prop, "Sculpt Texture Paint", "Use texture painting in Sculpt Mode");
 
+  prop = RNA_def_property(srna, "use_delta_blend_save", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_delta_blend_save", 1);
+  RNA_def_property_ui_text(prop,
+                           "Delta Blend File Save",
+                           "When saving an uncompressed file again in the same session, only "
+                           "append the changed data to it. Not used when saving versions. Older "
+                           "Blender versions read such files as they were when first saved, use "
+                           "the \"compact_blend\" command to turn them into regular files");
+
   prop = RNA_def_property(srna, "use_extended_asset_browser", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(prop,
                            "Extended Asset Browser",
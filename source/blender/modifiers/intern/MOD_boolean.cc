@@ -81,8 +81,8 @@ static bool is_disabled(const Scene * /*scene*/, ModifierData *md, bool /*use_re
     return !bmd->object || bmd->object->type != OB_MESH;
   }
   if (bmd->flag & eBooleanModifierFlag_Collection) {
-    /* The Exact solver tolerates an empty collection. */
-    return !col && bmd->solver != eBooleanModifierSolver_Mesh_Arr;
+    /* The Exact and Manifold solvers tolerate an empty collection. */
+    return !col && bmd->solver == eBooleanModifierSolver_Float;
   }
   return false;
 }
@@ -174,12 +174,12 @@ static bool BMD_error_messages(const Object *ob, ModifierData *md)
   bool error_returns_result = false;
 
   const bool operand_collection = (bmd->flag & eBooleanModifierFlag_Collection) != 0;
-  const bool use_exact = bmd->solver == eBooleanModifierSolver_Mesh_Arr;
+  const bool use_exact = bmd->solver != eBooleanModifierSolver_Float;
   const bool operation_intersect = bmd->operation == eBooleanModifierOp_Intersect;
 
 #ifndef WITH_GMP
   /* If compiled without GMP, return a error. */
-  if (use_exact) {
+  if (bmd->solver == eBooleanModifierSolver_Mesh_Arr) {
     BKE_modifier_set_error(ob, md, "Compiled without GMP, using fast solver");
     error_returns_result = false;
   }
@@ -367,8 +367,6 @@ static void BMD_mesh_intersection(BMesh *bm,
                     bmd->double_threshold);
 }
 
-#ifdef WITH_GMP
-
 /* Get a mapping from material slot numbers in the src_ob to slot numbers in the dst_ob.
  * If a material doesn't exist in the dst_ob, the mapping just goes to the same slot
  * or to zero if there aren't enough slots in the destination. */
@@ -398,18 +396,19 @@ static Array<short> get_material_remap_transfer(Object &object,
   return map;
 }
 
-static Mesh *exact_boolean_mesh(BooleanModifierData *bmd,
-                                const ModifierEvalContext *ctx,
-                                Mesh *mesh)
+static Mesh *mesh_boolean_with_solver(BooleanModifierData *bmd,
+                                      const ModifierEvalContext *ctx,
+                                      Mesh *mesh,
+                                      const blender::geometry::boolean::Solver solver)
 {
   Vector<const Mesh *> meshes;
   Vector<float4x4> obmats;
 
   Vector<Array<short>> material_remaps;
 
-#  ifdef DEBUG_TIME
+#ifdef DEBUG_TIME
   SCOPED_TIMER(__func__);
-#  endif
+#endif
 
   if ((bmd->flag & eBooleanModifierFlag_Object) && bmd->object == nullptr) {
     return mesh;
@@ -479,14 +478,21 @@ static Mesh *exact_boolean_mesh(BooleanModifierData *bmd,
   op_params.no_self_intersections = !use_self;
   op_params.watertight = !hole_tolerant;
   op_params.no_nested_components = false;
-  Mesh *result = blender::geometry::boolean::mesh_boolean(
-      meshes,
-      obmats,
-      ctx->object->object_to_world(),
-      material_remaps,
-      op_params,
-      blender::geometry::boolean::Solver::MeshArr,
-      nullptr);
+  blender::geometry::boolean::BooleanError error;
+  Mesh *result = blender::geometry::boolean::mesh_boolean(meshes,
+                                                          obmats,
+                                                          ctx->object->object_to_world(),
+                                                          material_remaps,
+                                                          op_params,
+                                                          solver,
+                                                          nullptr,
+                                                          &error);
+  if (result == nullptr) {
+    if (error == blender::geometry::boolean::BooleanError::NonManifold) {
+      BKE_modifier_set_error(ctx->object, &bmd->modifier, "Cannot execute, non-manifold inputs");
+    }
+    return mesh;
+  }
 
   if (material_mode == eBooleanModifierMaterialMode_Transfer) {
     MEM_SAFE_FREE(result->mat);
@@ -499,7 +505,6 @@ static Mesh *exact_boolean_mesh(BooleanModifierData *bmd,
 
   return result;
 }
-#endif
 
 static Mesh *modify_mesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
 {
@@ -513,9 +518,12 @@ static Mesh *modify_mesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh
     return result;
   }
 
+  if (bmd->solver == eBooleanModifierSolver_Manifold) {
+    return mesh_boolean_with_solver(bmd, ctx, mesh, blender::geometry::boolean::Solver::Manifold);
+  }
 #ifdef WITH_GMP
   if (bmd->solver == eBooleanModifierSolver_Mesh_Arr) {
-    return exact_boolean_mesh(bmd, ctx, mesh);
+    return mesh_boolean_with_solver(bmd, ctx, mesh, blender::geometry::boolean::Solver::MeshArr);
   }
 #endif
 
@@ -632,12 +640,15 @@ static void solver_options_panel_draw(const bContext * /*C*/, Panel *panel)
   uiLayout *layout = panel->layout;
   PointerRNA *ptr = modifier_panel_get_property_pointers(panel, nullptr);
 
-  const bool use_exact = RNA_enum_get(ptr, "solver") == eBooleanModifierSolver_Mesh_Arr;
+  const int solver = RNA_enum_get(ptr, "solver");
 
   uiLayoutSetPropSep(layout, true);
 
   uiLayout *col = uiLayoutColumn(layout, true);
-  if (use_exact) {
+  if (solver == eBooleanModifierSolver_Manifold) {
+    uiItemR(col, ptr, "material_mode", UI_ITEM_NONE, IFACE_("Materials"), ICON_NONE);
+  }
+  else if (solver == eBooleanModifierSolver_Mesh_Arr) {
     uiItemR(col, ptr, "material_mode", UI_ITEM_NONE, IFACE_("Materials"), ICON_NONE);
     /* When operand is collection, we always use_self. */
     if (RNA_enum_get(ptr, "operand_type") == eBooleanModifierFlag_Object) {
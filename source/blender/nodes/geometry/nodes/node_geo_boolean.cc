@@ -57,7 +57,8 @@ static void node_declare(NodeDeclarationBuilder &b)
     const auto operation = geometry::boolean::Operation(node->custom1);
     const auto solver = geometry::boolean::Solver(node->custom2);
 
-    output_edges.available(solver == geometry::boolean::Solver::MeshArr);
+    output_edges.available(ELEM(
+        solver, geometry::boolean::Solver::MeshArr, geometry::boolean::Solver::Manifold));
 
     switch (operation) {
       case geometry::boolean::Operation::Intersect:
@@ -86,7 +87,6 @@ static void node_init(bNodeTree * /*tree*/, bNode *node)
   node->custom2 = int16_t(geometry::boolean::Solver::Float);
 }
 
-#ifdef WITH_GMP
 static Array<short> calc_mesh_material_map(const Mesh &mesh, VectorSet<Material *> &all_materials)
 {
   Array<short> map(mesh.totcol);
@@ -96,11 +96,9 @@ static Array<short> calc_mesh_material_map(const Mesh &mesh, VectorSet<Material
   }
   return map;
 }
-#endif /* WITH_GMP */
 
 static void node_geo_exec(GeoNodeExecParams params)
 {
-#ifdef WITH_GMP
   geometry::boolean::Operation operation = geometry::boolean::Operation(params.node().custom1);
   geometry::boolean::Solver solver = geometry::boolean::Solver(params.node().custom2);
   const bool use_self = params.get_input<bool>("Self Intersection");
@@ -173,7 +171,7 @@ static void node_geo_exec(GeoNodeExecParams params)
   }
 
   AttributeOutputs attribute_outputs;
-  if (solver == geometry::boolean::Solver::MeshArr) {
+  if (ELEM(solver, geometry::boolean::Solver::MeshArr, geometry::boolean::Solver::Manifold)) {
     attribute_outputs.intersecting_edges_id = params.get_output_anonymous_attribute_id_if_needed(
         "Intersecting Edges");
   }
@@ -184,6 +182,7 @@ static void node_geo_exec(GeoNodeExecParams params)
   op_params.no_self_intersections = !use_self;
   op_params.watertight = !hole_tolerant;
   op_params.no_nested_components = true; /* TODO: make this configurable. */
+  geometry::boolean::BooleanError error;
   Mesh *result = geometry::boolean::mesh_boolean(
       meshes,
       transforms,
@@ -191,8 +190,21 @@ static void node_geo_exec(GeoNodeExecParams params)
       material_remaps,
       op_params,
       solver,
-      attribute_outputs.intersecting_edges_id ? &intersecting_edges : nullptr);
+      attribute_outputs.intersecting_edges_id ? &intersecting_edges : nullptr,
+      &error);
   if (!result) {
+    switch (error) {
+      case geometry::boolean::BooleanError::NoError:
+        break;
+      case geometry::boolean::BooleanError::NonManifold:
+        params.error_message_add(NodeWarningType::Error,
+                                 TIP_("Manifold solver requires closed manifold input meshes"));
+        break;
+      case geometry::boolean::BooleanError::SolverNotAvailable:
+        params.error_message_add(NodeWarningType::Error,
+                                 TIP_("Disabled, Blender was compiled without GMP"));
+        break;
+    }
     params.set_default_remaining_outputs();
     return;
   }
@@ -228,11 +240,6 @@ static void node_geo_exec(GeoNodeExecParams params)
   result_geometry.name = set_a.name;
 
   params.set_output("Mesh", std::move(result_geometry));
-#else
-  params.error_message_add(NodeWarningType::Error,
-                           TIP_("Disabled, Blender was compiled without GMP"));
-  params.set_default_remaining_outputs();
-#endif
 }
 
 static void node_rna(StructRNA *srna)
@@ -266,6 +273,11 @@ static void node_rna(StructRNA *srna)
        0,
        "Float",
        "Simple solver for the best performance, without support for overlapping geometry"},
+      {int(geometry::boolean::Solver::Manifold),
+       "MANIFOLD",
+       0,
+       "Manifold",
+       "Fast solver for overlapping geometry, requires closed manifold inputs"},
       {0, nullptr, 0, nullptr, nullptr},
   };
 
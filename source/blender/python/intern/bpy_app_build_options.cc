@@ -10,6 +10,8 @@
 
 #include "BLI_utildefines.h"
 
+#include "BKE_volume.hh"
+
 #include "bpy_app_build_options.hh"
 
 static PyTypeObject BlenderAppBuildOptionsType;
@@ -51,6 +53,7 @@ static PyStructSequence_Field app_builtopts_info_fields[] = {
     {"opencolorio", nullptr},
     {"openmp", nullptr},
     {"openvdb", nullptr},
+    {"openvdb_delayed_loading", nullptr},
     {"alembic", nullptr},
     {"usd", nullptr},
     {"fluid", nullptr},
@@ -277,6 +280,9 @@ static PyObject *make_builtopts_info()
   SetObjIncref(Py_False);
 #endif
 
+  /* Depends on how the OpenVDB library was built. */
+  SetObjIncref(BKE_volume_delay_load_supported() ? Py_True : Py_False);
+
 #ifdef WITH_ALEMBIC
   SetObjIncref(Py_True);
 #else
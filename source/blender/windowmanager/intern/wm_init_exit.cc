@@ -209,6 +209,7 @@ void WM_init(bContext *C, int argc, const char **argv)
   BKE_keyconfig_pref_type_init();
 
   wm_operatortypes_register();
+  BLO_write_file_compact_command_register();
 
   WM_paneltype_init(); /* Lookup table only. */
   WM_menutype_init();
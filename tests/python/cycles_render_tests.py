@@ -130,7 +130,7 @@ BLOCKLIST_GPU = [
 
 
 class CyclesReport(render_report.Report):
-    def __init__(self, title, output_dir, oiiotool, device=None, blocklist=[], osl=False):
+    def __init__(self, title, output_dir, oiiotool, device=None, blocklist=[], osl=False, wavefront=False):
         # Split device name in format "<device_type>[-<RT>]" into individual
         # tokens, setting the RT suffix to an empty string if its not specified.
         self.device, suffix = (device.split("-") + [""])[:2]
@@ -142,6 +142,8 @@ class CyclesReport(render_report.Report):
             variation += ' ' + suffix
         if self.osl:
             variation += ' OSL'
+        if wavefront:
+            variation += ' Wavefront'
 
         super().__init__(title, output_dir, oiiotool, variation, blocklist)
 
@@ -214,6 +216,7 @@ def create_argparse():
     parser.add_argument("--device", required=True)
     parser.add_argument("--blocklist", nargs="*", default=[])
     parser.add_argument("--osl", default=False, action='store_true')
+    parser.add_argument("--wavefront", default=False, action='store_true')
     parser.add_argument('--batch', default=False, action='store_true')
     return parser
 
@@ -238,10 +241,15 @@ def main():
     if args.osl:
         blocklist += BLOCKLIST_OSL
 
-    report = CyclesReport('Cycles', args.outdir, args.oiiotool, device, blocklist, args.osl)
+    if args.wavefront:
+        # Render with the wavefront scheduling of paths on the CPU, against the same references as
+        # the regular megakernel.
+        os.environ['CYCLES_CPU_WAVEFRONT'] = '1'
+
+    report = CyclesReport('Cycles', args.outdir, args.oiiotool, device, blocklist, args.osl, args.wavefront)
     report.set_pixelated(True)
     report.set_reference_dir("cycles_renders")
-    if device == 'CPU':
+    if device == 'CPU' and not args.wavefront:
         report.set_compare_engine('eevee')
     else:
         report.set_compare_engine('cycles', 'CPU')